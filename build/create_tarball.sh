@@ -155,6 +155,8 @@ ln -s ../../src/MEGAShellExtNautilus/mega_ext_client.h $EXT_NAME/mega_ext_client
 ln -s ../../src/MEGAShellExtNautilus/mega_ext_module.c $EXT_NAME/mega_ext_module.c
 ln -s ../../src/MEGAShellExtNautilus/mega_notify_client.h $EXT_NAME/mega_notify_client.h
 ln -s ../../src/MEGAShellExtNautilus/mega_notify_client.c $EXT_NAME/mega_notify_client.c
+ln -s ../../src/MEGAShellExtNautilus/mega_state_cache.h $EXT_NAME/mega_state_cache.h
+ln -s ../../src/MEGAShellExtNautilus/mega_state_cache.c $EXT_NAME/mega_state_cache.c
 ln -s ../../src/MEGAShellExtNautilus/MEGAShellExt.c $EXT_NAME/MEGAShellExt.c
 ln -s ../../src/MEGAShellExtNautilus/MEGAShellExt.h $EXT_NAME/MEGAShellExt.h
 ln -s ../../src/MEGAShellExtNautilus/CMakeLists.txt $EXT_NAME/CMakeLists.txt
@@ -216,6 +218,8 @@ ln -s ../../src/MEGAShellExtNemo/mega_ext_client.h $EXT_NAME/mega_ext_client.h
 ln -s ../../src/MEGAShellExtNemo/mega_ext_module.c $EXT_NAME/mega_ext_module.c
 ln -s ../../src/MEGAShellExtNemo/mega_notify_client.h $EXT_NAME/mega_notify_client.h
 ln -s ../../src/MEGAShellExtNemo/mega_notify_client.c $EXT_NAME/mega_notify_client.c
+ln -s ../../src/MEGAShellExtNemo/mega_state_cache.h $EXT_NAME/mega_state_cache.h
+ln -s ../../src/MEGAShellExtNemo/mega_state_cache.c $EXT_NAME/mega_state_cache.c
 ln -s ../../src/MEGAShellExtNemo/MEGAShellExt.c $EXT_NAME/MEGAShellExt.c
 ln -s ../../src/MEGAShellExtNemo/MEGAShellExt.h $EXT_NAME/MEGAShellExt.h
 ln -s ../../src/MEGAShellExtNemo/CMakeLists.txt $EXT_NAME/CMakeLists.txt
@@ -0,0 +1,152 @@
+#include "ChunkedLogArchive.h"
+
+#include <catch.hpp>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <zlib.h>
+
+namespace
+{
+// One line per second, from 01/01-00:00:00 of the reference year
+QByteArray createLog(int lines)
+{
+    QByteArray log;
+    for (int line = 0; line < lines; ++line)
+    {
+        auto time(QTime(0, 0).addSecs(line));
+        log.append(QString::fromLatin1("01/01-%1.000000 7f00 DBG  Log line number %2\n")
+                       .arg(time.toString(QString::fromLatin1("hh:mm:ss")))
+                       .arg(line)
+                       .toLatin1());
+    }
+    return log;
+}
+
+QByteArray decompress(const QString& path)
+{
+    QByteArray data;
+    auto file(gzopen(path.toUtf8().constData(), "rb"));
+    if (!file)
+    {
+        return data;
+    }
+
+    char buffer[16384];
+    int read(0);
+    while ((read = gzread(file, buffer, sizeof(buffer))) > 0)
+    {
+        data.append(buffer, read);
+    }
+    gzclose(file);
+    return data;
+}
+
+qint64 timeOfLine(int line)
+{
+    auto year(QDateTime::currentDateTimeUtc().date().year());
+    return QDateTime(QDate(year, 1, 1), QTime(0, 0), Qt::UTC).addSecs(line).toMSecsSinceEpoch();
+}
+}
+
+TEST_CASE("ChunkedLogArchive", "[ChunkedLogArchive]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    auto logPath(dir.filePath(QString::fromLatin1("MEGAsync.log")));
+    auto archivePath(dir.filePath(QString::fromLatin1("MEGAsync.0.log")));
+
+    // About 2 MB, so there are several chunks
+    const int lines(40000);
+    auto log(createLog(lines));
+    QFile logFile(logPath);
+    REQUIRE(logFile.open(QIODevice::WriteOnly));
+    logFile.write(log);
+    logFile.close();
+
+    REQUIRE(ChunkedLogArchive::compress(logPath, archivePath));
+
+    SECTION("The archive is a regular gzip file")
+    {
+        REQUIRE(decompress(archivePath) == log);
+    }
+
+    SECTION("The index covers the whole log in time order")
+    {
+        QVector<ChunkedLogArchive::Chunk> chunks;
+        REQUIRE(ChunkedLogArchive::readIndex(archivePath, chunks));
+        REQUIRE(chunks.size() > 1);
+        REQUIRE(chunks.first().firstTime == timeOfLine(0));
+        REQUIRE(chunks.last().lastTime == timeOfLine(lines - 1));
+
+        qint64 size(0);
+        for (int index = 0; index < chunks.size(); ++index)
+        {
+            REQUIRE(chunks[index].size <= ChunkedLogArchive::CHUNK_SIZE);
+            REQUIRE(chunks[index].firstTime <= chunks[index].lastTime);
+            if (index > 0)
+            {
+                REQUIRE(chunks[index].firstTime > chunks[index - 1].lastTime);
+                REQUIRE(chunks[index].offset == chunks[index - 1].offset + chunks[index - 1].compressedSize);
+            }
+            size += chunks[index].size;
+        }
+        REQUIRE(size == log.size());
+    }
+
+    SECTION("A time window is copied without the older chunks")
+    {
+        QVector<ChunkedLogArchive::Chunk> chunks;
+        REQUIRE(ChunkedLogArchive::readIndex(archivePath, chunks));
+
+        auto since(QDateTime::fromMSecsSinceEpoch(timeOfLine(lines - 100), Qt::UTC));
+        auto selected(ChunkedLogArchive::chunksSince(chunks, since));
+        REQUIRE(!selected.isEmpty());
+        REQUIRE(selected.size() < chunks.size());
+        REQUIRE(selected.first().lastTime >= since.toMSecsSinceEpoch());
+        REQUIRE(selected.last().lastTime == chunks.last().lastTime);
+        qint64 selectedSize(0);
+        for (const auto& chunk : selected)
+        {
+            selectedSize += chunk.size;
+        }
+
+        auto windowPath(dir.filePath(QString::fromLatin1("window.gz")));
+        auto out(fopen(windowPath.toUtf8().constData(), "wb"));
+        REQUIRE(out);
+        fwrite("\x1f\x8b\x08\0\0\0\0\0\0\xff", 1, 10, out);
+        unsigned long crc(crc32(0L, Z_NULL, 0));
+        unsigned long tot(0);
+        REQUIRE(ChunkedLogArchive::copyChunks(archivePath, selected, out, &crc, &tot));
+        ChunkedLogArchive::finish(out, crc, tot);
+        fclose(out);
+
+        auto window(decompress(windowPath));
+        REQUIRE(static_cast<qint64>(window.size()) == selectedSize);
+        REQUIRE(log.endsWith(window));
+        REQUIRE(window.contains(QString::fromLatin1("Log line number %1\n").arg(lines - 100).toLatin1()));
+    }
+
+    SECTION("Logs without index are not chunked")
+    {
+        QFile::remove(ChunkedLogArchive::indexPath(archivePath));
+        QVector<ChunkedLogArchive::Chunk> chunks;
+        REQUIRE_FALSE(ChunkedLogArchive::readIndex(archivePath, chunks));
+        REQUIRE(chunks.isEmpty());
+    }
+}
+
+TEST_CASE("ChunkedLogArchive line time", "[ChunkedLogArchive]")
+{
+    auto reference(QDateTime(QDate(2024, 3, 10), QTime(12, 0), Qt::UTC));
+
+    REQUIRE(ChunkedLogArchive::lineTime("03/10-11:59:58.500000 ", 22, reference) ==
+            QDateTime(QDate(2024, 3, 10), QTime(11, 59, 58, 500), Qt::UTC).toMSecsSinceEpoch());
+
+    // Lines from December are from the previous year
+    REQUIRE(ChunkedLogArchive::lineTime("12/31-23:00:00.000000 ", 22, reference) ==
+            QDateTime(QDate(2023, 12, 31), QTime(23, 0), Qt::UTC).toMSecsSinceEpoch());
+
+    REQUIRE(ChunkedLogArchive::lineTime("[repeated x3]", 13, reference) == -1);
+    REQUIRE(ChunkedLogArchive::lineTime("03/10-11:59", 11, reference) == -1);
+}
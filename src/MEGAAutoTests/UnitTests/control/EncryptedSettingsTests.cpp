@@ -0,0 +1,120 @@
+#include "EncryptedSettings.h"
+
+#include <catch.hpp>
+#include <QTemporaryDir>
+
+namespace
+{
+// Reads like EncryptedSettings did before the cache, to compare both paths
+class UncachedEncryptedSettings: public EncryptedSettings
+{
+public:
+    using EncryptedSettings::EncryptedSettings;
+
+    QVariant uncachedValue(const QString& key, const QVariant& defaultValue = QVariant())
+    {
+        return QVariant(
+            decrypt(key, QSettings::value(hash(key), encrypt(key, defaultValue.toString())).toString()));
+    }
+};
+
+const QString KEY(QString::fromLatin1("key"));
+const QString GROUP(QString::fromLatin1("group"));
+}
+
+TEST_CASE("EncryptedSettings", "[EncryptedSettings]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    auto file(dir.filePath(QString::fromLatin1("MEGAsync.cfg")));
+    UncachedEncryptedSettings settings(file);
+
+    SECTION("Missing values return the default value")
+    {
+        REQUIRE(settings.value(KEY, 42).toInt() == 42);
+        REQUIRE(settings.value(KEY).toString().isEmpty());
+        settings.setValue(KEY, 7);
+        REQUIRE(settings.value(KEY, 42).toInt() == 7);
+    }
+
+    SECTION("Written values are read back and persisted")
+    {
+        settings.setValue(KEY, QString::fromLatin1("first"));
+        REQUIRE(settings.value(KEY).toString() == QString::fromLatin1("first"));
+        settings.setValue(KEY, QString::fromLatin1("second"));
+        REQUIRE(settings.value(KEY).toString() == QString::fromLatin1("second"));
+        REQUIRE(settings.uncachedValue(KEY).toString() == QString::fromLatin1("second"));
+
+        settings.flushNow();
+        EncryptedSettings reopened(file);
+        REQUIRE(reopened.value(KEY).toString() == QString::fromLatin1("second"));
+    }
+
+    SECTION("Writes are flushed together")
+    {
+        settings.flushNow();
+        auto writes(settings.getWritesRequested());
+        auto flushes(settings.getDiskFlushes());
+        for (int i = 0; i < 10; ++i)
+        {
+            settings.setValue(KEY, i);
+            settings.sync();
+        }
+        REQUIRE(settings.getWritesRequested() == writes + 10);
+        REQUIRE(settings.getDiskFlushes() == flushes);
+
+        settings.flushNow();
+        settings.flushNow();
+        REQUIRE(settings.getDiskFlushes() == flushes + 1);
+    }
+
+    SECTION("Values of different groups are kept apart")
+    {
+        settings.setValue(KEY, 1);
+        settings.beginGroup(GROUP);
+        REQUIRE(settings.value(KEY, 0).toInt() == 0);
+        settings.setValue(KEY, 2);
+        REQUIRE(settings.value(KEY).toInt() == 2);
+        settings.endGroup();
+        REQUIRE(settings.value(KEY).toInt() == 1);
+    }
+
+    SECTION("Removed values are not cached")
+    {
+        settings.setValue(KEY, 1);
+        REQUIRE(settings.value(KEY).toInt() == 1);
+        settings.remove(KEY);
+        REQUIRE(settings.value(KEY, 0).toInt() == 0);
+
+        settings.beginGroup(GROUP);
+        settings.setValue(KEY, 2);
+        REQUIRE(settings.value(KEY).toInt() == 2);
+        settings.remove(QString());
+        REQUIRE(settings.value(KEY, 0).toInt() == 0);
+        settings.endGroup();
+
+        settings.setValue(KEY, 3);
+        settings.clear();
+        REQUIRE(settings.value(KEY, 0).toInt() == 0);
+    }
+}
+
+// Hidden by default, run with "[.benchmark]" or "[EncryptedSettingsBenchmark]"
+TEST_CASE("EncryptedSettings benchmark", "[.benchmark][EncryptedSettingsBenchmark]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    UncachedEncryptedSettings settings(dir.filePath(QString::fromLatin1("MEGAsync.cfg")));
+    settings.beginGroup(GROUP);
+    settings.setValue(KEY, true);
+
+    BENCHMARK("value() without cache")
+    {
+        return settings.uncachedValue(KEY, false).toBool();
+    };
+
+    BENCHMARK("value() with cache")
+    {
+        return settings.value(KEY, false).toBool();
+    };
+}
@@ -0,0 +1,203 @@
+#include "LogRingBuffer.h"
+#include "MegaSyncLogger.h"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+bool write(LogRingBuffer& ring, uint64_t time, const std::string& line)
+{
+    auto out(ring.beginWrite(line.size()));
+    if (!out)
+    {
+        return false;
+    }
+
+    memcpy(out, line.data(), line.size());
+    ring.commitWrite(time, LogRingBuffer::RecordType::LINE, 0, 0);
+    return true;
+}
+
+bool read(LogRingBuffer& ring, uint64_t& time, std::string& line)
+{
+    LogRingBuffer::Record record;
+    if (!ring.front(record))
+    {
+        return false;
+    }
+
+    time = record.time;
+    line.assign(record.data, record.size);
+    ring.pop();
+    return true;
+}
+}
+
+TEST_CASE("LogRingBuffer", "[LogRingBuffer]")
+{
+    SECTION("Capacity is rounded up to a power of two")
+    {
+        LogRingBuffer ring(1000);
+        REQUIRE(ring.capacity() == 1024);
+        REQUIRE(ring.isEmpty());
+    }
+
+    SECTION("Records keep their data and order")
+    {
+        LogRingBuffer ring(1024);
+        REQUIRE(write(ring, 1, "first"));
+        REQUIRE(write(ring, 2, "second line"));
+
+        uint64_t time(0);
+        std::string line;
+        REQUIRE(read(ring, time, line));
+        REQUIRE(time == 1);
+        REQUIRE(line == "first");
+        REQUIRE(read(ring, time, line));
+        REQUIRE(time == 2);
+        REQUIRE(line == "second line");
+        REQUIRE_FALSE(read(ring, time, line));
+        REQUIRE(ring.isEmpty());
+    }
+
+    SECTION("Write fails when full or too big")
+    {
+        LogRingBuffer ring(1024);
+        REQUIRE(ring.beginWrite(ring.maxRecordSize() + 1) == nullptr);
+
+        // 16 bytes of header plus 48 of line
+        std::string line(48, 'x');
+        for (int i = 0; i < 16; ++i)
+        {
+            REQUIRE(write(ring, static_cast<uint64_t>(i), line));
+        }
+        REQUIRE(ring.usedBytes() == ring.capacity());
+        REQUIRE_FALSE(write(ring, 16, line));
+
+        uint64_t time(0);
+        std::string readLine;
+        REQUIRE(read(ring, time, readLine));
+        REQUIRE(write(ring, 16, line));
+    }
+
+    SECTION("Records wrap around the end of the buffer")
+    {
+        LogRingBuffer ring(1024);
+        uint64_t time(0);
+        std::string line;
+
+        // Records of several sizes, so some of them need padding to wrap
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            auto expected(std::string(static_cast<size_t>(i % 150 + 1), static_cast<char>('a' + i % 26)));
+            REQUIRE(write(ring, i, expected));
+            REQUIRE(read(ring, time, line));
+            REQUIRE(time == i);
+            REQUIRE(line == expected);
+        }
+        REQUIRE(ring.isEmpty());
+    }
+
+    SECTION("The consumer reads what the producer writes, in order")
+    {
+        constexpr uint64_t records{100000};
+        LogRingBuffer ring(4096);
+
+        std::thread producer(
+            [&ring]()
+            {
+                for (uint64_t i = 0; i < records; ++i)
+                {
+                    auto value(std::to_string(i));
+                    while (!write(ring, i, value))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+        bool ordered(true);
+        uint64_t received(0);
+        while (received < records)
+        {
+            uint64_t time(0);
+            std::string line;
+            if (read(ring, time, line))
+            {
+                ordered &= time == received && line == std::to_string(received);
+                ++received;
+            }
+        }
+        producer.join();
+
+        REQUIRE(ordered);
+    }
+}
+
+// Hidden by default, run with "[.benchmark]" or "[MegaSyncLoggerBenchmark]"
+// The lines go to the log of the application created by the test runner
+TEST_CASE("MegaSyncLogger benchmark", "[.benchmark][MegaSyncLoggerBenchmark]")
+{
+    REQUIRE(g_megaSyncLogger);
+
+    const auto threads = GENERATE(1, 8, 32);
+    constexpr int linesByThread{1000};
+    const auto suffix(std::string(" - ") + std::to_string(threads) + " threads x " +
+                      std::to_string(linesByThread) + " lines");
+
+    BENCHMARK_ADVANCED("log() latency" + suffix)(Catch::Benchmark::Chronometer meter)
+    {
+        std::atomic<long long> nanoseconds(0);
+        meter.measure(
+            [&]()
+            {
+                std::vector<std::thread> loggers;
+                for (int thread = 0; thread < threads; ++thread)
+                {
+                    loggers.emplace_back(
+                        [&nanoseconds, thread]()
+                        {
+                            auto message(std::string("Benchmark line from thread ") +
+                                         std::to_string(thread) + ": ");
+                            auto start(std::chrono::steady_clock::now());
+                            for (int line = 0; line < linesByThread; ++line)
+                            {
+                                auto text(message + std::to_string(line));
+                                g_megaSyncLogger->log(nullptr,
+                                                      mega::MegaApi::LOG_LEVEL_DEBUG,
+                                                      nullptr,
+                                                      text.c_str()
+#ifdef ENABLE_LOG_PERFORMANCE
+                                                          ,
+                                                      nullptr,
+                                                      nullptr,
+                                                      0
+#endif
+                                );
+                            }
+                            nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               std::chrono::steady_clock::now() - start)
+                                               .count();
+                        });
+                }
+
+                for (auto& logger: loggers)
+                {
+                    logger.join();
+                }
+                return nanoseconds.load();
+            });
+
+        // The measured time includes starting the threads, this one is the mean of the calls
+        WARN("Mean log() call: " << (nanoseconds / (static_cast<long long>(threads) * linesByThread *
+                                                    meter.runs()))
+                                 << " ns");
+    };
+}
@@ -0,0 +1,83 @@
+#include "MpscRingBuffer.h"
+
+#include <catch.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("MpscRingBuffer", "[MpscRingBuffer]")
+{
+    SECTION("Capacity is rounded up to a power of two")
+    {
+        MpscRingBuffer<int> ring(1000);
+        REQUIRE(ring.capacity() == 1024);
+    }
+
+    SECTION("Push fails when full and keeps the item")
+    {
+        MpscRingBuffer<std::vector<int>> ring(2);
+        REQUIRE(ring.tryPush(std::vector<int>{1}));
+        REQUIRE(ring.tryPush(std::vector<int>{2}));
+
+        std::vector<int> rejected{3};
+        REQUIRE_FALSE(ring.tryPush(std::move(rejected)));
+        REQUIRE(rejected == std::vector<int>{3});
+
+        std::vector<int> item;
+        REQUIRE(ring.tryPop(item));
+        REQUIRE(item == std::vector<int>{1});
+        REQUIRE(ring.tryPush(std::move(rejected)));
+        REQUIRE(ring.tryPop(item));
+        REQUIRE(item == std::vector<int>{2});
+        REQUIRE(ring.tryPop(item));
+        REQUIRE(item == std::vector<int>{3});
+        REQUIRE_FALSE(ring.tryPop(item));
+    }
+
+    SECTION("Several producers keep their own order")
+    {
+        constexpr int producers{4};
+        constexpr int itemsByProducer{20000};
+
+        MpscRingBuffer<int> ring(256);
+        std::vector<std::thread> threads;
+        for (int producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back(
+                [&ring, producer]()
+                {
+                    for (int item = 0; item < itemsByProducer; ++item)
+                    {
+                        auto value(producer * itemsByProducer + item);
+                        while (!ring.tryPush(std::move(value)))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+
+        std::vector<int> lastByProducer(producers, -1);
+        bool ordered(true);
+        int received(0);
+        while (received < producers * itemsByProducer)
+        {
+            int value(0);
+            if (ring.tryPop(value))
+            {
+                auto producer(value / itemsByProducer);
+                auto item(value % itemsByProducer);
+                ordered &= item > lastByProducer[producer];
+                lastByProducer[producer] = item;
+                ++received;
+            }
+        }
+
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(ordered);
+    }
+}
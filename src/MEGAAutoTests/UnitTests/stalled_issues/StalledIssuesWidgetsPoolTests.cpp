@@ -0,0 +1,205 @@
+#include "StalledIssuesWidgetsPool.h"
+
+#include <catch.hpp>
+#include <QMap>
+#include <QPair>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// Refers to a widget without owning it and evaluates to false once it is deleted, like QPointer
+struct Widget
+{
+    std::weak_ptr<int> value;
+
+    explicit operator bool() const
+    {
+        return !value.expired();
+    }
+
+    bool operator==(const Widget& other) const
+    {
+        return value.lock() == other.value.lock();
+    }
+
+    bool operator!=(const Widget& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+using Pool = StalledIssuesWidgetsPool<int, int, Widget>;
+
+// Owns the widgets the pool creates, as the view does
+class WidgetsOwner
+{
+public:
+    explicit WidgetsOwner(int poolSize):
+        pool(poolSize)
+    {}
+
+    Widget acquire(int kind, int key, Pool::Acquired& acquired)
+    {
+        return pool.acquire(kind,
+                            key,
+                            [this, key]()
+                            {
+                                widgets.push_back(std::make_shared<int>(key));
+                                return Widget{widgets.back()};
+                            },
+                            acquired);
+    }
+
+    void deleteWidget(const Widget& widget)
+    {
+        auto value(widget.value.lock());
+        widgets.erase(std::remove(widgets.begin(), widgets.end(), value), widgets.end());
+    }
+
+    Pool pool;
+    std::vector<std::shared_ptr<int>> widgets;
+};
+
+const int POOL_SIZE(30);
+const int ROWS(10000);
+const int VISIBLE_ROWS(20);
+const int REASONS(8);
+
+int reasonOfRow(int row)
+{
+    return (row * 7 + row / 3) % REASONS;
+}
+
+// Scrolls row by row from the top to the bottom, asking for the widgets of the visible rows
+template <class GetWidget>
+void scroll(GetWidget getWidget)
+{
+    for (int firstRow = 0; firstRow + VISIBLE_ROWS <= ROWS; ++firstRow)
+    {
+        for (int row = firstRow; row < firstRow + VISIBLE_ROWS; ++row)
+        {
+            getWidget(reasonOfRow(row), row);
+        }
+    }
+}
+
+// Body widgets as the delegate kept them before the pool: a slot by row % 30 and reason, and a
+// new widget each time the slot is asked for a different row
+int createdByRowSlots()
+{
+    QMap<QPair<int, int>, int> rowBySlot;
+    int created(0);
+    scroll(
+        [&rowBySlot, &created](int reason, int row)
+        {
+            auto slot(qMakePair(reason, row % POOL_SIZE));
+            auto rowIt(rowBySlot.find(slot));
+            if (rowIt == rowBySlot.end() || rowIt.value() != row)
+            {
+                rowBySlot.insert(slot, row);
+                created++;
+            }
+        });
+    return created;
+}
+
+int createdByPool()
+{
+    WidgetsOwner owner(POOL_SIZE);
+    scroll(
+        [&owner](int reason, int row)
+        {
+            Pool::Acquired acquired;
+            owner.acquire(reason, row, acquired);
+        });
+    return owner.pool.createdWidgets();
+}
+}
+
+TEST_CASE("StalledIssuesWidgetsPool", "[StalledIssuesWidgetsPool]")
+{
+    WidgetsOwner owner(2);
+    auto& pool(owner.pool);
+    Pool::Acquired acquired;
+
+    SECTION("Widgets are found by key and created up to the size of the kind")
+    {
+        auto first(owner.acquire(0, 1, acquired));
+        REQUIRE(acquired == Pool::Acquired::CREATED);
+        REQUIRE(owner.acquire(0, 1, acquired) == first);
+        REQUIRE(acquired == Pool::Acquired::FOUND);
+
+        owner.acquire(0, 2, acquired);
+        REQUIRE(acquired == Pool::Acquired::CREATED);
+        REQUIRE(pool.createdWidgets() == 2);
+        REQUIRE(pool.widgets().size() == 2);
+    }
+
+    SECTION("The least recently used widget of the kind is recycled")
+    {
+        auto first(owner.acquire(0, 1, acquired));
+        auto second(owner.acquire(0, 2, acquired));
+        owner.acquire(0, 1, acquired);
+
+        REQUIRE(owner.acquire(0, 3, acquired) == second);
+        REQUIRE(acquired == Pool::Acquired::RECYCLED);
+        REQUIRE(owner.acquire(0, 1, acquired) == first);
+        REQUIRE(acquired == Pool::Acquired::FOUND);
+        REQUIRE(owner.acquire(0, 2, acquired) == second);
+        REQUIRE(acquired == Pool::Acquired::RECYCLED);
+        REQUIRE(pool.createdWidgets() == 2);
+    }
+
+    SECTION("Kinds don't share widgets")
+    {
+        auto first(owner.acquire(0, 1, acquired));
+        owner.acquire(0, 2, acquired);
+
+        REQUIRE(owner.acquire(1, 1, acquired) != first);
+        REQUIRE(acquired == Pool::Acquired::CREATED);
+        REQUIRE(pool.widgets().size() == 3);
+    }
+
+    SECTION("Deleted widgets are dropped")
+    {
+        auto first(owner.acquire(0, 1, acquired));
+        auto second(owner.acquire(0, 2, acquired));
+        owner.deleteWidget(first);
+        REQUIRE(pool.widgets().size() == 1);
+
+        // There is room again, so the remaining one is not recycled
+        owner.acquire(0, 3, acquired);
+        REQUIRE(acquired == Pool::Acquired::CREATED);
+        REQUIRE(owner.acquire(0, 2, acquired) == second);
+        REQUIRE(acquired == Pool::Acquired::FOUND);
+
+        pool.clear();
+        REQUIRE(pool.widgets().isEmpty());
+        REQUIRE(pool.createdWidgets() == 3);
+    }
+}
+
+// Hidden by default, run with "[.benchmark]" or "[StalledIssuesWidgetsPoolBenchmark]"
+TEST_CASE("StalledIssuesWidgetsPool benchmark", "[.benchmark][StalledIssuesWidgetsPoolBenchmark]")
+{
+    auto byRowSlots(createdByRowSlots());
+    auto byPool(createdByPool());
+    WARN("Body widgets created per 1,000 rows scrolled: " << (byRowSlots * 1000 / ROWS)
+                                                          << " by row slots, "
+                                                          << (byPool * 1000 / ROWS) << " by pool");
+    REQUIRE(byPool < byRowSlots);
+    REQUIRE(byPool <= POOL_SIZE * REASONS);
+
+    BENCHMARK("Scroll with row slots")
+    {
+        return createdByRowSlots();
+    };
+
+    BENCHMARK("Scroll with pool")
+    {
+        return createdByPool();
+    };
+}
@@ -0,0 +1,52 @@
+#include "TransferStringPool.h"
+
+#include <catch.hpp>
+
+TEST_CASE("TransferStringPool shares the transfer strings", "[TransferStringPool]")
+{
+    TransferStringPool pool;
+
+    SECTION("Equal strings share the buffer")
+    {
+        auto first(pool.intern(QString::fromUtf8("/home/user/Documents/")));
+        auto second(pool.intern(QString::fromUtf8("/home/user/Documents/")));
+
+        REQUIRE(first == second);
+        REQUIRE(first.isSharedWith(second));
+        REQUIRE(pool.size() == 1);
+        REQUIRE(pool.bytes() == TransferStringPool::stringBytes(first));
+    }
+
+    SECTION("Empty strings are not pooled")
+    {
+        REQUIRE(pool.intern(QString()).isNull());
+        REQUIRE(pool.intern(QString::fromUtf8("")).isNull());
+        REQUIRE(pool.size() == 0);
+        REQUIRE(pool.bytes() == 0);
+    }
+
+    SECTION("Purge releases the strings no longer used")
+    {
+        auto used(pool.intern(QString::fromUtf8("used.txt")));
+        pool.intern(QString::fromUtf8("unused.txt"));
+        REQUIRE(pool.size() == 2);
+
+        pool.purge();
+        REQUIRE(pool.size() == 1);
+        REQUIRE(pool.bytes() == TransferStringPool::stringBytes(used));
+        REQUIRE(pool.intern(QString::fromUtf8("used.txt")).isSharedWith(used));
+
+        used.clear();
+        pool.purge();
+        REQUIRE(pool.size() == 0);
+        REQUIRE(pool.bytes() == 0);
+    }
+
+    SECTION("Clear")
+    {
+        auto value(pool.intern(QString::fromUtf8("file.txt")));
+        pool.clear();
+        REQUIRE(pool.size() == 0);
+        REQUIRE(value == QString::fromUtf8("file.txt"));
+    }
+}
@@ -0,0 +1,207 @@
+#include "TransferTagIndex.h"
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QPersistentModelIndex>
+
+#include <catch.hpp>
+
+#include <string>
+
+namespace
+{
+TransferTagIndex createIndex(int rows)
+{
+    TransferTagIndex index;
+    index.reserve(rows);
+    for (int row = 0; row < rows; ++row)
+    {
+        // Tags are not contiguous in real life (folder transfers, retries...)
+        index.append(row * 3 + 1);
+    }
+    return index;
+}
+
+// Removes every other row, from the bottom to the top, the way TransfersModel clears a
+// non-contiguous selection
+void clearEveryOtherRow(TransferTagIndex& index)
+{
+    index.beginBatch();
+    for (int row = index.size() - 1; row >= 0; row -= 2)
+    {
+        index.removeRows(row, 1);
+    }
+    index.endBatch();
+}
+
+// Minimal model reproducing the previous QPersistentModelIndex based bookkeeping
+class PersistentTagsModel: public QAbstractListModel
+{
+public:
+    explicit PersistentTagsModel(int rows)
+    {
+        mTags.reserve(rows);
+        for (int row = 0; row < rows; ++row)
+        {
+            mTags.append(row * 3 + 1);
+            mTagByOrder.insert(mTags.last(), QPersistentModelIndex(index(row, 0)));
+        }
+    }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : mTags.size();
+    }
+
+    QVariant data(const QModelIndex&, int) const override
+    {
+        return QVariant();
+    }
+
+    void clearEveryOtherRow()
+    {
+        for (int row = mTags.size() - 1; row >= 0; row -= 2)
+        {
+            beginRemoveRows(QModelIndex(), row, row);
+            mTagByOrder.remove(mTags.takeAt(row));
+            endRemoveRows();
+        }
+    }
+
+    int row(int tag) const
+    {
+        return mTagByOrder.contains(tag) ? mTagByOrder.value(tag).row() : -1;
+    }
+
+private:
+    QVector<int> mTags;
+    QHash<int, QPersistentModelIndex> mTagByOrder;
+};
+}
+
+TEST_CASE("TransferTagIndex keeps rows in sync", "[TransferTagIndex]")
+{
+    auto index(createIndex(100));
+
+    SECTION("Lookup")
+    {
+        REQUIRE(index.size() == 100);
+        REQUIRE(index.row(1) == 0);
+        REQUIRE(index.row(99 * 3 + 1) == 99);
+        REQUIRE(index.row(2) == -1);
+        REQUIRE(index.tagAt(10) == 31);
+    }
+
+    SECTION("Remove")
+    {
+        index.removeRows(10, 5);
+        REQUIRE(index.size() == 95);
+        REQUIRE_FALSE(index.contains(31));
+        REQUIRE(index.row(15 * 3 + 1) == 10);
+        REQUIRE(index.row(99 * 3 + 1) == 94);
+    }
+
+    SECTION("Remove inside a batch")
+    {
+        index.beginBatch();
+        index.removeRows(90, 1);
+        // Lookups inside a batch still return the right row
+        REQUIRE(index.row(95 * 3 + 1) == 94);
+        index.removeRows(5, 1);
+        index.endBatch();
+
+        REQUIRE(index.size() == 98);
+        REQUIRE(index.row(95 * 3 + 1) == 93);
+        REQUIRE(index.row(4 * 3 + 1) == 4);
+        REQUIRE(index.row(6 * 3 + 1) == 5);
+    }
+
+    SECTION("Move")
+    {
+        index.moveRows(50, 2, 0);
+        REQUIRE(index.row(50 * 3 + 1) == 0);
+        REQUIRE(index.row(51 * 3 + 1) == 1);
+        REQUIRE(index.row(1) == 2);
+        REQUIRE(index.row(52 * 3 + 1) == 52);
+
+        index.moveRows(0, 1, 100);
+        REQUIRE(index.row(50 * 3 + 1) == 99);
+        REQUIRE(index.row(51 * 3 + 1) == 0);
+    }
+
+    SECTION("Clear")
+    {
+        clearEveryOtherRow(index);
+        REQUIRE(index.size() == 50);
+        for (int row = 0; row < index.size(); ++row)
+        {
+            REQUIRE(index.row(index.tagAt(row)) == row);
+        }
+
+        index.clear();
+        REQUIRE(index.size() == 0);
+        REQUIRE(index.row(1) == -1);
+    }
+}
+
+// Hidden by default, run with "[.benchmark]" or "[TransferTagIndexBenchmark]"
+TEST_CASE("TransferTagIndex benchmark", "[.benchmark][TransferTagIndexBenchmark]")
+{
+    const auto rows = GENERATE(10000, 100000, 1000000);
+    const auto suffix(std::string(" - ") + std::to_string(rows) + " rows");
+
+    BENCHMARK("Fill" + suffix)
+    {
+        return createIndex(rows);
+    };
+
+    BENCHMARK("Fill and clear every other row" + suffix)
+    {
+        auto index(createIndex(rows));
+        clearEveryOtherRow(index);
+        return index.size();
+    };
+
+    // Each removal fixes up every persistent index, so bigger sizes take minutes
+    if (rows <= 10000)
+    {
+        BENCHMARK("Fill and clear every other row (QPersistentModelIndex)" + suffix)
+        {
+            PersistentTagsModel model(rows);
+            model.clearEveryOtherRow();
+            return model.rowCount();
+        };
+    }
+
+    auto index(createIndex(rows));
+    PersistentTagsModel model(rows);
+
+    BENCHMARK("Reprioritise 100 rows to top" + suffix)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            index.moveRows(rows - 1, 1, 0);
+        }
+        return index.tagAt(0);
+    };
+
+    BENCHMARK("Lookup all tags" + suffix)
+    {
+        long long total(0);
+        for (int row = 0; row < rows; ++row)
+        {
+            total += index.row(row * 3 + 1);
+        }
+        return total;
+    };
+
+    BENCHMARK("Lookup all tags (QPersistentModelIndex)" + suffix)
+    {
+        long long total(0);
+        for (int row = 0; row < rows; ++row)
+        {
+            total += model.row(row * 3 + 1);
+        }
+        return total;
+    };
+}
@@ -30,6 +30,14 @@ const char OP_SEND        = 'C'; //Copy to user
 const char OP_STRING      = 'T'; //Get Translated String
 const char OP_VIEW        = 'V'; //View on MEGA
 const char OP_PREVIOUS    = 'R'; //View previous versions
+const char OP_BATCH_PATH_STATE = 'Q'; //Path states of several paths
+
+const char ASCII_FILE_SEP = 0x1C;
+const char ASCII_RECORD_SEP = 0x1E;
+// Paths sent in each batched path state request
+const int BATCH_MAX_PATHS = 1000;
+
+const char OP_FOLDER_CHANGED = 'F'; //Notify server: many items of a folder changed
 
 class MegasyncDolphinOverlayPlugin : public KOverlayIconPlugin
 {
@@ -44,6 +52,8 @@ class MegasyncDolphinOverlayPlugin : public KOverlayIconPlugin
 
     QLocalSocket sockExtServer;
     QString sockPathExtServer;
+    // 1 if the ext server answers batched path state requests, -1 if unknown
+    int batchSupported = -1;
 
 private Q_SLOTS:
 
@@ -109,6 +119,27 @@ private Q_SLOTS:
 
             // qDebug("MEGASYNCOVERLAYPLUGIN: Server notified <%s>: %s",action.toUtf8().constData(), url.toUtf8().constData());
 
+            if (*type == OP_FOLDER_CHANGED)
+            {
+                // Many items of the folder changed at once, refresh all its children
+                // with a single state request
+                const auto children = QDir(url).entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+                QVector<QString> childPaths;
+                childPaths.reserve(children.size());
+                for (const auto& child : children)
+                {
+                    childPaths << child.absoluteFilePath();
+                }
+
+                const auto states = getStates(childPaths);
+                for (int i = 0; i < childPaths.size(); ++i)
+                {
+                    const auto childUrl = QUrl::fromLocalFile(childPaths.at(i));
+                    Q_EMIT overlaysChanged(childUrl, getOverlaysForState(childPaths.at(i), states.at(i)));
+                }
+                continue;
+            }
+
             Q_EMIT overlaysChanged(QUrl::fromLocalFile(url), getOverlays(QUrl::fromLocalFile(url)));
         }
     }
@@ -152,6 +183,14 @@ public:
             return {};
         }
 
+        const auto qStrURL = url.toLocalFile();
+        return getOverlaysForState(qStrURL, getState(qStrURL));
+    }
+
+private:
+
+    QStringList getOverlaysForState(const QString& qStrURL, int state)
+    {
         auto restoreDefaultIconIfNeeded = [&](const QString& qStrURL/*, int state*/)
         {
             // qDebug("MEGASYNCOVERLAYPLUGIN: getOverlays <%s>: %d",
@@ -174,9 +213,6 @@ public:
 
         QStringList r;
 
-        const auto qStrURL = url.toLocalFile();
-        const auto state = getState(qStrURL);
-
         switch (state)
         {
             case RESPONSE_SYNCED:
@@ -211,8 +247,6 @@ public:
         return r;
     }
 
-private:
-
     int getState(const QString& path)
     {
         QString res;
@@ -221,6 +255,115 @@ private:
         return res.isEmpty() ? RESPONSE_ERROR : res.toInt();
     }
 
+    // Returns the state of each path. The paths are sent in batches when the server supports
+    // them, one by one otherwise
+    QVector<int> getStates(const QVector<QString>& paths)
+    {
+        QVector<int> states;
+        states.reserve(paths.size());
+
+        for (int first = 0; first < paths.size(); first += BATCH_MAX_PATHS)
+        {
+            const auto batch = paths.mid(first, BATCH_MAX_PATHS);
+            auto batchStates = isBatchSupported() ? sendBatchRequest(batch) : QVector<int>();
+            if (batchStates.size() != batch.size())
+            {
+                batchStates.clear();
+                for (const auto& path : batch)
+                {
+                    batchStates << getState(path);
+                }
+            }
+            states << batchStates;
+        }
+
+        return states;
+    }
+
+    // An empty batch is answered with an empty line, older servers answer "default"
+    bool isBatchSupported()
+    {
+        if (batchSupported < 0)
+        {
+            QByteArray response;
+            if (sendLineRequest(QByteArray(1, OP_BATCH_PATH_STATE).append(":0:"), response))
+            {
+                batchSupported = response.isEmpty() ? 1 : 0;
+            }
+        }
+
+        return batchSupported > 0;
+    }
+
+    // Returns the states in the order of the paths, or an empty vector if the request failed
+    QVector<int> sendBatchRequest(const QVector<QString>& paths)
+    {
+        QByteArray payload;
+        for (const auto& path : paths)
+        {
+            if (!payload.isEmpty())
+            {
+                payload.append(ASCII_RECORD_SEP);
+            }
+            payload.append(QFileInfo(path).canonicalFilePath().toUtf8());
+            payload.append(ASCII_FILE_SEP);
+            payload.append('0');
+        }
+
+        QByteArray request(1, OP_BATCH_PATH_STATE);
+        request.append(':').append(QByteArray::number(payload.size())).append(':').append(payload);
+
+        QByteArray response;
+        QVector<int> states;
+        if (!sendLineRequest(request, response) || response.isEmpty())
+        {
+            return states;
+        }
+
+        const auto items = response.split(':');
+        if (items.size() == paths.size())
+        {
+            for (const auto& item : items)
+            {
+                states << item.toInt();
+            }
+        }
+
+        return states;
+    }
+
+    // send a formatted request and wait for the whole response line, which may come in several
+    // reads
+    bool sendLineRequest(const QByteArray& request, QByteArray& response)
+    {
+        const int waitTime = -1;
+
+        if(!sockExtServer.isOpen())
+        {
+            batchSupported = -1;
+            sockExtServer.connectToServer(sockPathExtServer);
+            if(!sockExtServer.waitForConnected(waitTime))
+            {
+                return false;
+            }
+        }
+
+        sockExtServer.write(request);
+        sockExtServer.flush();
+
+        while (!sockExtServer.canReadLine())
+        {
+            if(!sockExtServer.waitForReadyRead(waitTime))
+            {
+                sockExtServer.close();
+                return false;
+            }
+        }
+
+        response = sockExtServer.readLine().trimmed();
+        return true;
+    }
+
     // send request and receive response from Extension server
     // Return newly-allocated response string
     QString sendRequest(char type, const QString& command)
@@ -231,6 +374,8 @@ private:
 
         if(!sockExtServer.isOpen())
         {
+            // The server may be a different version on the next connection
+            batchSupported = -1;
             sockExtServer.connectToServer(sockPathExtServer);
             if(!sockExtServer.waitForConnected(waitTime))
             {
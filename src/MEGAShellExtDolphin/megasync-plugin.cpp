@@ -45,9 +45,16 @@ const char OP_VIEW        = 'V'; //View on MEGA
 const char OP_PREVIOUS    = 'R'; //View previous versions
 const char OP_BACKUP = 'B'; // Backup folder
 const char OP_SYNC = 'Y'; // Sync folder
+const char OP_BATCH_PATH_STATE = 'Q'; // Path states of several paths
+
+const char ASCII_FILE_SEP = 0x1C;
+const char ASCII_RECORD_SEP = 0x1E;
+// Paths sent in each batched path state request
+const int BATCH_MAX_PATHS = 1000;
 
 MEGASyncPlugin::MEGASyncPlugin(QObject* parent, const QList<QVariant> & args):
-    KAbstractFileItemActionPlugin(parent)
+    KAbstractFileItemActionPlugin(parent),
+    mBatchSupported(-1)
 {
     qDebug("MEGASYNCPLUGIN : Started");
     Q_UNUSED(args);
@@ -71,8 +78,7 @@ QList<QAction*> MEGASyncPlugin::actions(const KFileItemListProperties & fileItem
     int state = RESPONSE_ERROR;
 
     // Check if the Desktop App is running
-    mSelectedFilePath = QLatin1String("~");
-    state = getState();
+    state = getState(QLatin1String("~"));
 
     if (state == RESPONSE_ERROR)
     {
@@ -87,13 +93,20 @@ QList<QAction*> MEGASyncPlugin::actions(const KFileItemListProperties & fileItem
     mSelectedFilePath.clear();
     mSelectedFilePaths.clear();
 
-    for (const auto &item : fileItemInfos.items())
+    const auto items = fileItemInfos.items();
+    for (const auto &item : items)
     {
         mSelectedFilePath = item.localPath();
         mSelectedFilePaths << mSelectedFilePath;
+    }
 
-        // get the state of selected file
-        state = getState();
+    // get the state of the selected files, with a single request when possible
+    const auto states = getStates(mSelectedFilePaths);
+
+    for (int i = 0; i < items.size(); ++i)
+    {
+        const auto& item = items.at(i);
+        state = states.at(i);
 
         // count the number of synced / unsynced files and folders
         if (state == RESPONSE_SYNCED || state == RESPONSE_SYNCING || state == RESPONSE_PENDING)
@@ -192,16 +205,95 @@ QList<QAction*> MEGASyncPlugin::actions(const KFileItemListProperties & fileItem
     return actions;
 }
 
-int MEGASyncPlugin::getState()
+int MEGASyncPlugin::getState(const QString& path)
 {
-    auto cannonicalpath = QFileInfo(mSelectedFilePath).canonicalFilePath();
-    cannonicalpath.append(QLatin1Char(0x1C));
+    auto cannonicalpath = QFileInfo(path).canonicalFilePath();
+    cannonicalpath.append(QLatin1Char(ASCII_FILE_SEP));
     cannonicalpath.append(QLatin1Char('1'));
     auto res = sendRequest(OP_PATH_STATE, cannonicalpath);
 
     return res.isEmpty() ? RESPONSE_ERROR : res.toInt();
 }
 
+// Returns the state of each path. The paths are sent in batches when the server supports them,
+// one by one otherwise
+QVector<int> MEGASyncPlugin::getStates(const QVector<QString>& paths)
+{
+    QVector<int> states;
+    states.reserve(paths.size());
+
+    for (int first = 0; first < paths.size(); first += BATCH_MAX_PATHS)
+    {
+        const auto batch = paths.mid(first, BATCH_MAX_PATHS);
+        auto batchStates = isBatchSupported() ? sendBatchRequest(batch) : QVector<int>();
+        if (batchStates.size() != batch.size())
+        {
+            batchStates.clear();
+            for (const auto& path : batch)
+            {
+                batchStates << getState(path);
+            }
+        }
+        states << batchStates;
+    }
+
+    return states;
+}
+
+// An empty batch is answered with an empty line, older servers answer "default"
+bool MEGASyncPlugin::isBatchSupported()
+{
+    if (mBatchSupported < 0)
+    {
+        QByteArray response;
+        if (sendLineRequest(QByteArray(1, OP_BATCH_PATH_STATE).append(":0:"), response))
+        {
+            mBatchSupported = response.isEmpty() ? 1 : 0;
+        }
+    }
+
+    return mBatchSupported > 0;
+}
+
+// Returns the states in the order of the paths, or an empty vector if the request failed
+QVector<int> MEGASyncPlugin::sendBatchRequest(const QVector<QString>& paths)
+{
+    QByteArray payload;
+    for (const auto& path : paths)
+    {
+        if (!payload.isEmpty())
+        {
+            payload.append(ASCII_RECORD_SEP);
+        }
+        payload.append(QFileInfo(path).canonicalFilePath().toUtf8());
+        payload.append(ASCII_FILE_SEP);
+        payload.append('1');
+    }
+
+    QByteArray request(1, OP_BATCH_PATH_STATE);
+    request.append(':').append(QByteArray::number(payload.size())).append(':').append(payload);
+
+    qDebug("MEGASYNCPLUGIN : Sending batch request: %d paths", paths.size());
+
+    QByteArray response;
+    QVector<int> states;
+    if (!sendLineRequest(request, response) || response.isEmpty())
+    {
+        return states;
+    }
+
+    const auto items = response.split(':');
+    if (items.size() == paths.size())
+    {
+        for (const auto& item : items)
+        {
+            states << item.toInt();
+        }
+    }
+
+    return states;
+}
+
 void MEGASyncPlugin::getLink()
 {
     if (sendRequest(OP_LINK, QFileInfo(mSelectedFilePath).canonicalFilePath()).size())
@@ -313,6 +405,8 @@ QString MEGASyncPlugin::sendRequest(char type, const QString& command)
 
     if(!sock.isOpen())
     {
+        // The server may be a different version on the next connection
+        mBatchSupported = -1;
         sock.connectToServer(sockPath);
         if(!sock.waitForConnected(waitTime))
         {
@@ -337,4 +431,35 @@ QString MEGASyncPlugin::sendRequest(char type, const QString& command)
     return QString::fromUtf8(sock.readAll().trimmed());
 }
 
+// send a formatted request and wait for the whole response line, which may come in several reads
+bool MEGASyncPlugin::sendLineRequest(const QByteArray& request, QByteArray& response)
+{
+    const int waitTime = -1;
+
+    if(!sock.isOpen())
+    {
+        mBatchSupported = -1;
+        sock.connectToServer(sockPath);
+        if(!sock.waitForConnected(waitTime))
+        {
+            return false;
+        }
+    }
+
+    sock.write(request);
+    sock.flush();
+
+    while (!sock.canReadLine())
+    {
+        if(!sock.waitForReadyRead(waitTime))
+        {
+            sock.close();
+            return false;
+        }
+    }
+
+    response = sock.readLine().trimmed();
+    return true;
+}
+
 #include "megasync-plugin.moc"
@@ -20,8 +20,14 @@ private:
     QString sockPath;
     QString mSelectedFilePath;
     QVector<QString> mSelectedFilePaths;
-    int getState();
+    // 1 if the server answers batched path state requests, -1 if unknown
+    int mBatchSupported;
+    int getState(const QString& path);
+    QVector<int> getStates(const QVector<QString>& paths);
     QString sendRequest(char type, const QString& command);
+    bool sendLineRequest(const QByteArray& request, QByteArray& response);
+    bool isBatchSupported();
+    QVector<int> sendBatchRequest(const QVector<QString>& paths);
 
 public:
     explicit MEGASyncPlugin(QObject* parent = nullptr, const QVariantList& args = QVariantList());
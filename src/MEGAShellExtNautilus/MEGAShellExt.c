@@ -15,8 +15,12 @@
 #include "MEGAShellExt.h"
 #include "mega_ext_client.h"
 #include "mega_notify_client.h"
+#include "mega_state_cache.h"
 #include <string.h>
 
+// paths whose state is kept in the extension
+#define MAX_CACHED_STATES 10000
+
 static GObjectClass *parent_class;
 
 static void mega_ext_class_init(MEGAExtClass *class, G_GNUC_UNUSED gpointer class_data)
@@ -39,6 +43,10 @@ static void mega_ext_instance_init(MEGAExt *mega_ext, G_GNUC_UNUSED gpointer g_c
     mega_ext->string_sync = NULL;
 
     mega_ext->syncs_received = FALSE;
+    mega_ext->batch_supported = -1;
+    mega_ext->pending_updates = g_queue_new();
+    mega_ext->pending_updates_source = 0;
+    mega_ext->state_cache = mega_state_cache_new(MAX_CACHED_STATES);
 
     // ignore SIGPIPE as we most likely will write to a closed socket in mega_notify_client_read()
     signal(SIGPIPE, SIG_IGN);
@@ -68,10 +76,49 @@ static const gchar *file_state_to_str(FileState state)
     }
 }
 
+// a file waiting for its state, sent with the other pending files in a single request
+// update_complete is NULL for the items changed notified by MEGAsync
+typedef struct {
+    NautilusFileInfo *file;
+    GClosure *update_complete;
+} MEGAExtPendingUpdate;
+
+// files whose state is requested in each idle iteration
+#define MAX_UPDATES_PER_BATCH 1000
+
+static gboolean mega_ext_process_pending_updates(gpointer user_data);
+
+static MEGAExtPendingUpdate *mega_ext_queue_update(MEGAExt *mega_ext, NautilusFileInfo *file, GClosure *update_complete)
+{
+    MEGAExtPendingUpdate *update;
+
+    update = g_new0(MEGAExtPendingUpdate, 1);
+    update->file = g_object_ref(file);
+    if (update_complete)
+        update->update_complete = g_closure_ref(update_complete);
+
+    g_queue_push_tail(mega_ext->pending_updates, update);
+    if (!mega_ext->pending_updates_source)
+        mega_ext->pending_updates_source = g_idle_add(mega_ext_process_pending_updates, mega_ext);
+
+    return update;
+}
+
+static void mega_ext_pending_update_free(MEGAExtPendingUpdate *update)
+{
+    g_object_unref(update->file);
+    if (update->update_complete)
+        g_closure_unref(update->update_complete);
+    g_free(update);
+}
+
 // received path from notify server with the path to item which state was changed
 void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path)
 {
     GFile *f;
+
+    mega_state_cache_remove(mega_ext->state_cache, path);
+
     f = g_file_new_for_path(path);
     if (!f) {
         g_debug("No file found for %s!", path);
@@ -79,12 +126,37 @@ void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path)
     }
 
     NautilusFileInfo *file = nautilus_file_info_lookup(f);
+    g_object_unref(f);
     if (!file) {
         g_debug("No NautilusFileInfo found for %s!", path);
         return;
     }
     g_debug("Item changed: %s", path);
-    nautilus_info_provider_update_file_info((NautilusInfoProvider*)mega_ext, file, (void*)1, (void*)1);
+    // sent with the other changes received in this main loop iteration
+    mega_ext_queue_update(mega_ext, file, NULL);
+    g_object_unref(file);
+}
+
+// received path from notify server when many items of a folder changed at once:
+// refresh the children the file manager has loaded (the lookup skips the others)
+void mega_ext_on_folder_changed(MEGAExt *mega_ext, const gchar *path)
+{
+    GDir *dir;
+    const gchar *name;
+
+    dir = g_dir_open(path, 0, NULL);
+    if (!dir) {
+        g_debug("Can't open folder %s!", path);
+        return;
+    }
+
+    g_debug("Folder changed: %s", path);
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        gchar *child = g_build_filename(path, name, NULL);
+        mega_ext_on_item_changed(mega_ext, child);
+        g_free(child);
+    }
+    g_dir_close(dir);
 }
 
 // user clicked on "Upload to MEGA" menu item
@@ -131,12 +203,14 @@ void mega_ext_on_sync_add(MEGAExt *mega_ext, const gchar *path)
         return;
     g_debug("New sync path: %s", path);
     g_hash_table_insert(mega_ext->h_syncs, g_strdup(path), GINT_TO_POINTER(1));
+    mega_state_cache_clear(mega_ext->state_cache);
 }
 
 void mega_ext_on_sync_del(MEGAExt *mega_ext, const gchar *path)
 {
     g_debug("Deleted sync path: %s", path);
     g_hash_table_remove(mega_ext->h_syncs, path);
+    mega_state_cache_clear(mega_ext->state_cache);
 }
 
 void expanselocalpath(const char *path, char *absolutepath)
@@ -386,49 +460,66 @@ static GList *mega_ext_get_file_items(NautilusMenuProvider *provider,
     MEGAExt *mega_ext = MEGA_EXT(provider);
     GList *l, *l_out = NULL;
     int syncedFiles, syncedFolders, unsyncedFiles, unsyncedFolders;
+    guint num_files, query_count, i;
+    gchar **paths;
+    const gchar **query_paths;
+    FileState *states, *query_states;
+    guint *query_index;
     gchar *out = NULL;
 
     g_debug("mega_ext_get_file_items: %u", g_list_length(files));
 
     syncedFiles = syncedFolders = unsyncedFiles = unsyncedFolders = 0;
 
-    // get list of selected objects
-    for (l = files; l != NULL; l = l->next)
+    // get the state of the selected objects, with a single request when possible
+    num_files = g_list_length(files);
+    paths = g_new0(gchar*, num_files);
+    states = g_new(FileState, num_files);
+    query_paths = g_new(const gchar*, num_files);
+    query_states = g_new(FileState, num_files);
+    query_index = g_new(guint, num_files);
+    query_count = 0;
+
+    for (l = files, i = 0; l != NULL; l = l->next, i++)
     {
         NautilusFileInfo *file = NAUTILUS_FILE_INFO(l->data);
-        gchar *path;
         GFile *fp;
-        FileState state;
 
         fp = nautilus_file_info_get_location(file);
-        if (!fp)
+        if (fp)
         {
-            continue;
+            paths[i] = g_file_get_path(fp);
+            g_object_unref(fp);
         }
 
-        path = g_file_get_path(fp);
-        if (!path)
+        if (!paths[i])
         {
-            continue;
+            states[i] = RESPONSE_ERROR;
         }
-
         // avoid sending requests for files which are not in synced folders
         // but make sure we received the list of synced folders first
-        if (mega_ext->syncs_received && !mega_ext_path_in_sync(mega_ext, path))
+        else if (mega_ext->syncs_received && !mega_ext_path_in_sync(mega_ext, paths[i]))
         {
-            state = RESPONSE_DEFAULT;
+            states[i] = RESPONSE_DEFAULT;
         }
         else
         {
-            state = mega_ext_client_get_path_state(mega_ext, path, 1);
-            if (state == RESPONSE_DEFAULT)
-            {
-                char canonical[PATH_MAX];
-                expanselocalpath(path,canonical);
-                state = mega_ext_client_get_path_state(mega_ext, canonical, 1);
-            }
+            query_index[query_count] = i;
+            query_paths[query_count++] = paths[i];
         }
-        g_free(path);
+    }
+
+    mega_ext_client_get_path_states(mega_ext, query_paths, query_count, 1, query_states);
+    for (i = 0; i < query_count; i++)
+    {
+        states[query_index[i]] = query_states[i];
+    }
+
+    // get list of selected objects
+    for (l = files, i = 0; l != NULL; l = l->next, i++)
+    {
+        NautilusFileInfo *file = NAUTILUS_FILE_INFO(l->data);
+        FileState state = states[i];
 
         if (state == RESPONSE_ERROR)
         {
@@ -464,6 +555,15 @@ static GList *mega_ext_get_file_items(NautilusMenuProvider *provider,
         }
     }
 
+    for (i = 0; i < num_files; i++)
+    {
+        g_free(paths[i]);
+    }
+    g_free(paths);
+    g_free(states);
+    g_free(query_paths);
+    g_free(query_states);
+    g_free(query_index);
 
     NautilusMenuItem *root_menu_item = nautilus_menu_item_new("NautilusObj::root_menu_item",
                                                 "MEGA",
@@ -619,72 +719,48 @@ static GList *mega_ext_get_file_items(NautilusMenuProvider *provider,
     return l_out;
 }
 
-static NautilusOperationResult mega_ext_update_file_info(NautilusInfoProvider *provider,
-    NautilusFileInfo *file, G_GNUC_UNUSED GClosure *update_complete, G_GNUC_UNUSED NautilusOperationHandle **handle)
+// set the emblem for the state of the file
+// invalidate is only used for the items changed notified by MEGAsync: the updates requested by
+// Nautilus are refreshed when they are completed
+static void mega_ext_set_file_state(NautilusFileInfo *file, const gchar *path, FileState state, gboolean invalidate)
 {
-    MEGAExt *mega_ext = MEGA_EXT(provider);
-    gchar *path;
-    GFile *fp;
-    FileState state;
-
-    fp = nautilus_file_info_get_location(file);
-    if (!fp)
-    {
-        return NAUTILUS_OPERATION_COMPLETE;
-    }
-
-    path = g_file_get_path(fp);
-    if (!path)
-    {
-        return NAUTILUS_OPERATION_COMPLETE;
-    }
+    g_debug("mega_ext_update_file_info. File: %s  State: %s", path, file_state_to_str(state));
 
-    gboolean has_mega_icon = FALSE;
-    GFileInfo* file_info = g_file_query_info(fp, "metadata::custom-icon", G_FILE_QUERY_INFO_NONE, NULL, NULL);
-    if (file_info != NULL)
+    // process items located in sync folders
+    if (state == RESPONSE_DEFAULT || state == RESPONSE_IGNORED)
     {
-        char* icon_path = g_file_info_get_attribute_as_string (file_info, "metadata::custom-icon");
-        if (icon_path != NULL)
+        GFile *fp = g_file_new_for_path(path);
+        gboolean has_mega_icon = FALSE;
+        GFileInfo* file_info = g_file_query_info(fp, "metadata::custom-icon", G_FILE_QUERY_INFO_NONE, NULL, NULL);
+        if (file_info != NULL)
         {
-            if (strstr(icon_path, "/usr/share/icons") && strstr(icon_path, "apps/mega.png"))
+            char* icon_path = g_file_info_get_attribute_as_string (file_info, "metadata::custom-icon");
+            if (icon_path != NULL)
             {
-                has_mega_icon = TRUE;
+                if (strstr(icon_path, "/usr/share/icons") && strstr(icon_path, "apps/mega.png"))
+                {
+                    has_mega_icon = TRUE;
+                }
+
+                g_free(icon_path);
             }
 
-            g_free(icon_path);
+            g_object_unref(file_info);
         }
 
-        g_object_unref(file_info);
-    }
-
-    state = mega_ext_client_get_path_state(mega_ext, path, 0);
-    if (state == RESPONSE_DEFAULT)
-    {
-        char canonical[PATH_MAX];
-        expanselocalpath(path,canonical);
-        state = mega_ext_client_get_path_state(mega_ext, canonical, 0);
-    }
-
-    g_debug("mega_ext_update_file_info. File: %s  State: %s", path, file_state_to_str(state));
-
-    // process items located in sync folders
-    if (state == RESPONSE_DEFAULT || state == RESPONSE_IGNORED)
-    {
         if (has_mega_icon)
         {
             g_file_set_attribute(fp, "metadata::custom-icon", G_FILE_ATTRIBUTE_TYPE_INVALID, NULL, G_FILE_QUERY_INFO_NONE, NULL, NULL);
             g_debug("mega_ext_update_file_info. removed mega-icon on %s", path);
         }
 
-        g_free(path);
-        return NAUTILUS_OPERATION_COMPLETE;
+        g_object_unref(fp);
+        return;
     }
 
-    g_free(path);
-
     if (state == RESPONSE_ERROR)
     {
-        return NAUTILUS_OPERATION_COMPLETE;
+        return;
     }
 
     switch (state)
@@ -702,8 +778,117 @@ static NautilusOperationResult mega_ext_update_file_info(NautilusInfoProvider *p
             break;
     }
     // invalidate current emblems.
-    nautilus_file_info_invalidate_extension_info(file);
-    return NAUTILUS_OPERATION_COMPLETE;
+    if (invalidate)
+        nautilus_file_info_invalidate_extension_info(file);
+}
+
+// send the state requests of the pending files, in batches
+// the updates requested by Nautilus are answered from the state cache when possible. The items
+// changed notified by MEGAsync are always requested, their cached state was just removed
+static gboolean mega_ext_process_pending_updates(gpointer user_data)
+{
+    MEGAExt *mega_ext = MEGA_EXT(user_data);
+    MEGAExtPendingUpdate *updates[MAX_UPDATES_PER_BATCH];
+    gchar *paths[MAX_UPDATES_PER_BATCH];
+    FileState states[MAX_UPDATES_PER_BATCH];
+    const gchar *query_paths[MAX_UPDATES_PER_BATCH];
+    FileState query_states[MAX_UPDATES_PER_BATCH];
+    guint query_index[MAX_UPDATES_PER_BATCH];
+    guint count = 0, query_count = 0, i;
+    // the cache can only be used while the notify server can invalidate it
+    gboolean use_cache = mega_ext->syncs_received;
+
+    while (count < MAX_UPDATES_PER_BATCH && !g_queue_is_empty(mega_ext->pending_updates))
+    {
+        GFile *fp;
+        gchar *path = NULL;
+
+        updates[count] = g_queue_pop_head(mega_ext->pending_updates);
+        paths[count] = NULL;
+
+        fp = nautilus_file_info_get_location(updates[count]->file);
+        if (fp)
+        {
+            path = g_file_get_path(fp);
+            g_object_unref(fp);
+        }
+
+        if (path)
+        {
+            // the notify server sends canonical paths
+            char canonical[PATH_MAX];
+            canonical[0] = '\0';
+            expanselocalpath(path, canonical);
+            paths[count] = canonical[0] ? g_strdup(canonical) : g_strdup(path);
+            g_free(path);
+
+            if (!use_cache || !updates[count]->update_complete
+                || !mega_state_cache_lookup(mega_ext->state_cache, paths[count], &states[count]))
+            {
+                query_index[query_count] = count;
+                query_paths[query_count++] = paths[count];
+            }
+        }
+        count++;
+    }
+
+    mega_ext_client_get_path_states(mega_ext, query_paths, query_count, 0, query_states);
+    for (i = 0; i < query_count; i++)
+    {
+        states[query_index[i]] = query_states[i];
+
+        // errors are not cached: overlays disabled, or MEGAsync not running
+        if (use_cache && query_states[i] != RESPONSE_ERROR)
+        {
+            mega_state_cache_insert(mega_ext->state_cache, query_paths[i], query_states[i]);
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (paths[i])
+        {
+            mega_ext_set_file_state(updates[i]->file, paths[i], states[i], !updates[i]->update_complete);
+            g_free(paths[i]);
+        }
+
+        if (updates[i]->update_complete)
+        {
+            nautilus_info_provider_update_complete_invoke(updates[i]->update_complete,
+                                                          (NautilusInfoProvider*)mega_ext,
+                                                          (NautilusOperationHandle*)updates[i],
+                                                          NAUTILUS_OPERATION_COMPLETE);
+        }
+        mega_ext_pending_update_free(updates[i]);
+    }
+
+    if (g_queue_is_empty(mega_ext->pending_updates))
+    {
+        mega_ext->pending_updates_source = 0;
+        return G_SOURCE_REMOVE;
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+// the state is not requested here: a folder with thousands of items would do a request per item.
+// The files are queued and their states are requested together when the main loop is idle
+static NautilusOperationResult mega_ext_update_file_info(NautilusInfoProvider *provider,
+    NautilusFileInfo *file, GClosure *update_complete, NautilusOperationHandle **handle)
+{
+    MEGAExt *mega_ext = MEGA_EXT(provider);
+
+    *handle = (NautilusOperationHandle*)mega_ext_queue_update(mega_ext, file, update_complete);
+    return NAUTILUS_OPERATION_IN_PROGRESS;
+}
+
+static void mega_ext_cancel_update(NautilusInfoProvider *provider, NautilusOperationHandle *handle)
+{
+    MEGAExt *mega_ext = MEGA_EXT(provider);
+    MEGAExtPendingUpdate *update = (MEGAExtPendingUpdate*)handle;
+
+    if (g_queue_remove(mega_ext->pending_updates, update))
+        mega_ext_pending_update_free(update);
 }
 
 static void mega_ext_menu_provider_iface_init(
@@ -726,6 +911,7 @@ static void mega_ext_info_provider_iface_init(
         G_GNUC_UNUSED gpointer iface_data)
 {
     iface->update_file_info = mega_ext_update_file_info;
+    iface->cancel_update = mega_ext_cancel_update;
 }
 
 static GType mega_ext_type = 0;
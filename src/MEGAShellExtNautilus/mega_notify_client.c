@@ -1,4 +1,5 @@
 #include "mega_notify_client.h"
+#include "mega_state_cache.h"
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -84,6 +85,9 @@ void mega_notify_client_destroy(MEGAExt *mega_ext)
         close(mega_ext->notify_sock);
     mega_ext->notify_sock = -1;
     mega_ext->syncs_received = FALSE;
+
+    // the cached states can not be invalidated until the connection is back
+    mega_state_cache_clear(mega_ext->state_cache);
 }
 
 static gboolean mega_notify_client_read(GIOChannel *notify_chan, GIOCondition condition, gpointer data)
@@ -134,6 +138,9 @@ static gboolean mega_notify_client_read(GIOChannel *notify_chan, GIOCondition co
         case 'P': // item state changed
             mega_ext_on_item_changed(mega_ext, p);
             break;
+        case 'F': // many items of a folder changed
+            mega_ext_on_folder_changed(mega_ext, p);
+            break;
         case 'A': // sync folder added
             mega_ext_on_sync_add(mega_ext, p);
             mega_ext->syncs_received = TRUE;
@@ -0,0 +1,134 @@
+#include "mega_state_cache.h"
+
+// set this environment variable to print the hit rate of the cache
+#define STATS_ENV_VAR "MEGA_EXT_CACHE_STATS"
+// lookups between two prints of the hit rate
+#define STATS_PRINT_INTERVAL 1000
+
+typedef struct {
+    gchar *path;
+    FileState state;
+} MEGAStateCacheEntry;
+
+struct _MEGAStateCache {
+    GHashTable *entries; // path -> link of the entry in lru
+    GQueue *lru; // entries, the most recently used first
+    guint max_entries;
+
+    gboolean print_stats;
+    guint64 hits;
+    guint64 misses;
+};
+
+static void mega_state_cache_entry_free(gpointer data)
+{
+    MEGAStateCacheEntry *entry = data;
+
+    g_free(entry->path);
+    g_free(entry);
+}
+
+static void mega_state_cache_print_stats(MEGAStateCache *cache)
+{
+    guint64 lookups = cache->hits + cache->misses;
+
+    if (!cache->print_stats || !lookups || lookups % STATS_PRINT_INTERVAL)
+        return;
+
+    g_message("State cache: %.1f%% hit rate (%" G_GUINT64_FORMAT " hits, %" G_GUINT64_FORMAT " misses), %u entries",
+              100.0 * cache->hits / lookups, cache->hits, cache->misses, g_queue_get_length(cache->lru));
+}
+
+MEGAStateCache *mega_state_cache_new(guint max_entries)
+{
+    MEGAStateCache *cache;
+
+    cache = g_new0(MEGAStateCache, 1);
+    // the keys are owned by the entries
+    cache->entries = g_hash_table_new(g_str_hash, g_str_equal);
+    cache->lru = g_queue_new();
+    cache->max_entries = max_entries;
+    cache->print_stats = g_getenv(STATS_ENV_VAR) != NULL;
+
+    return cache;
+}
+
+void mega_state_cache_free(MEGAStateCache *cache)
+{
+    if (!cache)
+        return;
+
+    g_hash_table_destroy(cache->entries);
+    g_queue_free_full(cache->lru, mega_state_cache_entry_free);
+    g_free(cache);
+}
+
+// return TRUE and set state if the path is cached
+gboolean mega_state_cache_lookup(MEGAStateCache *cache, const gchar *path, FileState *state)
+{
+    GList *link;
+
+    link = g_hash_table_lookup(cache->entries, path);
+    if (!link) {
+        cache->misses++;
+        mega_state_cache_print_stats(cache);
+        return FALSE;
+    }
+
+    g_queue_unlink(cache->lru, link);
+    g_queue_push_head_link(cache->lru, link);
+    *state = ((MEGAStateCacheEntry *)link->data)->state;
+
+    cache->hits++;
+    mega_state_cache_print_stats(cache);
+    return TRUE;
+}
+
+void mega_state_cache_insert(MEGAStateCache *cache, const gchar *path, FileState state)
+{
+    MEGAStateCacheEntry *entry;
+    GList *link;
+
+    link = g_hash_table_lookup(cache->entries, path);
+    if (link) {
+        ((MEGAStateCacheEntry *)link->data)->state = state;
+        g_queue_unlink(cache->lru, link);
+        g_queue_push_head_link(cache->lru, link);
+        return;
+    }
+
+    entry = g_new(MEGAStateCacheEntry, 1);
+    entry->path = g_strdup(path);
+    entry->state = state;
+    g_queue_push_head(cache->lru, entry);
+    g_hash_table_insert(cache->entries, entry->path, cache->lru->head);
+
+    // drop the least recently used path
+    if (g_queue_get_length(cache->lru) > cache->max_entries) {
+        entry = g_queue_pop_tail(cache->lru);
+        g_hash_table_remove(cache->entries, entry->path);
+        mega_state_cache_entry_free(entry);
+    }
+}
+
+void mega_state_cache_remove(MEGAStateCache *cache, const gchar *path)
+{
+    MEGAStateCacheEntry *entry;
+    GList *link;
+
+    link = g_hash_table_lookup(cache->entries, path);
+    if (!link)
+        return;
+
+    entry = link->data;
+    g_hash_table_remove(cache->entries, entry->path);
+    g_queue_delete_link(cache->lru, link);
+    mega_state_cache_entry_free(entry);
+}
+
+void mega_state_cache_clear(MEGAStateCache *cache)
+{
+    g_hash_table_remove_all(cache->entries);
+    g_queue_free_full(cache->lru, mega_state_cache_entry_free);
+    cache->lru = g_queue_new();
+}
@@ -0,0 +1,19 @@
+#ifndef MEGA_STATE_CACHE_H
+#define MEGA_STATE_CACHE_H
+
+#include "MEGAShellExt.h"
+
+// Bounded cache of the path states received from MEGAsync, keyed by canonical path.
+// The least recently used paths are dropped when it is full.
+// The entries are only valid while the notify server connection is up: its item changed and
+// sync added/deleted messages are what invalidates them.
+typedef struct _MEGAStateCache MEGAStateCache;
+
+MEGAStateCache *mega_state_cache_new(guint max_entries);
+void mega_state_cache_free(MEGAStateCache *cache);
+gboolean mega_state_cache_lookup(MEGAStateCache *cache, const gchar *path, FileState *state);
+void mega_state_cache_insert(MEGAStateCache *cache, const gchar *path, FileState state);
+void mega_state_cache_remove(MEGAStateCache *cache, const gchar *path);
+void mega_state_cache_clear(MEGAStateCache *cache);
+
+#endif
@@ -20,6 +20,10 @@ struct _MEGAExt {
     int notify_sock;
     gint num_retries; // reconnection retries
     gboolean syncs_received; // TRUE if the list with sync folders is received
+    gint batch_supported; // 1 if the server answers batched path state requests, -1 if unknown
+    GQueue *pending_updates; // files waiting for their state, see mega_ext_update_file_info()
+    guint pending_updates_source; // idle source that sends the pending updates
+    struct _MEGAStateCache *state_cache; // states received from MEGAsync, see mega_state_cache.h
 
     GHashTable *h_syncs; // table of paths of shared folders
     gchar *string_upload; // cached string
@@ -62,6 +66,7 @@ void  mega_ext_register_type(GTypeModule *module);
 G_END_DECLS
 
 void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path);
+void mega_ext_on_folder_changed(MEGAExt *mega_ext, const gchar *path);
 void mega_ext_on_sync_add(MEGAExt *mega_ext, const gchar *path);
 void mega_ext_on_sync_del(MEGAExt *mega_ext, const gchar *path);
 void expanselocalpath(const char *path, char *absolutepath);
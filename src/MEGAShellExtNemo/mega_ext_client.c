@@ -17,6 +17,12 @@ const gchar OP_VIEW        = 'V'; //View on MEGA
 const gchar OP_PREVIOUS    = 'R'; //View previous versions
 const gchar OP_BACKUP = 'B'; // Backup folder
 const gchar OP_SYNC = 'Y'; // Sync folder
+const gchar OP_BATCH_PATH_STATE = 'Q'; // Path states of several paths
+
+const gchar ASCII_FILE_SEP = 0x1C;
+const gchar ASCII_RECORD_SEP = 0x1E;
+// Paths sent in each batched path state request
+const guint BATCH_MAX_PATHS = 1000;
 const gchar *RESPONSE_DEFAULT_str = "9";
 
 static void mega_ext_client_disconnect(MEGAExt *mega_ext);
@@ -81,21 +87,21 @@ static void mega_ext_client_disconnect(MEGAExt *mega_ext)
     if (mega_ext->srv_sock > 0)
         close(mega_ext->srv_sock);
     mega_ext->srv_sock = -1;
+
+    // the server may be a different version on the next connection
+    mega_ext->batch_supported = -1;
 }
 
-// send request and receive response from Extension server
+// send a formatted request and receive response from Extension server
 // Return newly-allocated response string
-static gchar *mega_ext_client_send_request(MEGAExt *mega_ext, gchar type, const gchar *in)
+static gchar *mega_ext_client_send_raw_request(MEGAExt *mega_ext, const gchar *request, gsize len)
 {
     gchar *out = NULL;
-    gchar *tmp;
     gsize bytes_written;
     GError *error;
     GIOStatus status;
     gint num_retries;
 
-    g_debug("Sending request: %c:%s ", type, in);
-
     // try to send request several times
     for (num_retries = 0; num_retries < mega_ext->num_retries; num_retries++) {
         if (mega_ext->srv_sock < 0) {
@@ -105,19 +111,14 @@ static gchar *mega_ext_client_send_request(MEGAExt *mega_ext, gchar type, const
             }
         }
 
-        // format request string
-        tmp = g_strdup_printf("%c:%s", type, in);
-
         error = NULL;
         // try to send request
-        status = g_io_channel_write_chars(mega_ext->chan, tmp, strlen(tmp), &bytes_written, &error);
+        status = g_io_channel_write_chars(mega_ext->chan, request, len, &bytes_written, &error);
         if (status != G_IO_STATUS_NORMAL || error) {
             g_warning("Failed to write data!");
-            g_free(tmp);
             mega_ext_client_disconnect(mega_ext);
             continue;
         }
-        g_free(tmp);
 
         status = g_io_channel_flush(mega_ext->chan, &error);
         if (status != G_IO_STATUS_NORMAL || error) {
@@ -150,6 +151,87 @@ static gchar *mega_ext_client_send_request(MEGAExt *mega_ext, gchar type, const
     return out;
 }
 
+// send request and receive response from Extension server
+// Return newly-allocated response string
+static gchar *mega_ext_client_send_request(MEGAExt *mega_ext, gchar type, const gchar *in)
+{
+    gchar *out;
+    gchar *tmp;
+
+    g_debug("Sending request: %c:%s ", type, in);
+
+    // format request string
+    tmp = g_strdup_printf("%c:%s", type, in);
+    out = mega_ext_client_send_raw_request(mega_ext, tmp, strlen(tmp));
+    g_free(tmp);
+
+    return out;
+}
+
+// return TRUE if the server answers batched path state requests
+// an empty batch is answered with an empty line, older servers answer "default"
+static gboolean mega_ext_client_batch_supported(MEGAExt *mega_ext)
+{
+    gchar *out;
+
+    if (mega_ext->batch_supported < 0) {
+        out = mega_ext_client_send_request(mega_ext, OP_BATCH_PATH_STATE, "0:");
+        // keep it unknown if the server could not be reached
+        if (out) {
+            mega_ext->batch_supported = (out[0] == '\0' || out[0] == '\n');
+            g_free(out);
+        }
+    }
+
+    return mega_ext->batch_supported > 0;
+}
+
+// send one batched path state request
+// return FALSE if the response does not have a state for each path
+static gboolean mega_ext_client_send_batch(MEGAExt *mega_ext, const gchar **paths, guint count,
+                                           int forceGetState, FileState *states)
+{
+    GString *payload;
+    gchar *request;
+    gchar *out;
+    gchar **items;
+    gboolean result = FALSE;
+    guint i;
+
+    payload = g_string_new(NULL);
+    for (i = 0; i < count; i++) {
+        char canonical[PATH_MAX];
+        canonical[0] = '\0';
+        expanselocalpath(paths[i], canonical);
+
+        if (i)
+            g_string_append_c(payload, ASCII_RECORD_SEP);
+        g_string_append(payload, canonical);
+        g_string_append_c(payload, ASCII_FILE_SEP);
+        g_string_append_c(payload, forceGetState ? '1' : '0');
+    }
+
+    request = g_strdup_printf("%c:%" G_GSIZE_FORMAT ":%s", OP_BATCH_PATH_STATE, payload->len, payload->str);
+    g_debug("Sending batch request: %u paths", count);
+    out = mega_ext_client_send_raw_request(mega_ext, request, strlen(request));
+    g_free(request);
+    g_string_free(payload, TRUE);
+
+    if (!out)
+        return FALSE;
+
+    items = g_strsplit(g_strchomp(out), ":", -1);
+    if (g_strv_length(items) == count) {
+        for (i = 0; i < count; i++)
+            states[i] = atoi(items[i]);
+        result = TRUE;
+    }
+    g_strfreev(items);
+    g_free(out);
+
+    return result;
+}
+
 // return a newly-allocated string
 gchar *mega_ext_client_get_string(MEGAExt *mega_ext, int stringID, int numFiles, int numFolders)
 {
@@ -193,6 +275,24 @@ FileState mega_ext_client_get_path_state(MEGAExt *mega_ext, const gchar *path, i
     return st;
 }
 
+// fill states with the state of each path
+// the paths are sent in batches when the server supports them, one by one otherwise
+void mega_ext_client_get_path_states(MEGAExt *mega_ext, const gchar **paths, guint count,
+                                     int forceGetState, FileState *states)
+{
+    guint first, i, batch;
+
+    for (first = 0; first < count; first += batch) {
+        batch = MIN(count - first, BATCH_MAX_PATHS);
+
+        if (!mega_ext_client_batch_supported(mega_ext)
+            || !mega_ext_client_send_batch(mega_ext, paths + first, batch, forceGetState, states + first)) {
+            for (i = first; i < first + batch; i++)
+                states[i] = mega_ext_client_get_path_state(mega_ext, paths[i], forceGetState);
+        }
+    }
+}
+
 gboolean mega_ext_client_paste_link(MEGAExt *mega_ext, const gchar *path)
 {
     gchar *out;
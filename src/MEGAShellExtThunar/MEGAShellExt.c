@@ -84,6 +84,7 @@ static void mega_ext_init(MEGAExt* mega_ext)
     mega_ext->string_backup = NULL;
     mega_ext->string_sync = NULL;
     mega_ext->syncs_received = FALSE;
+    mega_ext->batch_supported = -1;
 
     // ignore SIGPIPE as we most likely will write to a closed socket in mega_notify_client_read()
     signal(SIGPIPE, SIG_IGN);
@@ -373,49 +374,67 @@ static GList* mega_ext_get_file_actions(ThunarxMenuProvider* provider,
 
     GList *l, *l_out = NULL;
     int syncedFiles, syncedFolders, unsyncedFiles, unsyncedFolders;
+    guint num_files, query_count, i;
+    gchar** paths;
+    const gchar** query_paths;
+    FileState* states;
+    FileState* query_states;
+    guint* query_index;
     gchar* out = NULL;
 
     g_debug("mega_ext_get_file_items: %u", g_list_length(files));
 
     syncedFiles = syncedFolders = unsyncedFiles = unsyncedFolders = 0;
 
-    // get list of selected objects
-    for (l = files; l != NULL; l = l->next)
+    // get the state of the selected objects, with a single request when possible
+    num_files = g_list_length(files);
+    paths = g_new0(gchar*, num_files);
+    states = g_new(FileState, num_files);
+    query_paths = g_new(const gchar*, num_files);
+    query_states = g_new(FileState, num_files);
+    query_index = g_new(guint, num_files);
+    query_count = 0;
+
+    for (l = files, i = 0; l != NULL; l = l->next, i++)
     {
         ThunarxFileInfo* file = THUNARX_FILE_INFO(l->data);
-        gchar* path;
         GFile* fp;
-        FileState state = RESPONSE_ERROR;
 
         fp = thunarx_file_info_get_location(file);
-        if (!fp)
+        if (fp)
         {
-            continue;
+            paths[i] = g_file_get_path(fp);
+            g_object_unref(fp);
         }
 
-        path = g_file_get_path(fp);
-        if (!path)
+        if (!paths[i])
         {
-            continue;
+            states[i] = RESPONSE_ERROR;
         }
-
         // avoid sending requests for files which are not in synced folders
         // but make sure we received the list of synced folders first
-        if (mega_ext->syncs_received && !mega_ext_path_in_sync(mega_ext, path))
+        else if (mega_ext->syncs_received && !mega_ext_path_in_sync(mega_ext, paths[i]))
         {
-            state = RESPONSE_DEFAULT;
+            states[i] = RESPONSE_DEFAULT;
         }
         else
         {
-            state = mega_ext_client_get_path_state(mega_ext, path, 1);
-            if (state == RESPONSE_DEFAULT)
-            {
-                char canonical[PATH_MAX];
-                expanselocalpath(path, canonical);
-                state = mega_ext_client_get_path_state(mega_ext, canonical, 1);
-            }
+            query_index[query_count] = i;
+            query_paths[query_count++] = paths[i];
         }
-        g_free(path);
+    }
+
+    mega_ext_client_get_path_states(mega_ext, query_paths, query_count, 1, query_states);
+    for (i = 0; i < query_count; i++)
+    {
+        states[query_index[i]] = query_states[i];
+    }
+
+    // get list of selected objects
+    for (l = files, i = 0; l != NULL; l = l->next, i++)
+    {
+        ThunarxFileInfo* file = THUNARX_FILE_INFO(l->data);
+        FileState state = states[i];
 
         if (state == RESPONSE_ERROR)
         {
@@ -453,6 +472,17 @@ static GList* mega_ext_get_file_actions(ThunarxMenuProvider* provider,
             }
         }
     }
+
+    for (i = 0; i < num_files; i++)
+    {
+        g_free(paths[i]);
+    }
+    g_free(paths);
+    g_free(states);
+    g_free(query_paths);
+    g_free(query_states);
+    g_free(query_index);
+
     // if there any unsynced files / folders selected
     if (unsyncedFiles || unsyncedFolders)
     {
@@ -31,6 +31,7 @@ struct _MEGAExt
     int notify_sock;
     gint num_retries; // reconnection retries
     gboolean syncs_received; // TRUE if the list with sync folders is received
+    gint batch_supported; // 1 if the server answers batched path state requests, -1 if unknown
 
     GHashTable *h_syncs; // table of paths of shared folders
     gchar *string_upload; // cached string
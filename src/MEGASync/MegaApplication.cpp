@@ -462,6 +462,9 @@ void MegaApplication::initialize()
     connect(preferences.get(), SIGNAL(updated(int)), this, SLOT(showUpdatedMessage(int)),
             Qt::DirectConnection); // Use direct connection to make sure 'updated' and 'prevVersions' are set as needed
     preferences->initialize(dataPath);
+    logger->setFileLogLevel(preferences->getFileLogLevel());
+    logger->setFlightRecorderSize(
+        static_cast<size_t>(qMax(0, preferences->getFlightRecorderSizeMB())) * 1024 * 1024);
 
     // Apply specific rcc files depending on selected theme
     initStyleAndResources();
@@ -2254,6 +2257,7 @@ void MegaApplication::cleanAll()
     // their deletion
     // Besides that, do not set any preference setting after this line, it won´t be persistent.
     QApplication::processEvents();
+    preferences->flushNow();
 
     QTMegaApiManager::removeMegaApis();
 
@@ -52,6 +52,11 @@ void BugReportController::attachLogToReport(bool state)
     mData.mAttachLog = state;
 }
 
+void BugReportController::setLogTimeWindow(const QDateTime& since)
+{
+    mData.mLogSince = since;
+}
+
 void BugReportController::setReportDescription(const QString& text)
 {
     mData.mReportDescription = text;
@@ -232,7 +237,9 @@ void BugReportController::onReadyForReporting()
         // If send log file is enabled
         if (mData.getAttachLog())
         {
-            mData.mReportPath = Utilities::joinLogZipFiles(mMegaApi);
+            mData.mReportPath = Utilities::joinLogZipFiles(
+                mMegaApi,
+                mData.getLogSince().isValid() ? &mData.getLogSince() : nullptr);
             if (mData.mReportPath.isNull())
             {
                 mLogger.resumeAfterReporting();
@@ -23,6 +23,8 @@ public:
     void submitReport();
 
     void attachLogToReport(bool state);
+    // Only the log lines since this time are attached (at chunk granularity)
+    void setLogTimeWindow(const QDateTime& since);
     void setReportDescription(const QString& text);
     void setReportTitle(const QString& text);
 
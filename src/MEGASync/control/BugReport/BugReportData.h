@@ -3,6 +3,7 @@
 
 #include "megaapi.h"
 
+#include <QDateTime>
 #include <QFileInfo>
 #include <QString>
 
@@ -81,6 +82,12 @@ public:
         return mAttachLog;
     }
 
+    // Invalid when the whole log is attached
+    const QDateTime& getLogSince() const
+    {
+        return mLogSince;
+    }
+
     int getTransferError() const
     {
         return mTransferError;
@@ -125,6 +132,7 @@ private:
     STATUS mStatus = STATUS::STOPPED;
 
     bool mAttachLog = false;
+    QDateTime mLogSince;
 
     int mTransferError = mega::MegaError::API_OK;
     int mRequestError = mega::MegaError::API_OK;
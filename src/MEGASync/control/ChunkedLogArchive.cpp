@@ -0,0 +1,366 @@
+#include "ChunkedLogArchive.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <vector>
+#include <zlib.h>
+
+namespace
+{
+// Same header as gzjoin: deflate, no name, no time, unknown OS
+const char GZIP_HEADER[] = "\x1f\x8b\x08\0\0\0\0\0\0\xff";
+constexpr int GZIP_HEADER_SIZE = 10;
+// Empty final block with fixed Huffman codes
+const char GZIP_LAST_BLOCK[] = "\x03\0";
+constexpr int GZIP_LAST_BLOCK_SIZE = 2;
+
+const QString INDEX_SUFFIX = QString::fromLatin1(".index");
+const QString INDEX_HEADER = QString::fromLatin1("MEGAsync log index 1");
+
+// "MM/DD-hh:mm:ss.uuuuuu"
+constexpr int LINE_TIME_SIZE = 21;
+
+void put4(unsigned long value, char* out)
+{
+    out[0] = static_cast<char>(value & 0xff);
+    out[1] = static_cast<char>((value >> 8) & 0xff);
+    out[2] = static_cast<char>((value >> 16) & 0xff);
+    out[3] = static_cast<char>((value >> 24) & 0xff);
+}
+
+bool readDigits(const char* text, int count, int& value)
+{
+    value = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (text[i] < '0' || text[i] > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+}
+
+bool ChunkedLogArchive::compress(const QString& logPath, const QString& archivePath)
+{
+    QFile input(logPath);
+    QFile output(archivePath);
+    if (!input.open(QIODevice::ReadOnly) || !output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    QFile::remove(indexPath(archivePath));
+
+    const auto reference(QDateTime::currentDateTimeUtc());
+    const auto workers(std::max(1, QThread::idealThreadCount()));
+
+    QVector<Chunk> chunks;
+    auto crc(crc32(0L, Z_NULL, 0));
+    unsigned long total(0);
+    qint64 lastTime(0);
+    bool ok(output.write(GZIP_HEADER, GZIP_HEADER_SIZE) == GZIP_HEADER_SIZE);
+
+    // Bytes read after the last complete line
+    QByteArray pending;
+    while (ok)
+    {
+        // Read enough lines for a chunk per worker
+        QByteArray data(pending);
+        data.append(input.read(CHUNK_SIZE * workers));
+        pending.clear();
+        if (data.isEmpty())
+        {
+            break;
+        }
+
+        // The last line may continue in the next read
+        if (!input.atEnd())
+        {
+            auto lineEnd(data.lastIndexOf('\n'));
+            if (lineEnd >= 0)
+            {
+                pending = data.mid(lineEnd + 1);
+                data.truncate(lineEnd + 1);
+            }
+        }
+
+        std::vector<std::future<CompressedChunk>> results;
+        for (int start = 0; start < data.size();)
+        {
+            // Chunks end with whole lines, unless a line is longer than a chunk
+            int end(std::min(data.size(), start + static_cast<int>(CHUNK_SIZE)));
+            if (end < data.size())
+            {
+                auto lineEnd(data.lastIndexOf('\n', end - 1));
+                if (lineEnd >= start)
+                {
+                    end = lineEnd + 1;
+                }
+            }
+
+            auto lines(data.mid(start, end - start));
+            results.push_back(std::async(std::launch::async, [lines, reference]() {
+                return compressChunk(lines, reference);
+            }));
+            start = end;
+        }
+
+        for (auto& result : results)
+        {
+            auto compressed(result.get());
+            if (!ok || !compressed.ok)
+            {
+                ok = false;
+                continue;
+            }
+
+            auto chunk(compressed.chunk);
+            chunk.offset = output.pos();
+            chunk.compressedSize = compressed.data.size();
+
+            // Chunks without timestamps are considered to be at the time of the previous one
+            if (chunk.firstTime < 0)
+            {
+                chunk.firstTime = chunk.lastTime = lastTime;
+            }
+            lastTime = chunk.lastTime;
+
+            crc = crc32_combine(crc, chunk.crc, static_cast<z_off_t>(chunk.size));
+            total += static_cast<unsigned long>(chunk.size);
+            ok = output.write(compressed.data) == compressed.data.size();
+            chunks.append(chunk);
+        }
+    }
+
+    if (ok)
+    {
+        char trailer[GZIP_LAST_BLOCK_SIZE + 8];
+        memcpy(trailer, GZIP_LAST_BLOCK, GZIP_LAST_BLOCK_SIZE);
+        put4(crc, trailer + GZIP_LAST_BLOCK_SIZE);
+        put4(total, trailer + GZIP_LAST_BLOCK_SIZE + 4);
+        ok = output.write(trailer, sizeof(trailer)) == sizeof(trailer);
+    }
+
+    output.close();
+    ok = ok && output.error() == QFileDevice::NoError && writeIndex(archivePath, chunks);
+    if (!ok)
+    {
+        QFile::remove(indexPath(archivePath));
+    }
+    return ok;
+}
+
+QString ChunkedLogArchive::indexPath(const QString& archivePath)
+{
+    return archivePath + INDEX_SUFFIX;
+}
+
+bool ChunkedLogArchive::readIndex(const QString& archivePath, QVector<Chunk>& chunks)
+{
+    chunks.clear();
+
+    QFile file(indexPath(archivePath));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    QTextStream stream(&file);
+    if (stream.readLine() != INDEX_HEADER)
+    {
+        return false;
+    }
+
+    while (!stream.atEnd())
+    {
+        auto line(stream.readLine());
+        if (line.isEmpty())
+        {
+            continue;
+        }
+
+        auto values(line.split(QLatin1Char(' ')));
+        if (values.size() != 6)
+        {
+            chunks.clear();
+            return false;
+        }
+
+        Chunk chunk;
+        bool ok[6];
+        chunk.firstTime = values[0].toLongLong(&ok[0]);
+        chunk.lastTime = values[1].toLongLong(&ok[1]);
+        chunk.offset = values[2].toLongLong(&ok[2]);
+        chunk.compressedSize = values[3].toLongLong(&ok[3]);
+        chunk.size = values[4].toLongLong(&ok[4]);
+        chunk.crc = values[5].toUInt(&ok[5]);
+        if (std::find(std::begin(ok), std::end(ok), false) != std::end(ok))
+        {
+            chunks.clear();
+            return false;
+        }
+        chunks.append(chunk);
+    }
+
+    return true;
+}
+
+QVector<ChunkedLogArchive::Chunk> ChunkedLogArchive::chunksSince(const QVector<Chunk>& chunks,
+                                                                 const QDateTime& since)
+{
+    const auto sinceTime(since.toMSecsSinceEpoch());
+
+    // The chunks are in time order: keep from the first one that ends after since
+    auto first(std::find_if(chunks.cbegin(), chunks.cend(), [sinceTime](const Chunk& chunk) {
+        return chunk.lastTime >= sinceTime;
+    }));
+
+    QVector<Chunk> selected;
+    std::copy(first, chunks.cend(), std::back_inserter(selected));
+    return selected;
+}
+
+bool ChunkedLogArchive::copyChunks(const QString& archivePath,
+                                   const QVector<Chunk>& chunks,
+                                   FILE* out,
+                                   unsigned long* crc,
+                                   unsigned long* tot)
+{
+    QFile archive(archivePath);
+    if (!archive.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    for (const auto& chunk : chunks)
+    {
+        if (!archive.seek(chunk.offset))
+        {
+            return false;
+        }
+
+        auto data(archive.read(chunk.compressedSize));
+        if (data.size() != chunk.compressedSize ||
+            fwrite(data.constData(), 1, static_cast<size_t>(data.size()), out) != static_cast<size_t>(data.size()))
+        {
+            return false;
+        }
+
+        *crc = crc32_combine(*crc, chunk.crc, static_cast<z_off_t>(chunk.size));
+        *tot += static_cast<unsigned long>(chunk.size);
+    }
+
+    return true;
+}
+
+void ChunkedLogArchive::finish(FILE* out, unsigned long crc, unsigned long tot)
+{
+    char trailer[GZIP_LAST_BLOCK_SIZE + 8];
+    memcpy(trailer, GZIP_LAST_BLOCK, GZIP_LAST_BLOCK_SIZE);
+    put4(crc, trailer + GZIP_LAST_BLOCK_SIZE);
+    put4(tot, trailer + GZIP_LAST_BLOCK_SIZE + 4);
+    fwrite(trailer, 1, sizeof(trailer), out);
+}
+
+qint64 ChunkedLogArchive::lineTime(const char* line, int size, const QDateTime& reference)
+{
+    int month, day, hour, minute, second, microsecond;
+    if (size < LINE_TIME_SIZE || line[2] != '/' || line[5] != '-' || line[8] != ':' ||
+        line[11] != ':' || line[14] != '.' || !readDigits(line, 2, month) ||
+        !readDigits(line + 3, 2, day) || !readDigits(line + 6, 2, hour) ||
+        !readDigits(line + 9, 2, minute) || !readDigits(line + 12, 2, second) ||
+        !readDigits(line + 15, 6, microsecond))
+    {
+        return -1;
+    }
+
+    QTime time(hour, minute, second, microsecond / 1000);
+    QDate date(reference.date().year(), month, day);
+    QDateTime dateTime(date, time, Qt::UTC);
+    // Lines of the end of the previous year, or a day ahead because of clock adjustments
+    if (!date.isValid() || dateTime > reference.addDays(1))
+    {
+        dateTime = QDateTime(QDate(reference.date().year() - 1, month, day), time, Qt::UTC);
+    }
+
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : -1;
+}
+
+ChunkedLogArchive::CompressedChunk ChunkedLogArchive::compressChunk(const QByteArray& lines,
+                                                                    const QDateTime& reference)
+{
+    CompressedChunk result;
+    result.chunk.size = lines.size();
+    result.chunk.crc = static_cast<quint32>(
+        crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(lines.constData()), static_cast<uInt>(lines.size())));
+
+    // The first and the last lines with timestamp
+    result.chunk.firstTime = result.chunk.lastTime = -1;
+    for (int start = 0; start < lines.size() && result.chunk.firstTime < 0;)
+    {
+        auto end(lines.indexOf('\n', start));
+        end = end < 0 ? lines.size() : end;
+        result.chunk.firstTime = lineTime(lines.constData() + start, end - start, reference);
+        start = end + 1;
+    }
+    for (int end = lines.size(); end > 0 && result.chunk.lastTime < 0;)
+    {
+        if (lines.at(end - 1) == '\n')
+        {
+            --end;
+        }
+        auto start(lines.lastIndexOf('\n', end - 1) + 1);
+        result.chunk.lastTime = lineTime(lines.constData() + start, end - start, reference);
+        end = start;
+    }
+
+    // Raw deflate, so the chunk can be copied into any gzip stream
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return result;
+    }
+
+    // The bound does not include the sync flush marker
+    result.data.resize(static_cast<int>(deflateBound(&stream, static_cast<uLong>(lines.size()))) + 16);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(lines.constData()));
+    stream.avail_in = static_cast<uInt>(lines.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result.data.data());
+    stream.avail_out = static_cast<uInt>(result.data.size());
+
+    // A sync flush ends the data on a byte boundary, without marking the last block
+    auto status(deflate(&stream, Z_SYNC_FLUSH));
+    result.ok = status == Z_OK && stream.avail_in == 0 && stream.avail_out > 0;
+    result.data.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+
+    return result;
+}
+
+bool ChunkedLogArchive::writeIndex(const QString& archivePath, const QVector<Chunk>& chunks)
+{
+    QFile file(indexPath(archivePath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << INDEX_HEADER << '\n';
+    for (const auto& chunk : chunks)
+    {
+        stream << chunk.firstTime << ' ' << chunk.lastTime << ' ' << chunk.offset << ' '
+               << chunk.compressedSize << ' ' << chunk.size << ' ' << chunk.crc << '\n';
+    }
+    stream.flush();
+
+    return stream.status() == QTextStream::Ok && file.error() == QFileDevice::NoError;
+}
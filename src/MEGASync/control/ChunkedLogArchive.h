@@ -0,0 +1,65 @@
+#ifndef CHUNKED_LOG_ARCHIVE_H
+#define CHUNKED_LOG_ARCHIVE_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+#include <cstdio>
+
+/// Responsability: writes the rotated logs as gzip files made of independent chunks, and copies a
+/// time window of them into another gzip file without decompressing anything.
+/// Every chunk (about CHUNK_SIZE bytes of whole lines) is compressed on its own, as raw deflate
+/// data ended with a sync flush, so the chunks are compressed in parallel and end on a byte
+/// boundary. The archive is still a regular gzip file. A sidecar index (indexPath) keeps the time
+/// range, position, sizes and crc of every chunk.
+class ChunkedLogArchive
+{
+public:
+    struct Chunk
+    {
+        // Milliseconds since epoch (UTC) of the first and last lines with a timestamp
+        qint64 firstTime = 0;
+        qint64 lastTime = 0;
+        qint64 offset = 0;
+        qint64 compressedSize = 0;
+        qint64 size = 0;
+        quint32 crc = 0;
+    };
+
+    static constexpr qint64 CHUNK_SIZE = 256 * 1024;
+
+    static bool compress(const QString& logPath, const QString& archivePath);
+
+    static QString indexPath(const QString& archivePath);
+    // False for archives without index, like the ones written by previous versions
+    static bool readIndex(const QString& archivePath, QVector<Chunk>& chunks);
+    static QVector<Chunk> chunksSince(const QVector<Chunk>& chunks, const QDateTime& since);
+
+    // Appends the chunks to a gzip stream whose data ends on a byte boundary, and updates the crc
+    // and the length (modulo 2^32) of its trailer
+    static bool copyChunks(const QString& archivePath,
+                           const QVector<Chunk>& chunks,
+                           FILE* out,
+                           unsigned long* crc,
+                           unsigned long* tot);
+    // Writes the last block and the trailer of a gzip stream whose data ends on a byte boundary
+    static void finish(FILE* out, unsigned long crc, unsigned long tot);
+
+    // Time of a log line ("MM/DD-hh:mm:ss.uuuuuu "), which has no year: the one that puts the
+    // line closest before reference is used. Returns -1 for lines without timestamp
+    static qint64 lineTime(const char* line, int size, const QDateTime& reference);
+
+private:
+    struct CompressedChunk
+    {
+        Chunk chunk;
+        QByteArray data;
+        bool ok = false;
+    };
+
+    static CompressedChunk compressChunk(const QByteArray& lines, const QDateTime& reference);
+    static bool writeIndex(const QString& archivePath, const QVector<Chunk>& chunks);
+};
+
+#endif // CHUNKED_LOG_ARCHIVE_H
@@ -154,6 +154,8 @@ void CrashHandler::tryReboot()
     {
         MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Restarting app...");
         preferences->setLastReboot(QDateTime::currentMSecsSinceEpoch());
+        // The new instance reads it
+        preferences->flushNow();
 
 #ifndef Q_OS_MACOS
         QString app = MegaApplication::applicationFilePath();
@@ -202,6 +202,12 @@ void FatalEventHandler::processEvent(std::unique_ptr<mega::MegaEvent> event, Meg
             .toUtf8()
             .constData());
 
+    // Keep the lines that led to the error, even if they were too verbose for the log file
+    if (mLogger)
+    {
+        mLogger->dumpFlightRecorder();
+    }
+
     // Explicitly do nothing more for MegaEvent::REASON_ERROR_NO_ERROR
     if (mErrorCode == FatalErrorCode::ERR_NO_ERROR)
     {
@@ -6,6 +6,8 @@
 #include "StatsEventHandler.h"
 #include "Utilities.h"
 
+#include <QJsonArray>
+#include <QJsonDocument>
 #include <QtConcurrent/QtConcurrent>
 
 #include <algorithm>
@@ -19,6 +21,31 @@ bool ts_comparator(RequestData* i, RequestData *j)
     return i->tsStart < j->tsStart;
 }
 
+namespace
+{
+// Missing or mistyped fields are empty, like the ones of Utilities::extractJSONString
+QString jsonString(const QJsonObject& json, const char* name)
+{
+    return json.value(QLatin1String(name)).toString();
+}
+
+long long jsonNumber(const QJsonObject& json, const char* name)
+{
+    return static_cast<long long>(json.value(QLatin1String(name)).toDouble());
+}
+
+QStringList jsonStringList(const QJsonObject& json, const char* name)
+{
+    QStringList strings;
+    const auto values = json.value(QLatin1String(name)).toArray();
+    for (const auto& value : values)
+    {
+        strings.append(value.toString());
+    }
+    return strings;
+}
+}
+
 RequestData::RequestData()
 {
     files = -1;
@@ -39,9 +66,16 @@ RequestTransferData::RequestTransferData()
     tPath = QString();
 }
 
+TransferProgressWatch::TransferProgressWatch()
+{
+    intervalMs = Preferences::defaultWebclientProgressPushIntervalMs;
+    lastPushMs = 0;
+}
+
 bool HTTPServer::isFirstWebDownloadDone = false;
 QMultiMap<QString, RequestData*> HTTPServer::webDataRequests;
 QMap<mega::MegaHandle, RequestTransferData*> HTTPServer::webTransferStateRequests;
+QSet<mega::MegaHandle> HTTPServer::updatedTransfers;
 
 HTTPServer::HTTPServer(MegaApi *megaApi, quint16 port)
     : QTcpServer(), disabled(false)
@@ -51,6 +85,10 @@ HTTPServer::HTTPServer(MegaApi *megaApi, quint16 port)
 
     connect(&mVersionCommandWatcher, &QFutureWatcher<VersionCommandAnswer>::finished,
             this, &HTTPServer::onVersionCommandFinished);
+
+    // The watches are pushed at their own interval, checked at the shortest one allowed
+    mProgressPushTimer.setInterval(Preferences::minWebclientProgressPushIntervalMs);
+    connect(&mProgressPushTimer, &QTimer::timeout, this, &HTTPServer::onProgressPushTimeout);
 }
 
 HTTPServer::~HTTPServer()
@@ -79,6 +117,12 @@ void HTTPServer::incomingConnection(qintptr socket)
 void HTTPServer::pause()
 {
     disabled = true;
+
+    const auto sockets = mProgressWatches.keys();
+    for (auto socket : sockets)
+    {
+        stopTransferProgressWatch(socket);
+    }
 }
 
 void HTTPServer::resume()
@@ -111,6 +155,7 @@ void HTTPServer::checkAndPurgeRequests()
              || transferData->state == MegaTransfer::STATE_FAILED)
                 && (((QDateTime::currentMSecsSinceEpoch() / 1000) - transferData->tsEnd) > MAX_REQUEST_TIME_SECS))
         {
+            updatedTransfers.remove(it.key());
             webTransferStateRequests.erase(it++);
             delete transferData;
         }
@@ -179,12 +224,22 @@ void HTTPServer::onTransferDataUpdate(MegaHandle handle, int state, long long pr
     {
         tData->tsEnd = QDateTime::currentMSecsSinceEpoch() / 1000;
     }
+
+    // Pushed to the watches on the next tick of the timer, so they are throttled
+    updatedTransfers.insert(handle);
 }
 
 void HTTPServer::readClient()
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Processing webclient request via HTTP").toUtf8().constData());
     QAbstractSocket *socket = (QAbstractSocket*)sender();
+    if (mProgressWatches.contains(socket))
+    {
+        // The request of a watch is already processed
+        socket->readAll();
+        return;
+    }
+
     HTTPRequest *request = requests.value(socket);
     if (disabled || !request)
     {
@@ -193,12 +248,21 @@ void HTTPServer::readClient()
         return;
     }
 
-    QByteArray socketData = socket->readAll();
-    request->data.append(QString::fromUtf8(socketData.data()));
-    if (request->data.contains(QString::fromUtf8("\r\n\r\n")))
+    // The bytes are kept as received, only the end of the headers is searched on every read
+    request->buffer.append(socket->readAll());
+    if (request->bodyStart < 0)
     {
-        QStringList tokens = request->data.split(QString::fromUtf8("\r\n\r\n"));
-        QStringList headers = tokens[0].split(QString::fromUtf8("\r\n"));
+        int headersEnd = request->buffer.indexOf("\r\n\r\n", request->scanPos);
+        if (headersEnd < 0)
+        {
+            // The separator may be split between two reads
+            request->scanPos = std::max(0, request->buffer.size() - 3);
+            return;
+        }
+        request->bodyStart = headersEnd + 4;
+
+        QStringList headers = QString::fromUtf8(request->buffer.constData(), headersEnd)
+                                  .split(QString::fromUtf8("\r\n"));
         bool requestIsPost = isRequestOfType(headers, "POST");
         bool requestIsOption = isRequestOfType(headers, "OPTION");
 
@@ -224,21 +288,31 @@ void HTTPServer::readClient()
             }
         }
 
-        if (requestIsPost)
+        if (requestIsOption)
         {
-            processPostRequest(socket, request, headers, tokens[1]);
+            processOptionRequest(socket, request, headers);
+            return;
         }
-        else // requestIsOption
+
+        if (!readContentLength(socket, request, headers))
         {
-            processOptionRequest(socket, request, headers);
+            return;
         }
     }
+
+    processPostRequest(socket, request);
 }
 void HTTPServer::discardClient()
 {
     QAbstractSocket* socket = (QSslSocket*)sender();
     socket->deleteLater();
 
+    if (mProgressWatches.remove(socket) && mProgressWatches.isEmpty())
+    {
+        mProgressPushTimer.stop();
+        updatedTransfers.clear();
+    }
+
     HTTPRequest *request = requests.value(socket);
     if (request)
     {
@@ -311,6 +385,13 @@ void HTTPServer::processRequest(QPointer<QAbstractSocket> socket, HTTPRequest re
     case EXTERNAL_TRANSFER_QUERY_PROGRESS_START:
         externalTransferQueryProgress(response, request);
         break;
+    case EXTERNAL_TRANSFER_QUERY_PROGRESS_BATCH_START:
+        externalTransferQueryProgressBatch(response, request);
+        break;
+    case EXTERNAL_TRANSFER_WATCH_PROGRESS_START:
+        //The response is streamed until the transfers finish, this is why the case is broken
+        externalTransferWatchProgress(request, socket);
+        return;
     case EXTERNAL_SHOW_IN_FOLDER:
         externalShowInFolder(response, request);
         break;
@@ -397,9 +478,9 @@ void HTTPServer::onVersionCommandFinished()
 void HTTPServer::openLinkRequest(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "OpenLink command received from the webclient");
-    QString handle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
-    QString key = Utilities::extractJSONString(request.data, QString::fromUtf8("k"));
-    QString auth = Utilities::extractJSONString(request.data, QString::fromUtf8("esid"));
+    QString handle = jsonString(request.json, "h");
+    QString key = jsonString(request.json, "k");
+    QString auth = jsonString(request.json, "esid");
 
     if (key.size() > 43)
     {
@@ -445,16 +526,16 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
     QPointer<HTTPServer> safeServer = this;
 
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "ExternalDownload command received from the webclient");
-    int start = request.data.indexOf(QString::fromUtf8("\"f\":[")) + 5;
-    if (start > 0)
+    const QJsonValue files = request.json.value(QLatin1String("f"));
+    if (files.isArray())
     {
-        QString privateAuth = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("esid"));
-        QString publicAuth  = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("en"));
-        QString chatAuth    = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("cauth"));
+        QString privateAuth = jsonString(request.json, "esid");
+        QString publicAuth  = jsonString(request.json, "en");
+        QString chatAuth    = jsonString(request.json, "cauth");
 
         if (privateAuth.isEmpty() && publicAuth.isEmpty())
         {
-            QString auth  = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("auth"));
+            QString auth  = jsonString(request.json, "auth");
             if (auth.length() == 8)
             {
                 publicAuth = auth;
@@ -469,24 +550,21 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
         {
             QQueue<WrappedNode> downloadQueue;
 
-            int end;
             bool firstnode = true;
 
-            while (request.data[start] == QChar::fromLatin1('{'))
+            const QJsonArray fileArray = files.toArray();
+            for (const auto& fileValue : fileArray)
             {
-                end = request.data.indexOf(QChar::fromLatin1('}'), start);
-                if (end < 0)
+                if (!fileValue.isObject())
                 {
                     MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Error parsing webclient request");
                     downloadQueue.clear();
                     break;
                 }
 
-                end++;
-                QString file = request.data.mid(start, end - start);
-                start = end + 1;
+                const QJsonObject file = fileValue.toObject();
 
-                long long type = Utilities::extractJSONNumber(file, QString::fromUtf8("t"));
+                long long type = jsonNumber(file, "t");
                 if (type < 0)
                 {
                     MegaApi::log(MegaApi::LOG_LEVEL_ERROR,
@@ -495,7 +573,7 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                     break;
                 }
 
-                QString handle = Utilities::extractJSONString(file, QString::fromUtf8("h"));
+                QString handle = jsonString(file, "h");
                 if (handle.isEmpty())
                 {
                     MegaApi::log(MegaApi::LOG_LEVEL_ERROR,
@@ -504,7 +582,7 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                     break;
                 }
 
-                QString name = Utilities::extractJSONString(file, QString::fromUtf8("n"));
+                QString name = jsonString(file, "n");
                 name.replace(QString::fromUtf8("-"), QString::fromUtf8("+"));
                 name.replace(QString::fromUtf8("_"), QString::fromUtf8("/"));
                 name = QString::fromUtf8(QByteArray::fromBase64(name.toUtf8().constData()).constData());
@@ -521,7 +599,7 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
 
                 if (!firstnode)
                 {
-                    QString parentHandle = Utilities::extractJSONString(file, QString::fromUtf8("p"));
+                    QString parentHandle = jsonString(file, "p");
                     p = megaApi->base64ToHandle(parentHandle.toUtf8().constData());
                     QApplication::processEvents();
                     if (!safeServer || !safeSocket)
@@ -548,14 +626,14 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                 }
                 else
                 {
-                    QString key = Utilities::extractJSONString(file, QString::fromUtf8("k"));
+                    QString key = jsonString(file, "k");
                     if (key.size() == 43)
                     {
                         const QByteArray keyArray = key.toUtf8();
-                        long long size = Utilities::extractJSONNumber(file, QString::fromUtf8("s"));
-                        long long mtime = Utilities::extractJSONNumber(file, QString::fromUtf8("ts"));
+                        long long size = jsonNumber(file, "s");
+                        long long mtime = jsonNumber(file, "ts");
 
-                        QString crc    = Utilities::extractJSONString(file, QString::fromUtf8("c"));
+                        QString crc    = jsonString(file, "c");
                         const QByteArray crcArray = crc.toUtf8();
 
                         const QByteArray chatAuthArray = chatAuth.toUtf8();
@@ -603,8 +681,8 @@ void HTTPServer::externalDownloadSetRequest(QString &response, const HTTPRequest
     //!     'auth' contains set_ph (set public handle)
     //!     'k' contains public key
 
-    QString auth = Utilities::extractJSONString(request.data, QLatin1String("auth"));
-    QString k = Utilities::extractJSONString(request.data, QLatin1String("k"));
+    QString auth = jsonString(request.json, "auth");
+    QString k = jsonString(request.json, "k");
     if (auth.isEmpty() || k.isEmpty())
     {
         response = QString::number(MegaError::API_EARGS);
@@ -614,7 +692,7 @@ void HTTPServer::externalDownloadSetRequest(QString &response, const HTTPRequest
     auto publicLink = ServiceUrls::instance()->getRemoteSetLinkUrl(auth, k).toString();
 
     // Get Element IDs
-    const auto e = Utilities::extractJSONStringList(request.data, QLatin1String("e"));
+    const auto e = jsonStringList(request.json, "e");
 
     QList<mega::MegaHandle> handleList;
     for (const auto& eId: e)
@@ -635,7 +713,7 @@ void HTTPServer::externalDownloadSetRequest(QString &response, const HTTPRequest
 void HTTPServer::externalFileUploadRequest(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "UploadFile command received from the webclient");
-    QString targetHandle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
+    QString targetHandle = jsonString(request.json, "h");
     MegaHandle handle = ::mega::INVALID_HANDLE;
     if (targetHandle.size())
     {
@@ -650,7 +728,7 @@ void HTTPServer::externalFileUploadRequest(QString &response, const HTTPRequest&
     else
     {
         delete targetNode;
-        QString bid = Utilities::extractJSONString(request.data, QString::fromUtf8("bid"));
+        QString bid = jsonString(request.json, "bid");
         if (!bid.isEmpty())
         {
             webDataRequests.insert(bid, new RequestData());
@@ -667,7 +745,7 @@ void HTTPServer::externalFileUploadRequest(QString &response, const HTTPRequest&
 void HTTPServer::externalFileFolderUploadRequest(QString& response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Files and folders command received from the webclient");
-    QString targetHandle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
+    QString targetHandle = jsonString(request.json, "h");
     MegaHandle handle = ::mega::INVALID_HANDLE;
     if (targetHandle.size())
     {
@@ -682,7 +760,7 @@ void HTTPServer::externalFileFolderUploadRequest(QString& response, const HTTPRe
     else
     {
         delete targetNode;
-        QString bid = Utilities::extractJSONString(request.data, QString::fromUtf8("bid"));
+        QString bid = jsonString(request.json, "bid");
         if (!bid.isEmpty())
         {
             webDataRequests.insert(bid, new RequestData());
@@ -699,7 +777,7 @@ void HTTPServer::externalFileFolderUploadRequest(QString& response, const HTTPRe
 void HTTPServer::externalFolderUploadRequest(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "UploadFolder command received from the webclient");
-    QString targetHandle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
+    QString targetHandle = jsonString(request.json, "h");
     MegaHandle handle = ::mega::INVALID_HANDLE;
     if (targetHandle.size())
     {
@@ -714,7 +792,7 @@ void HTTPServer::externalFolderUploadRequest(QString &response, const HTTPReques
     else
     {
         delete targetNode;
-        QString bid = Utilities::extractJSONString(request.data, QString::fromUtf8("bid"));
+        QString bid = jsonString(request.json, "bid");
         if (!bid.isEmpty())
         {
             webDataRequests.insert(bid, new RequestData());
@@ -731,12 +809,12 @@ void HTTPServer::externalFolderUploadRequest(QString &response, const HTTPReques
 void HTTPServer::externalFolderSyncRequest(QString& response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Sync command received from the webclient");
-    const QString userString = Utilities::extractJSONString(request.data, QLatin1String("u"));
+    const QString userString = jsonString(request.json, "u");
     MegaHandle userHandle = userString.size() ?
                                 MegaApi::base64ToUserHandle(userString.toLatin1().constData()) :
                                 INVALID_HANDLE;
 
-    QString targetHandle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
+    QString targetHandle = jsonString(request.json, "h");
     MegaHandle handle = ::mega::INVALID_HANDLE;
     if (targetHandle.size())
     {
@@ -768,7 +846,7 @@ void HTTPServer::externalFolderSyncRequest(QString& response, const HTTPRequest&
 void HTTPServer::externalFolderSyncCheck(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Check sync folder command received from the webclient");
-    QString targetHandle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
+    QString targetHandle = jsonString(request.json, "h");
     MegaHandle handle = ::mega::INVALID_HANDLE;
     if (targetHandle.size())
     {
@@ -803,7 +881,7 @@ void HTTPServer::externalFolderSyncCheck(QString &response, const HTTPRequest& r
 void HTTPServer::externalOpenTransferManager(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Open Transfer Manager command received from the webclient");
-    int tab = static_cast<int>(Utilities::extractJSONNumber(request.data, QString::fromUtf8("t")));
+    int tab = static_cast<int>(jsonNumber(request.json, "t"));
     if (tab < 0 || tab > 3) //Not valid number tab (all, downloads, uploads, completed)
     {
         response = QString::number(MegaError::API_EARGS);
@@ -818,7 +896,7 @@ void HTTPServer::externalOpenTransferManager(QString &response, const HTTPReques
 void HTTPServer::externalUploadSelectionStatus(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Upload selection status command received from the webclient");
-    QString bid = Utilities::extractJSONString(request.data, QString::fromUtf8("bid"));
+    QString bid = jsonString(request.json, "bid");
     if (!bid.isEmpty())
     {
         QList<RequestData*> values = webDataRequests.values(bid);
@@ -858,7 +936,7 @@ void HTTPServer::externalUploadSelectionStatus(QString &response, const HTTPRequ
 
 void HTTPServer::externalTransferQueryProgress(QString &response, const HTTPRequest& request)
 {
-    QString targetHandle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
+    QString targetHandle = jsonString(request.json, "h");
     MegaHandle handle = mega::INVALID_HANDLE;
     if (targetHandle.size())
     {
@@ -871,33 +949,180 @@ void HTTPServer::externalTransferQueryProgress(QString &response, const HTTPRequ
     }
     else
     {
-        if (!webTransferStateRequests.contains(handle))
-        {
-            response = QString::number(MegaError::API_ENOENT);
-        }
-        else
+        response = transferProgressJson(handle);
+    }
+}
+
+void HTTPServer::externalTransferQueryProgressBatch(QString& response, const HTTPRequest& request)
+{
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Batched transfer progress query received from the webclient");
+    auto handles = extractTransferHandles(request);
+    if (handles.isEmpty())
+    {
+        response = QString::number(MegaError::API_EARGS);
+        return;
+    }
+
+    QStringList progress;
+    for (auto it = handles.cbegin(); it != handles.cend(); ++it)
+    {
+        progress.append(QString::fromUtf8("\"%1\":%2").arg(it.value(), transferProgressJson(it.key())));
+    }
+    response = QString::fromUtf8("{%1}").arg(progress.join(QLatin1Char(',')));
+}
+
+void HTTPServer::externalTransferWatchProgress(const HTTPRequest& request, QPointer<QAbstractSocket> socket)
+{
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Transfer progress watch received from the webclient");
+    TransferProgressWatch watch;
+    watch.handles = extractTransferHandles(request);
+    if (watch.handles.isEmpty())
+    {
+        endProcessRequest(socket, request, QString::number(MegaError::API_EARGS));
+        return;
+    }
+
+    if (!socket)
+    {
+        return;
+    }
+
+    auto intervalMs = jsonNumber(request.json, "i");
+    if (intervalMs > 0)
+    {
+        watch.intervalMs = static_cast<int>(std::min<long long>(
+            std::max<long long>(intervalMs, Preferences::minWebclientProgressPushIntervalMs),
+            MAX_REQUEST_TIME_SECS * 1000LL));
+    }
+
+    // Server-Sent Events, without length: the response ends when the connection is closed
+    socket->write(QString::fromUtf8("HTTP/1.0 200 Ok\r\n"
+                                    "Access-Control-Allow-Origin: %1\r\n"
+                                    "Content-Type: text/event-stream; charset=\"utf-8\"\r\n"
+                                    "Cache-Control: no-cache\r\n"
+                                    "\r\n")
+                      .arg(request.origin)
+                      .toUtf8());
+
+    auto& insertedWatch = mProgressWatches.insert(socket, watch).value();
+    pushTransferProgress(socket, insertedWatch, true);
+    if (!mProgressWatches.isEmpty() && !mProgressPushTimer.isActive())
+    {
+        mProgressPushTimer.start();
+    }
+}
+
+void HTTPServer::onProgressPushTimeout()
+{
+    for (auto handle : qAsConst(updatedTransfers))
+    {
+        for (auto& watch : mProgressWatches)
         {
-            RequestTransferData* tData = webTransferStateRequests.value(handle);
-            if (tData->state == MegaTransfer::STATE_NONE)
-            {
-                response = QString::fromUtf8("{\"s\":%1}").arg(tData->state);
-            }
-            else
+            if (watch.handles.contains(handle))
             {
-                response = QString::fromUtf8("{\"s\":%1,\"p\":%2,\"t\":%3,\"v\":%4}")
-                        .arg(tData->state)
-                        .arg(tData->progress)
-                        .arg(tData->size)
-                        .arg(tData->speed);
+                watch.pending.insert(handle);
             }
         }
     }
+    updatedTransfers.clear();
+
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    const auto sockets = mProgressWatches.keys();
+    for (auto socket : sockets)
+    {
+        auto it = mProgressWatches.find(socket);
+        if (it != mProgressWatches.end() && !it->pending.isEmpty() && now - it->lastPushMs >= it->intervalMs)
+        {
+            pushTransferProgress(socket, it.value(), false);
+        }
+    }
+}
+
+void HTTPServer::pushTransferProgress(QAbstractSocket* socket, TransferProgressWatch& watch, bool allTransfers)
+{
+    QStringList progress;
+    bool finished = true;
+    for (auto it = watch.handles.cbegin(); it != watch.handles.cend(); ++it)
+    {
+        if (allTransfers || watch.pending.contains(it.key()))
+        {
+            progress.append(QString::fromUtf8("\"%1\":%2").arg(it.value(), transferProgressJson(it.key())));
+        }
+        finished &= isTransferFinished(it.key());
+    }
+    watch.pending.clear();
+    watch.lastPushMs = QDateTime::currentMSecsSinceEpoch();
+
+    socket->write(QString::fromUtf8("data: {%1}\n\n").arg(progress.join(QLatin1Char(','))).toUtf8());
+    socket->flush();
+
+    if (finished)
+    {
+        stopTransferProgressWatch(socket);
+    }
+}
+
+void HTTPServer::stopTransferProgressWatch(QAbstractSocket* socket)
+{
+    mProgressWatches.remove(socket);
+    if (mProgressWatches.isEmpty())
+    {
+        mProgressPushTimer.stop();
+        updatedTransfers.clear();
+    }
+
+    socket->disconnectFromHost();
+    socket->deleteLater();
+}
+
+QMap<MegaHandle, QString> HTTPServer::extractTransferHandles(const HTTPRequest& request)
+{
+    QMap<MegaHandle, QString> handles;
+    const auto targetHandles = jsonStringList(request.json, "h");
+    for (const auto& targetHandle : targetHandles)
+    {
+        MegaHandle handle = MegaApi::base64ToHandle(targetHandle.toUtf8().constData());
+        if (handle == mega::INVALID_HANDLE)
+        {
+            return QMap<MegaHandle, QString>();
+        }
+        handles.insert(handle, targetHandle);
+    }
+    return handles;
+}
+
+QString HTTPServer::transferProgressJson(MegaHandle handle)
+{
+    RequestTransferData* tData = webTransferStateRequests.value(handle);
+    if (!tData)
+    {
+        return QString::number(MegaError::API_ENOENT);
+    }
+
+    if (tData->state == MegaTransfer::STATE_NONE)
+    {
+        return QString::fromUtf8("{\"s\":%1}").arg(tData->state);
+    }
+
+    return QString::fromUtf8("{\"s\":%1,\"p\":%2,\"t\":%3,\"v\":%4}")
+        .arg(tData->state)
+        .arg(tData->progress)
+        .arg(tData->size)
+        .arg(tData->speed);
+}
+
+bool HTTPServer::isTransferFinished(MegaHandle handle)
+{
+    // Unknown transfers will not be updated either
+    RequestTransferData* tData = webTransferStateRequests.value(handle);
+    return !tData || tData->state == MegaTransfer::STATE_CANCELLED ||
+           tData->state == MegaTransfer::STATE_COMPLETED || tData->state == MegaTransfer::STATE_FAILED;
 }
 
 void HTTPServer::externalShowInFolder(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Show in folder command received from the webclient");
-    QString targetHandle = Utilities::extractJSONString(request.data, QString::fromUtf8("h"));
+    QString targetHandle = jsonString(request.json, "h");
     MegaHandle handle = ::mega::INVALID_HANDLE;
     if (targetHandle.size())
     {
@@ -941,7 +1166,7 @@ void HTTPServer::externalShowInFolder(QString &response, const HTTPRequest& requ
 void HTTPServer::externalAddBackup(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Add backup command received from the webclient");
-    QString userHandle(Utilities::extractJSONString(request.data, QLatin1String("u")));
+    QString userHandle(jsonString(request.json, "u"));
     MegaHandle handle = INVALID_HANDLE;
 
     if (userHandle.size())
@@ -973,83 +1198,26 @@ void HTTPServer::externalAddBackup(QString &response, const HTTPRequest& request
 
 HTTPServer::RequestType HTTPServer::GetRequestType(const HTTPRequest &request)
 {
-    static const QString openLinkRequestStart(QLatin1String("{\"a\":\"l\","));
-    static const QString externalDownloadRequestStart(QLatin1String("{\"a\":\"d\","));
-    static const QString externalDownloadSetRequestStart(QLatin1String("{\"a\":\"ds\","));
-    static const QString externalRewindRequestStart(QLatin1String("{\"a\":\"gd\","));
-    static const QString externalFileUploadRequestStart(QLatin1String("{\"a\":\"ufi\","));
-    static const QString externalFolderUploadRequestStart(QLatin1String("{\"a\":\"ufo\","));
-    static const QString externalFileFolderUploadRequestStart(QLatin1String("{\"a\":\"uff\","));
-    static const QString externalFolderSyncRequestStart(QLatin1String("{\"a\":\"s\","));
-    static const QString externalFolderSyncCheckStart(QLatin1String("{\"a\":\"sp\","));
-    static const QString externalOpenTransferManagerStart(QLatin1String("{\"a\":\"tm\","));
-    static const QString externalUploadSelectionStatusStart(QLatin1String("{\"a\":\"uss\","));
-    static const QString externalTransferQueryProgressStart(QLatin1String("{\"a\":\"t\","));
-    static const QString externalShowInFolder(QLatin1String("{\"a\":\"sf\","));
-    static const QString versionCommand(QLatin1String("{\"a\":\"v\"}"));
-    static const QString externalAddBackup(QLatin1String("{\"a\":\"ab\",\"u\":\""));
-
-    if(request.data == versionCommand)
-    {
-        return VERSION_COMMAND;
-    }
-    else if(request.data.startsWith(openLinkRequestStart))
-    {
-        return OPEN_LINK_REQUEST_START;
-    }
-    else if(request.data.startsWith(externalDownloadRequestStart))
-    {
-        return EXTERNAL_DOWNLOAD_REQUEST_START;
-    }
-    else if(request.data.startsWith(externalDownloadSetRequestStart))
-    {
-        return EXTERNAL_DOWNLOAD_SET_REQUEST_START;
-    }
-    else if(request.data.startsWith(externalFileUploadRequestStart))
-    {
-        return EXTERNAL_FILE_UPLOAD_REQUEST_START;
-    }
-    else if (request.data.startsWith(externalFolderUploadRequestStart))
-    {
-        return EXTERNAL_FOLDER_UPLOAD_REQUEST_START;
-    }
-    else if (request.data.startsWith(externalFileFolderUploadRequestStart))
-    {
-        return EXTERNAL_FILE_FOLDER_UPLOAD_REQUEST_START;
-    }
-    else if (request.data.startsWith(externalUploadSelectionStatusStart))
-    {
-        return EXTERNAL_UPLOAD_SELECTION_STATUS_START;
-    }
-    else if (request.data.startsWith(externalFolderSyncRequestStart))
-    {
-        return EXTERNAL_FOLDER_SYNC_REQUEST_START;
-    }
-    else if (request.data.startsWith(externalFolderSyncCheckStart))
-    {
-        return EXTERNAL_FOLDER_SYNC_CHECK_START;
-    }
-    else if(request.data.startsWith(externalOpenTransferManagerStart))
-    {
-        return EXTERNAL_OPEN_TRANSFER_MANAGER_START;
-    }
-    else if(request.data.startsWith(externalShowInFolder))
-    {
-        return EXTERNAL_SHOW_IN_FOLDER;
-    }
-    else if(request.data.startsWith(externalTransferQueryProgressStart))
-    {
-        return EXTERNAL_TRANSFER_QUERY_PROGRESS_START;
-    }
-    else if(request.data.startsWith(externalAddBackup))
-    {
-        return EXTERNAL_ADD_BACKUP;
-    }
-    else if(request.data.startsWith(externalRewindRequestStart))
-    {
-        return EXTERNAL_REWIND_REQUEST_START;
-    }
-    return UNKNOWN_REQUEST;
+    static const QHash<QString, RequestType> requestTypes{
+        {QLatin1String("v"), VERSION_COMMAND},
+        {QLatin1String("l"), OPEN_LINK_REQUEST_START},
+        {QLatin1String("d"), EXTERNAL_DOWNLOAD_REQUEST_START},
+        {QLatin1String("ds"), EXTERNAL_DOWNLOAD_SET_REQUEST_START},
+        {QLatin1String("gd"), EXTERNAL_REWIND_REQUEST_START},
+        {QLatin1String("ufi"), EXTERNAL_FILE_UPLOAD_REQUEST_START},
+        {QLatin1String("ufo"), EXTERNAL_FOLDER_UPLOAD_REQUEST_START},
+        {QLatin1String("uff"), EXTERNAL_FILE_FOLDER_UPLOAD_REQUEST_START},
+        {QLatin1String("s"), EXTERNAL_FOLDER_SYNC_REQUEST_START},
+        {QLatin1String("sp"), EXTERNAL_FOLDER_SYNC_CHECK_START},
+        {QLatin1String("tm"), EXTERNAL_OPEN_TRANSFER_MANAGER_START},
+        {QLatin1String("uss"), EXTERNAL_UPLOAD_SELECTION_STATUS_START},
+        {QLatin1String("t"), EXTERNAL_TRANSFER_QUERY_PROGRESS_START},
+        {QLatin1String("tb"), EXTERNAL_TRANSFER_QUERY_PROGRESS_BATCH_START},
+        {QLatin1String("tw"), EXTERNAL_TRANSFER_WATCH_PROGRESS_START},
+        {QLatin1String("sf"), EXTERNAL_SHOW_IN_FOLDER},
+        {QLatin1String("ab"), EXTERNAL_ADD_BACKUP}};
+
+    return requestTypes.value(jsonString(request.json, "a"), UNKNOWN_REQUEST);
 }
 
 QString HTTPServer::findCorrespondingAllowedOrigin(const QStringList& headers)
@@ -1070,8 +1238,7 @@ QString HTTPServer::findCorrespondingAllowedOrigin(const QStringList& headers)
     return QString();
 }
 
-void HTTPServer::processPostRequest(QAbstractSocket *socket, HTTPRequest* request,
-                                    const QStringList& headers, const QString& content)
+bool HTTPServer::readContentLength(QAbstractSocket* socket, HTTPRequest* request, const QStringList& headers)
 {
     QString contentLengthId = QString::fromUtf8("Content-length: ");
     QStringList contentLengthHeader = headers.filter(QRegExp(contentLengthId, Qt::CaseInsensitive));
@@ -1079,34 +1246,41 @@ void HTTPServer::processPostRequest(QAbstractSocket *socket, HTTPRequest* reques
     {
         MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Missing Content-length header");
         rejectRequest(socket);
-        return;
+        return false;
     }
 
     bool ok;
     request->contentLength = contentLengthHeader[0].mid(contentLengthId.size(), contentLengthHeader[0].size() - contentLengthId.size()).toInt(&ok);
-    if (!ok || request->contentLength < content.size())
+    if (!ok || request->contentLength < 0)
     {
-        if (!ok)
-        {
-            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Unable to parse Content-length header: %1")
-                         .arg(contentLengthHeader[0]).toUtf8().constData());
-        }
-        else
-        {
-            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Invalid Content-length header. Header: %1 - Data: %2")
-                         .arg(request->contentLength).arg(content.size()).toUtf8().constData());
-        }
+        MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Unable to parse Content-length header: %1")
+                     .arg(contentLengthHeader[0]).toUtf8().constData());
         rejectRequest(socket);
-        return;
+        return false;
     }
+    return true;
+}
 
-    if (request->contentLength > content.size())
+void HTTPServer::processPostRequest(QAbstractSocket *socket, HTTPRequest* request)
+{
+    int contentSize = request->buffer.size() - request->bodyStart;
+    if (request->contentLength < contentSize)
     {
+        MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Invalid Content-length header. Header: %1 - Data: %2")
+                     .arg(request->contentLength).arg(contentSize).toUtf8().constData());
+        rejectRequest(socket);
         return;
     }
 
-    request->data = content;
+    if (request->contentLength > contentSize)
+    {
+        return;
+    }
 
+    // The body is decoded and parsed only once, when it is complete
+    const QByteArray content = request->buffer.mid(request->bodyStart);
+    request->data = QString::fromUtf8(content);
+    request->json = QJsonDocument::fromJson(content).object();
 
     QPointer<QAbstractSocket> safeSocket = socket;
     QPointer<HTTPServer> safeServer = this;
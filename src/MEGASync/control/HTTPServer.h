@@ -7,12 +7,15 @@
 #include <QDateTime>
 #include <QFile>
 #include <QFutureWatcher>
+#include <QJsonObject>
 #include <QPointer>
 #include <QQueue>
+#include <QSet>
 #include <QSslKey>
 #include <QSslSocket>
 #include <QStringList>
 #include <QTcpServer>
+#include <QTimer>
 
 class RequestData
 {
@@ -45,13 +48,34 @@ public:
     QString tPath;
 };
 
+class TransferProgressWatch
+{
+public:
+    TransferProgressWatch();
+    // Watched transfers, with the handle in base64 as the webclient sent it
+    QMap<mega::MegaHandle, QString> handles;
+    // Transfers updated since the last push
+    QSet<mega::MegaHandle> pending;
+    int intervalMs;
+    qint64 lastPushMs;
+};
+
 class HTTPRequest
 {
 public:
-    HTTPRequest() : contentLength(0), origin(QString::fromUtf8("*")) {}
+    HTTPRequest() : contentLength(0), origin(QString::fromUtf8("*")), scanPos(0), bodyStart(-1) {}
+    // Body of the request, decoded and parsed when it is complete
     QString data;
+    QJsonObject json;
     int contentLength;
     QString origin;
+
+    // Bytes received, kept between reads
+    QByteArray buffer;
+    // Where the search for the end of the headers goes on
+    int scanPos;
+    // -1 until the headers are complete
+    int bodyStart;
 };
 
 class HTTPServer: public QTcpServer
@@ -75,7 +99,9 @@ class HTTPServer: public QTcpServer
         EXTERNAL_ADD_BACKUP,
         UNKNOWN_REQUEST,
         EXTERNAL_REWIND_REQUEST_START,
-        EXTERNAL_DOWNLOAD_SET_REQUEST_START
+        EXTERNAL_DOWNLOAD_SET_REQUEST_START,
+        EXTERNAL_TRANSFER_QUERY_PROGRESS_BATCH_START,
+        EXTERNAL_TRANSFER_WATCH_PROGRESS_START
     };
 
     public:
@@ -110,6 +136,7 @@ class HTTPServer: public QTcpServer
 
     private slots:
         void onVersionCommandFinished();
+        void onProgressPushTimeout();
 
     public slots:
         void readClient();
@@ -120,8 +147,8 @@ class HTTPServer: public QTcpServer
     private:
         QString findCorrespondingAllowedOrigin(const QStringList& headers);
 
-        void processPostRequest(QAbstractSocket* socket, HTTPRequest* request,
-                                const QStringList& headers, const QString& content);
+        bool readContentLength(QAbstractSocket* socket, HTTPRequest* request, const QStringList& headers);
+        void processPostRequest(QAbstractSocket* socket, HTTPRequest* request);
         void processOptionRequest(QAbstractSocket* socket, HTTPRequest* request, const QStringList& headers);
         void sendPreFlightResponse(QAbstractSocket* socket, HTTPRequest* request, bool sendPrivateNetworkField);
         bool hasFieldWithValue(const QStringList& headers, const char* fieldName, const char* value);
@@ -147,11 +174,19 @@ class HTTPServer: public QTcpServer
         void externalOpenTransferManager(QString& response, const HTTPRequest& request);
         void externalUploadSelectionStatus(QString& response, const HTTPRequest& request);
         void externalTransferQueryProgress(QString& response, const HTTPRequest& request);
+        void externalTransferQueryProgressBatch(QString& response, const HTTPRequest& request);
+        void externalTransferWatchProgress(const HTTPRequest& request, QPointer<QAbstractSocket> socket);
         void externalShowInFolder(QString& response, const HTTPRequest& request);
         void externalAddBackup(QString& response, const HTTPRequest& request);
 
         void endProcessRequest(QPointer<QAbstractSocket> socket, const HTTPRequest &request, QString response);
 
+        void pushTransferProgress(QAbstractSocket* socket, TransferProgressWatch& watch, bool allTransfers);
+        void stopTransferProgressWatch(QAbstractSocket* socket);
+        static QMap<mega::MegaHandle, QString> extractTransferHandles(const HTTPRequest& request);
+        static QString transferProgressJson(mega::MegaHandle handle);
+        static bool isTransferFinished(mega::MegaHandle handle);
+
         RequestType GetRequestType(const HTTPRequest& request);
         bool disabled;
         mega::MegaApi *megaApi;
@@ -160,6 +195,10 @@ class HTTPServer: public QTcpServer
         static QMultiMap<QString, RequestData*> webDataRequests;
         static QMap<mega::MegaHandle, RequestTransferData*> webTransferStateRequests;
         QFutureWatcher<VersionCommandAnswer> mVersionCommandWatcher;
+        // Sockets kept open to push the progress of the transfers started from the webclient
+        QMap<QAbstractSocket*, TransferProgressWatch> mProgressWatches;
+        QTimer mProgressPushTimer;
+        static QSet<mega::MegaHandle> updatedTransfers;
 };
 
 #endif // HTTPSERVER_H
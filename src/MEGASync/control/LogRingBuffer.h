@@ -0,0 +1,196 @@
+#ifndef LOG_RING_BUFFER_H
+#define LOG_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// Responsability: bounded lock-free single-producer/single-consumer queue of variable size
+/// records, used by the logger to keep the lines of each thread.
+/// The producer formats the record in place (beginWrite/commitWrite) and the consumer reads it
+/// from the buffer (front/pop), so a line is never copied in between. Records that do not fit in
+/// the free space at the end of the buffer are preceded by a padding record and wrap to the start.
+/// beginWrite/commitWrite must only be called from one thread, and front/pop from another one.
+class LogRingBuffer
+{
+public:
+    enum class RecordType : uint8_t
+    {
+        // The line is stored in the record
+        LINE = 0,
+        // The record keeps a pointer to data owned by the producer or the consumer
+        POINTER = 1,
+        // Fills the end of the buffer when the next record does not fit
+        PADDING = 2
+    };
+
+    struct Record
+    {
+        uint64_t time = 0;
+        const char* data = nullptr;
+        uint32_t size = 0;
+        uint16_t messageOffset = 0;
+        RecordType type = RecordType::LINE;
+        uint8_t level = 0;
+    };
+
+    // Capacity is rounded up to the next power of two
+    explicit LogRingBuffer(size_t capacity):
+        mMask(roundUpToPowerOfTwo(capacity) - 1),
+        mHeaders(new Header[(mMask + 1) / sizeof(Header)]),
+        mPendingHead(0),
+        mPendingSize(0),
+        mHead(0),
+        mTail(0)
+    {
+    }
+
+    LogRingBuffer(const LogRingBuffer&) = delete;
+    LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+    // Returns where the size bytes of the record are written, or nullptr if the ring is full
+    char* beginWrite(size_t size)
+    {
+        if (size > maxRecordSize())
+        {
+            return nullptr;
+        }
+
+        auto head(mHead.load(std::memory_order_relaxed));
+        auto tail(mTail.load(std::memory_order_acquire));
+        auto offset(head & mMask);
+        auto contiguous(capacity() - offset);
+        auto recordSize(alignedSize(size));
+        auto padding(contiguous < recordSize ? contiguous : 0);
+
+        if (head + padding + recordSize - tail > capacity())
+        {
+            return nullptr;
+        }
+
+        if (padding)
+        {
+            // Published with the record
+            headerAt(head)->type = RecordType::PADDING;
+            head += padding;
+        }
+
+        mPendingHead = head;
+        mPendingSize = size;
+        return reinterpret_cast<char*>(headerAt(head) + 1);
+    }
+
+    void commitWrite(uint64_t time, RecordType type, uint16_t messageOffset, uint8_t level)
+    {
+        auto header(headerAt(mPendingHead));
+        header->time = time;
+        header->size = static_cast<uint32_t>(mPendingSize);
+        header->messageOffset = messageOffset;
+        header->type = type;
+        header->level = level;
+
+        mHead.store(mPendingHead + alignedSize(mPendingSize), std::memory_order_release);
+    }
+
+    // The oldest record, which stays valid until pop is called
+    bool front(Record& record)
+    {
+        auto tail(mTail.load(std::memory_order_relaxed));
+        auto head(mHead.load(std::memory_order_acquire));
+
+        while (tail != head)
+        {
+            auto header(headerAt(tail));
+            if (header->type == RecordType::PADDING)
+            {
+                tail += capacity() - (tail & mMask);
+                mTail.store(tail, std::memory_order_release);
+                continue;
+            }
+
+            record.time = header->time;
+            record.data = reinterpret_cast<const char*>(header + 1);
+            record.size = header->size;
+            record.messageOffset = header->messageOffset;
+            record.type = header->type;
+            record.level = header->level;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Must follow a successful front
+    void pop()
+    {
+        auto tail(mTail.load(std::memory_order_relaxed));
+        mTail.store(tail + alignedSize(headerAt(tail)->size), std::memory_order_release);
+    }
+
+    size_t usedBytes() const
+    {
+        auto tail(mTail.load(std::memory_order_acquire));
+        return static_cast<size_t>(mHead.load(std::memory_order_acquire) - tail);
+    }
+
+    bool isEmpty() const
+    {
+        return usedBytes() == 0;
+    }
+
+    size_t capacity() const
+    {
+        return mMask + 1;
+    }
+
+    // Bigger records would leave too little room for the rest of the lines
+    size_t maxRecordSize() const
+    {
+        return capacity() / 4 - sizeof(Header);
+    }
+
+private:
+    struct Header
+    {
+        uint64_t time;
+        uint32_t size;
+        uint16_t messageOffset;
+        RecordType type;
+        uint8_t level;
+    };
+    static_assert(sizeof(Header) == 16, "The records are aligned to the header size");
+
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result(4 * sizeof(Header));
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static size_t alignedSize(size_t size)
+    {
+        return (sizeof(Header) + size + sizeof(Header) - 1) & ~(sizeof(Header) - 1);
+    }
+
+    Header* headerAt(uint64_t position) const
+    {
+        return mHeaders.get() + (position & mMask) / sizeof(Header);
+    }
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    const size_t mMask;
+    std::unique_ptr<Header[]> mHeaders;
+    // Only used by the producer, between beginWrite and commitWrite
+    uint64_t mPendingHead;
+    size_t mPendingSize;
+    // Producer and consumer positions on different cache lines to avoid false sharing
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> mHead;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> mTail;
+};
+
+#endif // LOG_RING_BUFFER_H
@@ -1,5 +1,7 @@
 #include "MegaSyncLogger.h"
 
+#include "ChunkedLogArchive.h"
+#include "LogRingBuffer.h"
 #include "megaapi.h"
 
 #include <QDesktopServices>
@@ -8,16 +10,18 @@
 #include <QFileInfo>
 #include <QString>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <future>
 #include <iostream>
+#include <queue>
 #include <sstream>
 #include <thread>
-#include <zlib.h>
 
 #ifdef WIN32
 #include <windows.h>
@@ -40,6 +44,9 @@
 #define MAX_ROTATE_LOGS_DEFAULT 50   // So we expect to keep 42MB or so in compressed logs
 #define MAX_ROTATE_LOGS_TODELETE 50   // If ever reducing the number of logs, we should remove the older ones anyway. This number should be the historical maximum of that value
 
+#define LOG_RING_SIZE (128 * 1024)   // Lines of each logging thread not written yet. Longer lines are kept out of the ring
+#define LOG_RING_FULL_WAIT_MS 200   // A thread with its ring full waits this long for the logging thread before dropping the line
+
 
 #ifdef _WIN32
     #define CERRQSTRING(filename) std::wcerr << filename.toStdWString()
@@ -50,120 +57,91 @@
 
 void gzipCompressOnRotate(const QString filename, const QString destinationFilename)
 {
-#ifdef WIN32
-    std::ifstream file(filename.toStdWString().data(), std::ofstream::out);
-#else
-    std::ifstream file(filename.toUtf8().data(), std::ofstream::out);
-#endif
-    if (!file.is_open())
-    {
-        std::cerr << "Unable to open log file for reading: "; CERRQSTRING(filename) << std::endl;
-        return;
-    }
-
-    auto gzdeleter = [](gzFile_s* f) { if (f) gzclose(f); };
-
-#ifdef _WIN32
-    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{ gzopen_w(destinationFilename.toStdWString().data(), "wb"), gzdeleter};
-#else
-    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{ gzopen(destinationFilename.toUtf8().data(), "wb"), gzdeleter };
-#endif
-    if (!gzfile)
+    // Compressed in chunks, so the bug reports can take the lines of a time window
+    if (!ChunkedLogArchive::compress(filename, destinationFilename))
     {
-        std::cerr << "Unable to open gzfile for writing: "; CERRQSTRING(filename) << std::endl;
+        std::cerr << "Unable to compress log file: "; CERRQSTRING(filename) << std::endl;
         return;
     }
 
-    std::string line;
-    while (std::getline(file, line))
-    {
-        line.push_back('\n');
-        if (gzputs(gzfile.get(), line.c_str()) == -1)
-        {
-            std::cerr << "Unable to compress log file: "; CERRQSTRING(filename) << std::endl;
-            return;
-        }
-    }
-
-    gzfile.reset();
-    file.close();
     QFile::remove(filename);
 }
 
 using DirectLogFunction = std::function <void (std::ostream *)>;
 
-struct LogLinkedList
+// Lines kept out of the rings, which only store a pointer to them
+struct LogEntry
 {
-    LogLinkedList* next = nullptr;
-    unsigned allocated = 0;
-    unsigned used = 0;
-    int lastmessage = -1;
-    int lastmessageRepeats = 0;
-    bool oomGap = false;
-    DirectLogFunction *mDirectLoggingFunction = nullptr; // we cannot use a non pointer due to the malloc allocation of new entries
-    std::promise<void>* mCompletionPromise = nullptr; // we cannot use a unique_ptr due to the malloc allocation of new entries
-    char message[1];
-
-    static LogLinkedList* create(LogLinkedList* prev, size_t size)
-    {
-        LogLinkedList* entry = (LogLinkedList*)malloc(size);
-        if (entry)
-        {
-            entry->next = nullptr;
-            entry->allocated = unsigned(size - sizeof(LogLinkedList));
-            entry->used = 0;
-            entry->lastmessage = -1;
-            entry->lastmessageRepeats = 0;
-            entry->oomGap = false;
-            entry->mDirectLoggingFunction = nullptr;
-            entry->mCompletionPromise = nullptr;
-            prev->next = entry;
-        }
-        return entry;
-    }
-
-    bool messageFits(size_t size)
-    {
-        return used + size + 2 < allocated;
-    }
+    // Lines too long for the rings, owned by the logging thread once queued
+    std::string mLine;
+    size_t mMessageOffset = 0;
+    // Lines logged with ENABLE_LOG_PERFORMANCE, written by the logging thread while the caller waits
+    DirectLogFunction* mDirectLoggingFunction = nullptr;
+    std::promise<void>* mCompletionPromise = nullptr;
+};
 
-    bool needsDirectOutput()
+// The lines of one thread, from the oldest to the newest
+struct ThreadLog
+{
+    ThreadLog():
+        ring(LOG_RING_SIZE)
     {
-        return mDirectLoggingFunction != nullptr;
     }
 
-    void append(const char* s, unsigned int n = 0)
-    {
-        n = n ? n : unsigned(strlen(s));
-        assert(used + n + 1 < allocated);
-        strcpy(message + used, s);
-        used += n;
-    }
+    LogRingBuffer ring;
+    // Lines lost because the ring was full
+    std::atomic<unsigned> droppedLines{0};
+    // The thread finished: the ring is released once the logging thread empties it
+    std::atomic<bool> threadExited{false};
+};
 
-    void notifyWaiter()
+// Cached by each thread, so logging a line does not need any lock
+struct ThreadLogState
+{
+    ~ThreadLogState()
     {
-        if (mCompletionPromise)
+        if (log)
         {
-            mCompletionPromise->set_value();
+            log->threadExited = true;
         }
     }
 
+    unsigned loggerId = 0;
+    std::shared_ptr<ThreadLog> log;
+    std::string threadName;
+    time_t lastT = 0;
+    struct tm lastTm;
 };
 
+thread_local ThreadLogState tThreadLogState;
+
 MegaSyncLogger *g_megaSyncLogger = nullptr;
 std::atomic<bool> gAppExit(false);
 
 struct LoggingThread
 {
+    LoggingThread():
+        loggerId(++lastLoggerId)
+    {
+    }
+
     std::unique_ptr<std::thread> logThread;
     std::condition_variable logConditionVariable;
     std::mutex logMutex;
     std::mutex logRotationMutex;
-    LogLinkedList logListFirst;
-    LogLinkedList* logListLast = &logListFirst;
+    // The rings of the threads that logged, only locked the first time a thread logs
+    std::mutex threadLogsMutex;
+    std::vector<std::shared_ptr<ThreadLog>> threadLogs;
+    const unsigned loggerId;
+    static std::atomic<unsigned> lastLoggerId;
+    std::atomic<bool> logThreadRunning{false};
+    bool newLines = false;
     bool logExit = false;
-    bool flushLog = false;
+    std::atomic<bool> flushLog{false};
     bool closeLog = false;
+    bool dumpFlightRecorder = false;
+    std::atomic<int> fileLogLevel{mega::MegaApi::LOG_LEVEL_MAX};
+    std::atomic<size_t> flightRecorderSize{0};
     bool forceRotationForReporting = false;
     bool forceRenew = false; //to force removal of all logs and create an empty MEGAsync.log
     bool logToDesktop = false;
@@ -185,6 +163,22 @@ struct LoggingThread
     void log(int loglevel, const char *message, const char **directMessages = nullptr, size_t *directMessagesSizes = nullptr, int numberMessages = 0);
 
 private:
+    // Repeated lines are detected when the rings are merged
+    std::string lastMessage;
+    unsigned lastMessageRepeats = 0;
+    // Only used by the logging thread, which writes and reads it
+    std::unique_ptr<LogRingBuffer> flightRecorder;
+    size_t flightRecorderAllocatedSize = 0;
+
+    ThreadLog& threadLog();
+    bool writeRecord(ThreadLog& log, uint64_t time, LogRingBuffer::RecordType type, int loglevel,
+                     const char** parts, const size_t* sizes, int numberParts, size_t messageOffset);
+    void wakeLoggingThread();
+    void writeNewLines(std::ofstream& outputFile, std::ofstream& logDesktopFile, long long& outFileSize);
+    void updateFlightRecorder(int fileLevel);
+    void recordLine(const char* line, size_t lineLen);
+    void writeFlightRecorder(std::ofstream& outputFile, long long& outFileSize);
+
     QString numberedLogFilename(QString baseName, int logNumber)
     {
         QString newName = baseName;
@@ -215,6 +209,7 @@ private:
     #else
         std::ofstream outputFile(filename.toUtf8().data(), std::ofstream::out | std::ofstream::app);
     #endif
+        logThreadRunning = true;
         outputFile << "----------------------------- program start -----------------------------\n";
         long long outFileSize = outputFile.tellp();
         std::ofstream logDesktopFile;
@@ -236,6 +231,7 @@ private:
                             std::cerr << "Error removing log file " << i << std::endl;
                         }
                     }
+                    QFile::remove(ChunkedLogArchive::indexPath(toDelete));
                 }
 
                 outputFile.close();
@@ -267,19 +263,27 @@ private:
 
                     if (QFile::exists(toRename))
                     {
+                        auto indexToRename = ChunkedLogArchive::indexPath(toRename);
                         if (i + 1 >= logCountToRotate)
                         {
                             if (!QFile::remove(toRename))
                             {
                                 std::cerr << "Error removing log file " << i << std::endl;
                             }
-
+                            QFile::remove(indexToRename);
                         }
                         else
                         {
-                            if (!QFile(toRename).rename(numberedLogFilename(filename, i + 1)))
+                            auto newName = numberedLogFilename(filename, i + 1);
+                            if (!QFile(toRename).rename(newName))
                             {
                                 std::cerr << "Error renaming log file " << i << std::endl;
+                                QFile::remove(indexToRename);
+                            }
+                            else if (QFile::exists(indexToRename))
+                            {
+                                QFile::remove(ChunkedLogArchive::indexPath(newName));
+                                QFile(indexToRename).rename(ChunkedLogArchive::indexPath(newName));
                             }
                         }
                     }
@@ -316,22 +320,12 @@ private:
                 outFileSize = 0;
             }
 
-            LogLinkedList* newMessages = nullptr;
-            bool topLevelMemoryGap = false;
             {
                 std::unique_lock<std::mutex> lock(logMutex);
-                logConditionVariable.wait_for(lock, std::chrono::milliseconds(500), [this, &newMessages, &topLevelMemoryGap]() {
-                        if (forceRenew || logListFirst.next || logExit || forceRotationForReporting || logToDesktopChanged || flushLog || closeLog)
-                        {
-                            newMessages = logListFirst.next;
-                            logListFirst.next = nullptr;
-                            logListLast = &logListFirst;
-                            topLevelMemoryGap = logListFirst.oomGap;
-                            logListFirst.oomGap = false;
-                            return true;
-                        }
-                        else return false;
+                logConditionVariable.wait_for(lock, std::chrono::milliseconds(500), [this]() {
+                        return forceRenew || newLines || logExit || forceRotationForReporting || logToDesktopChanged || flushLog || closeLog || dumpFlightRecorder;
                 });
+                newLines = false;
             }
 
             if (logToDesktopChanged)
@@ -353,76 +347,14 @@ private:
                 }
             }
 
-            if (topLevelMemoryGap)
-            {
-                if (outputFile)
-                {
-                    outputFile << "<log gap - out of logging memory at this point>\n";
-                }
-                if (logDesktopFile)
-                {
-                    logDesktopFile << "<log gap - out of logging memory at this point>\n";
-                }
-            }
+            writeNewLines(outputFile, logDesktopFile, outFileSize);
 
-            while (newMessages)
+            if (dumpFlightRecorder)
             {
-                auto p = newMessages;
-                newMessages = newMessages->next;
-                if (outputFile)
-                {
-                    if (p->needsDirectOutput())
-                    {
-                        (*p->mDirectLoggingFunction)(&outputFile);
-                    }
-                    else
-                    {
-                        outputFile << p->message;
-                        outFileSize += p->used;
-                        if (p->oomGap)
-                        {
-                            outputFile << "<log gap - out of logging memory at this point>\n";
-                        }
-                    }
-                }
-                if (logDesktopFile)
-                {
-                    if (p->needsDirectOutput())
-                    {
-                        (*p->mDirectLoggingFunction)(&logDesktopFile);
-                    }
-                    else
-                    {
-                        logDesktopFile << p->message;
-                        if (p->oomGap)
-                        {
-                            logDesktopFile << "<log gap - out of logging memory at this point>\n";
-                        }
-                    }
-                    if (!newMessages)
-                    {
-                        logDesktopFile.flush(); //always flush in `active` logging
-                    }
-                }
-
-                if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
-                {
-                    if (p->needsDirectOutput())
-                    {
-                        (*p->mDirectLoggingFunction)(&std::cout);
-                    }
-                    else
-                    {
-                        std::cout << p->message;
-                    }
-                    if (!newMessages)
-                    {
-                        std::cout << std::flush; //always flush into stdout (DEBUG mode)
-                    }
-                }
-                p->notifyWaiter();
-                free(p);
+                dumpFlightRecorder = false;
+                writeFlightRecorder(outputFile, outFileSize);
             }
+
             if (flushLog || forceRotationForReporting || nextFlushTime <= std::chrono::steady_clock::now())
             {
                 flushLog = false;
@@ -445,13 +377,17 @@ private:
                 {
                     logDesktopFile.close();
                 }
+                logThreadRunning = false;
                 return;  // This request means we have received a termination signal; close and exit the thread as quick & clean as possible
             }
         }
+        logThreadRunning = false;
     }
 
 };
 
+std::atomic<unsigned> LoggingThread::lastLoggerId{0};
+
 void exitFunction()
 {
     gAppExit = true;
@@ -529,39 +465,261 @@ char* filltime(char* s, struct tm*  gmt, int microsec)
     return s;
 }
 
-std::mutex threadNameMutex;
-std::map<std::thread::id, std::string> threadNames;
-struct tm lastTm;
-time_t lastT = 0;
-std::thread::id lastThreadId;
-const char* lastThreadName;
-
-void cacheThreadNameAndTimeT(time_t t, struct tm& gmt, const char*& threadname)
+const char* logLevelString(int loglevel)
 {
-    std::lock_guard<std::mutex> g(threadNameMutex);
-
-    if (t != lastT)
+    switch (loglevel) // keeping these at 4 chars makes nice columns, easy to read
     {
-        lastTm = *std::gmtime(&t);
-        lastT = t;
+    case mega::MegaApi::LOG_LEVEL_FATAL: return "CRIT ";
+    case mega::MegaApi::LOG_LEVEL_ERROR: return "ERR  ";
+    case mega::MegaApi::LOG_LEVEL_WARNING: return "WARN ";
+    case mega::MegaApi::LOG_LEVEL_INFO: return "INFO ";
+    case mega::MegaApi::LOG_LEVEL_DEBUG: return "DBG  ";
+    case mega::MegaApi::LOG_LEVEL_MAX: return "DTL  ";
     }
-    gmt = lastTm;
+    return "     ";
+}
 
-    if (lastThreadId == std::this_thread::get_id())
+ThreadLog& LoggingThread::threadLog()
+{
+    auto& state = tThreadLogState;
+    if (state.loggerId != loggerId)
     {
-        threadname = lastThreadName;
-        return;
+        if (state.log)
+        {
+            state.log->threadExited = true;
+        }
+
+        state.log = std::make_shared<ThreadLog>();
+        state.loggerId = loggerId;
+
+        std::lock_guard<std::mutex> g(threadLogsMutex);
+        threadLogs.push_back(state.log);
     }
 
-    auto& entry = threadNames[std::this_thread::get_id()];
-    if (entry.empty())
+    if (state.threadName.empty())
     {
         std::ostringstream s;
         s << std::this_thread::get_id() << " ";
-        entry = s.str();
+        state.threadName = s.str();
+    }
+
+    return *state.log;
+}
+
+void LoggingThread::wakeLoggingThread()
+{
+    {
+        // Under the lock, so the logging thread can not miss it
+        std::lock_guard<std::mutex> g(logMutex);
+        newLines = true;
+    }
+    logConditionVariable.notify_one();
+}
+
+bool LoggingThread::writeRecord(ThreadLog& log, uint64_t time, LogRingBuffer::RecordType type, int loglevel,
+                                const char** parts, const size_t* sizes, int numberParts, size_t messageOffset)
+{
+    size_t size = 0;
+    for (int i = 0; i < numberParts; i++)
+    {
+        size += sizes[i];
+    }
+
+    auto usedBefore = log.ring.usedBytes();
+    char* out = log.ring.beginWrite(size);
+    if (!out)
+    {
+        // Let the logging thread empty the ring, unless it is not running anymore
+        auto waitUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOG_RING_FULL_WAIT_MS);
+        wakeLoggingThread();
+        while (!out && logThreadRunning && std::chrono::steady_clock::now() < waitUntil)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            out = log.ring.beginWrite(size);
+        }
+
+        if (!out)
+        {
+            ++log.droppedLines;
+            return false;
+        }
+        usedBefore = 0;
+    }
+
+    for (int i = 0; i < numberParts; i++)
+    {
+        memcpy(out, parts[i], sizes[i]);
+        out += sizes[i];
+    }
+    log.ring.commitWrite(time, type, static_cast<uint16_t>(messageOffset), static_cast<uint8_t>(loglevel));
+
+    // This notify was taking 1% when notifying on every log line, so let the logging thread wake
+    // up by itself every 500ms for the common case. Still wake it if the ring is getting full
+    auto half = log.ring.capacity() / 2;
+    if (usedBefore < half && log.ring.usedBytes() >= half)
+    {
+        wakeLoggingThread();
+    }
+    return true;
+}
+
+void LoggingThread::writeNewLines(std::ofstream& outputFile, std::ofstream& logDesktopFile, long long& outFileSize)
+{
+    bool logToStdout = g_megaSyncLogger && g_megaSyncLogger->mLogToStdout;
+    bool written = false;
+    // In debug mode everything is written
+    int fileLevel = logToDesktop ? mega::MegaApi::LOG_LEVEL_MAX : fileLogLevel.load();
+    updateFlightRecorder(fileLevel);
+
+    auto write = [&](const char* data, size_t size)
+    {
+        if (outputFile)
+        {
+            outputFile.write(data, static_cast<std::streamsize>(size));
+            outFileSize += static_cast<long long>(size);
+        }
+        if (logDesktopFile)
+        {
+            logDesktopFile.write(data, static_cast<std::streamsize>(size));
+        }
+        if (logToStdout)
+        {
+            std::cout.write(data, static_cast<std::streamsize>(size));
+        }
+        written = true;
+    };
+
+    auto writeRepeats = [&]()
+    {
+        if (lastMessageRepeats)
+        {
+            char repeatbuf[31]; // this one can occur very frequently with many in a row: cURL DEBUG: schannel: failed to decrypt data, need more data
+            int n = snprintf(repeatbuf, 30, "[repeated x%u]\n", lastMessageRepeats);
+            write(repeatbuf, static_cast<size_t>(n));
+            lastMessageRepeats = 0;
+        }
+    };
+
+    std::vector<std::shared_ptr<ThreadLog>> logs;
+    {
+        std::lock_guard<std::mutex> g(threadLogsMutex);
+        logs = threadLogs;
+    }
+
+    // Lines logged after this point wait for the next pass, so a busy thread does not keep this
+    // one merging forever
+    auto passTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                              std::chrono::system_clock::now().time_since_epoch()).count());
+
+    using Front = std::pair<uint64_t, size_t>;
+    std::priority_queue<Front, std::vector<Front>, std::greater<Front>> fronts;
+    LogRingBuffer::Record record;
+    for (size_t i = 0; i < logs.size(); i++)
+    {
+        if (auto dropped = logs[i]->droppedLines.exchange(0))
+        {
+            char gapbuf[80];
+            int n = snprintf(gapbuf, sizeof(gapbuf), "<log gap - %u lines lost, logging buffer full>\n", dropped);
+            write(gapbuf, static_cast<size_t>(n));
+        }
+
+        if (logs[i]->ring.front(record) && record.time <= passTime)
+        {
+            fronts.emplace(record.time, i);
+        }
+    }
+
+    auto writeLine = [&](const char* line, size_t lineLen, size_t messageOffset, int level)
+    {
+        recordLine(line, lineLen);
+        if (level > fileLevel)
+        {
+            return;
+        }
+
+        // The line ends with a new line, which is not part of the message
+        const char* message = line + messageOffset;
+        size_t messageLen = lineLen - messageOffset - 1;
+
+        if (messageLen == lastMessage.size() && !memcmp(message, lastMessage.data(), messageLen))
+        {
+            ++lastMessageRepeats;
+            return;
+        }
+
+        writeRepeats();
+        lastMessage.assign(message, messageLen);
+        write(line, lineLen);
+    };
+
+    // Each ring is in order, merge them by time
+    while (!fronts.empty())
+    {
+        auto index = fronts.top().second;
+        auto& log = *logs[index];
+        fronts.pop();
+        log.ring.front(record);
+
+        if (record.type == LogRingBuffer::RecordType::POINTER)
+        {
+            LogEntry* entry = nullptr;
+            memcpy(&entry, record.data, sizeof(entry));
+            log.ring.pop();
+
+            if (entry->mDirectLoggingFunction)
+            {
+                writeRepeats();
+                lastMessage.clear();
+                if (outputFile)
+                {
+                    (*entry->mDirectLoggingFunction)(&outputFile);
+                }
+                if (logDesktopFile)
+                {
+                    (*entry->mDirectLoggingFunction)(&logDesktopFile);
+                }
+                if (logToStdout)
+                {
+                    (*entry->mDirectLoggingFunction)(&std::cout);
+                }
+                written = true;
+                entry->mCompletionPromise->set_value();
+            }
+            else
+            {
+                writeLine(entry->mLine.data(), entry->mLine.size(), entry->mMessageOffset, record.level);
+                delete entry;
+            }
+        }
+        else
+        {
+            writeLine(record.data, record.size, record.messageOffset, record.level);
+            log.ring.pop();
+        }
+
+        if (log.ring.front(record) && record.time <= passTime)
+        {
+            fronts.emplace(record.time, index);
+        }
+    }
+
+    if (written)
+    {
+        if (logDesktopFile)
+        {
+            logDesktopFile.flush(); //always flush in `active` logging
+        }
+        if (logToStdout)
+        {
+            std::cout << std::flush; //always flush into stdout (DEBUG mode)
+        }
     }
-    threadname = lastThreadName = entry.c_str();
-    lastThreadId = std::this_thread::get_id();
+
+    // Release the rings of the threads that finished
+    std::lock_guard<std::mutex> g(threadLogsMutex);
+    threadLogs.erase(std::remove_if(threadLogs.begin(), threadLogs.end(), [](const std::shared_ptr<ThreadLog>& log) {
+                         return log->threadExited && log->ring.isEmpty() && !log->droppedLines;
+                     }), threadLogs.end());
 }
 
 void MegaSyncLogger::log(const char*, int loglevel, const char*, const char *message
@@ -606,152 +764,161 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
     }
 
     bool direct = directMessages != nullptr;
+    auto& log = threadLog();
+    auto& state = tThreadLogState;
 
     char timebuf[LOG_TIME_CHARS + 1];
     auto now = std::chrono::system_clock::now();
     time_t t = std::chrono::system_clock::to_time_t(now);
-
-    struct tm gmt;
-    const char* threadname;
-    cacheThreadNameAndTimeT(t, gmt, threadname);
+    if (t != state.lastT)
+    {
+        state.lastTm = *std::gmtime(&t);
+        state.lastT = t;
+    }
 
     auto microsec = std::chrono::duration_cast<std::chrono::microseconds>(now - std::chrono::system_clock::from_time_t(t));
-    filltime(timebuf, &gmt, (int)microsec.count() % 1000000);
+    filltime(timebuf, &state.lastTm, (int)microsec.count() % 1000000);
+    auto time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count());
 
-    const char* loglevelstring = "     ";
-    switch (loglevel) // keeping these at 4 chars makes nice columns, easy to read
-    {
-    case mega::MegaApi::LOG_LEVEL_FATAL: loglevelstring = "CRIT "; break;
-    case mega::MegaApi::LOG_LEVEL_ERROR: loglevelstring = "ERR  "; break;
-    case mega::MegaApi::LOG_LEVEL_WARNING: loglevelstring = "WARN "; break;
-    case mega::MegaApi::LOG_LEVEL_INFO: loglevelstring = "INFO "; break;
-    case mega::MegaApi::LOG_LEVEL_DEBUG: loglevelstring = "DBG  "; break;
-    case mega::MegaApi::LOG_LEVEL_MAX: loglevelstring = "DTL  "; break;
-    }
+    const char* threadname = state.threadName.c_str();
+    const char* loglevelstring = logLevelString(loglevel);
 
     auto messageLen = strlen(message);
-    auto threadnameLen = strlen(threadname);
-    auto lineLen = LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS + messageLen;
-    bool notify = false;
+    auto threadnameLen = state.threadName.size();
 
+#if defined(WIN32) && defined(DEBUG)
+    OutputDebugStringA(std::string(timebuf).c_str());
+    OutputDebugStringA(std::string(threadname).c_str());
+    OutputDebugStringA(std::string(loglevelstring).c_str());
+    if (message)
     {
-        std::unique_ptr<std::lock_guard<std::mutex>> g(new std::lock_guard<std::mutex>(logMutex));
-
-        bool isRepeat = !direct && logListLast != &logListFirst &&
-                        logListLast->lastmessage >= 0 &&
-                        !strncmp(message, logListLast->message + logListLast->lastmessage, messageLen);
+        OutputDebugStringA(std::string(message, messageLen).c_str());
+    }
+    for(int i = 0; i < numberMessages; i++)
+    {
+        OutputDebugStringA(std::string(directMessages[i], directMessagesSizes[i]).c_str());
+    }
+    OutputDebugStringA("\r\n");
+#endif
 
-        if (isRepeat)
-        {
-            ++logListLast->lastmessageRepeats;
-        }
-        else
+    if (direct)
+    {
+        std::promise<void> promise;
+        auto future = promise.get_future();
+        DirectLogFunction func = [&timebuf, &threadname, &loglevelstring, &directMessages, &directMessagesSizes, numberMessages](std::ostream *oss)
         {
-            unsigned reportRepeats = logListLast != &logListFirst ? logListLast->lastmessageRepeats : 0;
-            if (reportRepeats)
-            {
-                lineLen += 30;
-                logListLast->lastmessageRepeats = 0;
-            }
+            *oss << timebuf << threadname << loglevelstring;
 
-#if defined(WIN32) && defined(DEBUG)
-            OutputDebugStringA(std::string(timebuf).c_str());
-            OutputDebugStringA(std::string(threadname).c_str());
-            OutputDebugStringA(std::string(loglevelstring).c_str());
-            if (message)
-            {
-                OutputDebugStringA(std::string(message, messageLen).c_str());
-            }
             for(int i = 0; i < numberMessages; i++)
             {
-                OutputDebugStringA(std::string(directMessages[i], directMessagesSizes[i]).c_str());
+                oss->write(directMessages[i], directMessagesSizes[i]);
             }
-            OutputDebugStringA("\r\n");
-#endif
-            if (direct)
-            {
-                if (LogLinkedList* newentry = LogLinkedList::create(logListLast, 1 + sizeof(LogLinkedList))) //create a new "empty" element
-                {
-                    logListLast = newentry;
-                    std::promise<void> promise;
-                    logListLast->mCompletionPromise = &promise;
-                    auto future = logListLast->mCompletionPromise->get_future();
-                    DirectLogFunction func = [&timebuf, &threadname, &loglevelstring, &directMessages, &directMessagesSizes, numberMessages](std::ostream *oss)
-                    {
-                        *oss << timebuf << threadname << loglevelstring;
-
-                        for(int i = 0; i < numberMessages; i++)
-                        {
-                            oss->write(directMessages[i], directMessagesSizes[i]);
-                        }
-                        *oss << std::endl;
-                    };
-
-                    logListLast->mDirectLoggingFunction = &func;
-
-                    g.reset(); //to liberate the mutex and let the logging thread call the logging function
+            *oss << std::endl;
+        };
+
+        LogEntry entry;
+        entry.mDirectLoggingFunction = &func;
+        entry.mCompletionPromise = &promise;
+        LogEntry* entryPointer = &entry;
+        const char* parts[] = {reinterpret_cast<const char*>(&entryPointer)};
+        const size_t sizes[] = {sizeof(entryPointer)};
+        if (writeRecord(log, time, LogRingBuffer::RecordType::POINTER, loglevel, parts, sizes, 1, 0))
+        {
+            wakeLoggingThread();
 
-                    logConditionVariable.notify_one();
+            //wait for until logging thread completes the outputting
+            future.get();
+        }
+        return;
+    }
 
-                    //wait for until logging thread completes the outputting
-                    future.get();
-                    return;
-                }
-                else
-                {
-                    logListLast->oomGap = true;
-                }
+    const char* parts[] = {timebuf, threadname, loglevelstring, message, "\n"};
+    const size_t sizes[] = {LOG_TIME_CHARS, threadnameLen, LOG_LEVEL_CHARS, messageLen, 1};
+    auto messageOffset = LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS;
+    auto lineLen = messageOffset + messageLen + 1;
 
-            }
-            else
-            {
-                if (logListLast == &logListFirst || logListLast->oomGap || !logListLast->messageFits(lineLen))
-                {
-                    if (LogLinkedList* newentry = LogLinkedList::create(logListLast, std::max<size_t>(lineLen, 8192) + sizeof(LogLinkedList) + 10))
-                    {
-                        logListLast = newentry;
-                    }
-                    else
-                    {
-                        logListLast->oomGap = true;
-                    }
-                }
-                if (!logListLast->oomGap)
-                {
-                    if (reportRepeats)
-                    {
-                        char repeatbuf[31]; // this one can occur very frequently with many in a row: cURL DEBUG: schannel: failed to decrypt data, need more data
-                        int n = snprintf(repeatbuf, 30, "[repeated x%u]\n", reportRepeats);
-                        logListLast->append(repeatbuf, n);
-                    }
-                    logListLast->append(timebuf, LOG_TIME_CHARS);
-                    logListLast->append(threadname, unsigned(threadnameLen));
-                    logListLast->append(loglevelstring, LOG_LEVEL_CHARS);
-                    logListLast->lastmessage = logListLast->used;
-                    logListLast->append(message, unsigned(messageLen));
-                    logListLast->append("\n", 1);
-                    notify = logListLast->used + 1024 > logListLast->allocated;
-                }
-            }
+    if (lineLen <= log.ring.maxRecordSize())
+    {
+        writeRecord(log, time, LogRingBuffer::RecordType::LINE, loglevel, parts, sizes, 5, messageOffset);
+    }
+    else
+    {
+        // Too long for the ring, which keeps a pointer to it instead
+        auto entry = new LogEntry();
+        entry->mLine.reserve(lineLen);
+        for (int i = 0; i < 5; i++)
+        {
+            entry->mLine.append(parts[i], sizes[i]);
         }
+        entry->mMessageOffset = messageOffset;
 
-        if (loglevel <= flushOnLevel)
+        const char* pointerParts[] = {reinterpret_cast<const char*>(&entry)};
+        const size_t pointerSizes[] = {sizeof(entry)};
+        if (!writeRecord(log, time, LogRingBuffer::RecordType::POINTER, loglevel, pointerParts, pointerSizes, 1, 0))
         {
-            flushLog = true;
+            delete entry;
         }
     }
 
-    if (notify)
+    if (loglevel <= flushOnLevel)
+    {
+        flushLog = true;
+    }
+}
+
+void LoggingThread::updateFlightRecorder(int fileLevel)
+{
+    // Not needed when the log file has every line
+    size_t size = fileLevel < mega::MegaApi::LOG_LEVEL_MAX ? flightRecorderSize.load() : 0;
+    if (size != flightRecorderAllocatedSize)
+    {
+        flightRecorder.reset(size ? new LogRingBuffer(size) : nullptr);
+        flightRecorderAllocatedSize = size;
+    }
+}
+
+void LoggingThread::recordLine(const char* line, size_t lineLen)
+{
+    if (!flightRecorder || lineLen > flightRecorder->maxRecordSize())
+    {
+        return;
+    }
+
+    // The oldest lines are overwritten
+    char* out = flightRecorder->beginWrite(lineLen);
+    LogRingBuffer::Record oldest;
+    while (!out && flightRecorder->front(oldest))
     {
-        // notify outside the mutex lock is better (and correct) for much less chance the other
-        // thread wakes up just to find the mutex locked. (saw lower cpu on the other thread like this)
-        // Still, this notify call was taking 1% when notifying on every log line, so let the other thead
-        // wake up by itself every 500ms without notify for the common case.
-        // But still wake it if our memory block is getting full
-        logConditionVariable.notify_one();
+        flightRecorder->pop();
+        out = flightRecorder->beginWrite(lineLen);
+    }
+
+    if (out)
+    {
+        memcpy(out, line, lineLen);
+        flightRecorder->commitWrite(0, LogRingBuffer::RecordType::LINE, 0, 0);
     }
 }
 
+void LoggingThread::writeFlightRecorder(std::ofstream& outputFile, long long& outFileSize)
+{
+    if (!flightRecorder || flightRecorder->isEmpty() || !outputFile)
+    {
+        return;
+    }
+
+    outputFile << "----------------------------- flight recorder: last lines at full verbosity -----------------------------\n";
+    LogRingBuffer::Record record;
+    while (flightRecorder->front(record))
+    {
+        outputFile.write(record.data, static_cast<std::streamsize>(record.size));
+        outFileSize += record.size;
+        flightRecorder->pop();
+    }
+    outputFile << "----------------------------- end of flight recorder -----------------------------\n";
+    outputFile.flush();
+}
+
 void MegaSyncLogger::setDebug(const bool enable)
 {
     g_loggingThread->logToDesktop = enable;
@@ -763,9 +930,28 @@ bool MegaSyncLogger::isDebug() const
     return g_loggingThread->logToDesktop;
 }
 
+void MegaSyncLogger::setFileLogLevel(int level)
+{
+    g_loggingThread->fileLogLevel = level;
+}
+
+void MegaSyncLogger::setFlightRecorderSize(size_t bytes)
+{
+    g_loggingThread->flightRecorderSize = bytes;
+}
+
+void MegaSyncLogger::dumpFlightRecorder()
+{
+    std::lock_guard<std::mutex> g(g_loggingThread->logMutex);
+    g_loggingThread->dumpFlightRecorder = true;
+    g_loggingThread->logConditionVariable.notify_one();
+}
+
 bool MegaSyncLogger::prepareForReporting()
 {
     std::lock_guard<std::mutex> g(g_loggingThread->logMutex);
+    // The report includes the detail of the last lines
+    g_loggingThread->dumpFlightRecorder = true;
     g_loggingThread->forceRotationForReporting = true;
     g_loggingThread->logConditionVariable.notify_one();
     return true;
@@ -795,6 +981,7 @@ void MegaSyncLogger::flushAndClose()
         std::cerr << "Unhandle exception on flushAndClose: "<< e.what() << std::endl;
     }
     g_loggingThread->flushLog = true;
+    g_loggingThread->dumpFlightRecorder = true;
     g_loggingThread->closeLog = true;
     g_loggingThread->logConditionVariable.notify_one();
     // This is called on crash so the app may be unstable. Don't assume the thread is working properly.
@@ -26,6 +26,14 @@ public:
              ) override;
     void setDebug(bool enable);
     bool isDebug() const;
+
+    // Lines more verbose than level are not written to the log file, only to the flight recorder
+    void setFileLogLevel(int level);
+    // The flight recorder keeps the last lines at full verbosity in memory while the log file is
+    // filtered (see setFileLogLevel) and the debug mode is off. 0 disables it
+    void setFlightRecorderSize(size_t bytes);
+    // Writes the lines of the flight recorder to the log file
+    void dumpFlightRecorder();
     bool mLogToStdout = false;
 
     // this one is called on signal (flush log before crash report)
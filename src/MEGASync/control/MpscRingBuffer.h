@@ -0,0 +1,118 @@
+#ifndef MPSC_RING_BUFFER_H
+#define MPSC_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// Responsability: bounded lock-free multi-producer/single-consumer queue.
+/// Every cell carries a sequence number telling whether it is free for the producer holding that
+/// position or ready for the consumer, so producers only contend on a single atomic counter and
+/// never block. tryPush returns false when the ring is full, the caller decides what to do then.
+/// tryPop must only be called from one thread at a time.
+template <typename T>
+class MpscRingBuffer
+{
+public:
+    // Capacity is rounded up to the next power of two
+    explicit MpscRingBuffer(size_t capacity):
+        mMask(roundUpToPowerOfTwo(capacity) - 1),
+        mCells(new Cell[mMask + 1]),
+        mEnqueuePos(0),
+        mDequeuePos(0)
+    {
+        for (size_t index = 0; index <= mMask; ++index)
+        {
+            mCells[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // The item is only moved from when the push succeeds
+    bool tryPush(T&& item)
+    {
+        Cell* cell(nullptr);
+        auto pos(mEnqueuePos.load(std::memory_order_relaxed));
+
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            auto sequence(cell->sequence.load(std::memory_order_acquire));
+            auto diff(static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos));
+
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Full
+                return false;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item)
+    {
+        auto& cell(mCells[mDequeuePos & mMask]);
+        auto sequence(cell.sequence.load(std::memory_order_acquire));
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(mDequeuePos + 1) < 0)
+        {
+            // Empty, or the producer holding this position has not finished writing yet
+            return false;
+        }
+
+        item = std::move(cell.data);
+        // Release whatever the cell owns now, not when it is overwritten
+        cell.data = T();
+        cell.sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        ++mDequeuePos;
+        return true;
+    }
+
+    size_t capacity() const
+    {
+        return mMask + 1;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result(2);
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    const size_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+    // Producers and consumer positions on different cache lines to avoid false sharing
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> mEnqueuePos;
+    alignas(CACHE_LINE_SIZE) size_t mDequeuePos;
+};
+
+#endif // MPSC_RING_BUFFER_H
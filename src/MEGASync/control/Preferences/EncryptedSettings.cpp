@@ -2,14 +2,36 @@
 
 #include "Platform.h"
 
+#include <QCoreApplication>
+#include <QtConcurrent/QtConcurrent>
+
 EncryptedSettings::EncryptedSettings(QString file) :
     QSettings(file, QSettings::IniFormat)
 {
+    // A single thread, so the flushes are written one after the other
+    mFlushThreadPool.setMaxThreadCount(1);
+
+    mFlushTimer.setSingleShot(true);
+    mFlushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&mFlushTimer,
+            &QTimer::timeout,
+            this,
+            [this]()
+            {
+                QtConcurrent::run(&mFlushThreadPool,
+                                  [this]()
+                                  {
+                                      flushNow();
+                                  });
+            });
+
 #ifdef _WIN32
     // On Win, LocalStorageKey can change after an OS update, so don't fetch it every time from the OS.
     // Use the cached one if available, and only get it from the OS if not.
     QString keyTag = QString::fromUtf8("LocalStorageKey");
-    encryptionKey = QByteArray::fromHex(value(keyTag).toByteArray());
+    // Not cached, the key to read it is not the final one
+    encryptionKey = QByteArray::fromHex(
+        decrypt(keyTag, QSettings::value(hash(keyTag)).toString()).toLatin1());
     if (!encryptionKey.isEmpty())
         return;
 #endif
@@ -25,73 +47,185 @@ EncryptedSettings::EncryptedSettings(QString file) :
     // Cache LocalStorageKey
     auto bkp = encryptionKey;
     encryptionKey.clear(); // switch to no key internally when caching the OS one
-    setValue(keyTag, bkp.toHex());
+    QSettings::setValue(hash(keyTag), encrypt(keyTag, QString::fromLatin1(bkp.toHex())));
+    mDirty = true;
     encryptionKey = bkp; // switch back to the real encryptionKey
 #endif
 }
 
+EncryptedSettings::~EncryptedSettings()
+{
+    mFlushTimer.stop();
+    mFlushThreadPool.waitForDone();
+    flushNow();
+}
+
 void EncryptedSettings::setValue(const QString &key, const QVariant &value)
 {
-    QSettings::setValue(hash(key), encrypt(key, value.toString()));
+    CachedValue cached;
+    cached.exists = true;
+    cached.value = value.toString();
+
+    QMutexLocker settingsLock(&mSettingsMutex);
+    QSettings::setValue(hash(key), encrypt(key, cached.value));
+    mDirty = true;
+    ++mWritesRequested;
+
+    QWriteLocker lock(&mCacheLock);
+    mCache.insert(cacheKey(key), cached);
 }
 
 QVariant EncryptedSettings::value(const QString &key, const QVariant &defaultValue)
 {
-    return QVariant(decrypt(key, QSettings::value(hash(key), encrypt(key, defaultValue.toString())).toString()));
+    // A cache hit does not touch QSettings, so it does not wait for a flush in progress
+    const QString cachedKey = cacheKey(key);
+    CachedValue cached;
+    bool found = false;
+    {
+        QReadLocker lock(&mCacheLock);
+        auto it = mCache.constFind(cachedKey);
+        if (it != mCache.constEnd())
+        {
+            cached = it.value();
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        {
+            QMutexLocker settingsLock(&mSettingsMutex);
+            QVariant encrypted = QSettings::value(hash(key));
+            cached.exists = encrypted.isValid();
+            cached.value = cached.exists ? decrypt(key, encrypted.toString()) : QString();
+        }
+
+        QWriteLocker lock(&mCacheLock);
+        mCache.insert(cachedKey, cached);
+    }
+
+    return QVariant(cached.exists ? cached.value : defaultValue.toString());
 }
 
 void EncryptedSettings::beginGroup(const QString &prefix)
 {
+    QMutexLocker settingsLock(&mSettingsMutex);
     QSettings::beginGroup(hash(prefix));
+    mGroup = QSettings::group();
 }
 
 void EncryptedSettings::beginGroup(int numGroup)
 {
-     QSettings::beginGroup(QSettings::childGroups().at(numGroup));
+    QMutexLocker settingsLock(&mSettingsMutex);
+    QSettings::beginGroup(QSettings::childGroups().at(numGroup));
+    mGroup = QSettings::group();
 }
 
 void EncryptedSettings::endGroup()
 {
+    QMutexLocker settingsLock(&mSettingsMutex);
     QSettings::endGroup();
+    mGroup = QSettings::group();
 }
 
 int EncryptedSettings::numChildGroups()
 {
+    QMutexLocker settingsLock(&mSettingsMutex);
     return QSettings::childGroups().size();
 }
 
 bool EncryptedSettings::containsGroup(QString groupName)
 {
+    QMutexLocker settingsLock(&mSettingsMutex);
     return QSettings::childGroups().contains(hash(groupName));
 }
 
 bool EncryptedSettings::isGroupEmpty()
 {
+    QMutexLocker settingsLock(&mSettingsMutex);
     return QSettings::group().isEmpty();
 }
 
 void EncryptedSettings::remove(const QString &key)
 {
+    QMutexLocker settingsLock(&mSettingsMutex);
     if (!key.length())
     {
+        // The whole group, and its subgroups
         QSettings::remove(QString::fromLatin1(""));
+        invalidateCache();
+        mDirty = true;
+        ++mWritesRequested;
     }
     else
     {
         QSettings::remove(hash(key));
+        mDirty = true;
+        ++mWritesRequested;
+        QWriteLocker lock(&mCacheLock);
+        mCache.remove(cacheKey(key));
     }
 }
 
 void EncryptedSettings::clear()
 {
+    QMutexLocker settingsLock(&mSettingsMutex);
     QSettings::clear();
+    invalidateCache();
+    mDirty = true;
+    ++mWritesRequested;
 }
 
 void EncryptedSettings::sync()
 {
-    QSettings::sync();
+    if (mDirty)
+    {
+        // Handled in event(), in the thread of this object
+        QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
+    }
+}
+
+void EncryptedSettings::flushNow()
+{
+    QMutexLocker flushLock(&mFlushMutex);
+    if (!mDirty.exchange(false))
+    {
+        return;
+    }
+
+    {
+        // QSettings replaces the file atomically
+        QMutexLocker settingsLock(&mSettingsMutex);
+        QSettings::sync();
+    }
+    QFile::remove(this->fileName().append(QString::fromUtf8(".bak")));
+    QFile::copy(this->fileName(), this->fileName().append(QString::fromUtf8(".bak")));
+    ++mDiskFlushes;
+}
+
+quint64 EncryptedSettings::getWritesRequested() const
+{
+    return mWritesRequested;
+}
+
+quint64 EncryptedSettings::getDiskFlushes() const
+{
+    return mDiskFlushes;
 }
  
+QString EncryptedSettings::cacheKey(const QString& key) const
+{
+    // The encryption of a value depends on its group too. The group is read from mGroup, as
+    // QSettings may be flushing in another thread
+    return mGroup + QLatin1Char('/') + key;
+}
+
+void EncryptedSettings::invalidateCache()
+{
+    QWriteLocker lock(&mCacheLock);
+    mCache.clear();
+}
+
 //Simplified XOR fun
 QByteArray EncryptedSettings::XOR(const QByteArray& key, const QByteArray& data) const
 {
@@ -153,10 +287,12 @@ QString EncryptedSettings::hash(const QString key) const
 
 bool EncryptedSettings::event(QEvent *event)
 {
+    // Posted by QSettings on every change: the flush is delayed to write several changes at once
     if (event->type() == QEvent::UpdateRequest) {
-        QSettings::sync();
-        QFile::remove(this->fileName().append(QString::fromUtf8(".bak")));
-        QFile::copy(this->fileName(), this->fileName().append(QString::fromUtf8(".bak")));
+        if (!mFlushTimer.isActive())
+        {
+            mFlushTimer.start();
+        }
         return true;
     }
     return QObject::event(event);
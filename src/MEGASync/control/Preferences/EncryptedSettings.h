@@ -1,10 +1,17 @@
 #ifndef ENCRYPTEDSETTINGS_H
 #define ENCRYPTEDSETTINGS_H
 
+#include <QCryptographicHash>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
 #include <QSettings>
-#include <QVariant>
 #include <QStringList>
-#include <QCryptographicHash>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariant>
+
+#include <atomic>
 
 class EncryptedSettings : protected QSettings
 {
@@ -12,6 +19,10 @@ class EncryptedSettings : protected QSettings
 
 public:
     explicit EncryptedSettings(QString file);
+    ~EncryptedSettings();
+
+    // The changes are written to disk together, FLUSH_INTERVAL_MS at most after the first one
+    static constexpr int FLUSH_INTERVAL_MS = 1000;
 
     void setValue(const QString & key, const QVariant & value);
     QVariant value(const QString & key, const QVariant & defaultValue = QVariant());
@@ -23,14 +34,45 @@ public:
     bool isGroupEmpty();
     void remove(const QString & key);
     void clear();
+    // Requests a flush of the pending changes, which is done with the next ones
     void sync();
+    // Writes the pending changes to disk right now, in the calling thread
+    void flushNow();
+
+    quint64 getWritesRequested() const;
+    quint64 getDiskFlushes() const;
 
 protected:
+    // Decrypted values already read or written, by group and key. Values that are not in the file
+    // are cached too, so the default value is returned without touching the file
+    struct CachedValue
+    {
+        bool exists = false;
+        QString value;
+    };
+
+    QString cacheKey(const QString& key) const;
+    void invalidateCache();
+
     QByteArray XOR(const QByteArray &key, const QByteArray& data) const;
     QString encrypt(const QString key, const QString value) const;
     QString decrypt(const QString key, const QString value) const;
     QString hash(const QString key) const;
     QByteArray encryptionKey;
+    QHash<QString, CachedValue> mCache;
+    // Current group, kept in sync with the QSettings one by beginGroup and endGroup
+    QString mGroup;
+    mutable QReadWriteLock mCacheLock;
+
+    // QSettings is not thread safe: it is shared by the callers and the flush thread
+    QMutex mSettingsMutex;
+    // Only one flush writes the file and its backup at a time
+    QMutex mFlushMutex;
+    QThreadPool mFlushThreadPool;
+    QTimer mFlushTimer;
+    std::atomic<bool> mDirty{false};
+    std::atomic<quint64> mWritesRequested{0};
+    std::atomic<quint64> mDiskFlushes{0};
 
     bool event(QEvent* event) override;
 };
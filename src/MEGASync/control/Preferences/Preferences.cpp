@@ -223,6 +223,8 @@ const QString Preferences::lastUpdateVersionKey     = QString::fromLatin1("lastU
 const QString Preferences::previousCrashesKey       = QString::fromLatin1("previousCrashes");
 const QString Preferences::lastRebootKey            = QString::fromLatin1("lastReboot");
 const QString Preferences::lastExitKey = QString::fromLatin1("lastExit");
+const QString Preferences::flightRecorderSizeMBKey = QString::fromLatin1("flightRecorderSizeMB");
+const QString Preferences::fileLogLevelKey = QString::fromLatin1("fileLogLevel");
 const QString Preferences::disableOverlayIconsKey   = QString::fromLatin1("disableOverlayIcons");
 const QString Preferences::disableFileVersioningKey = QString::fromLatin1("disableFileVersioning");
 const QString Preferences::disableLeftPaneIconsKey  = QString::fromLatin1("disableLeftPaneIcons");
@@ -308,8 +310,12 @@ const Preferences::ThemeType Preferences::defaultTheme = Preferences::ThemeType:
 const bool Preferences::defaultAskOnExclusionRemove = true;
 
 const int Preferences::defaultLastVersion = 0;
+const int Preferences::defaultFlightRecorderSizeMB = 32;
+const int Preferences::defaultFileLogLevel = MegaApi::LOG_LEVEL_MAX;
 
 const int Preferences::minSyncStateChangeProcessingIntervalMs = 200;
+const int Preferences::minWebclientProgressPushIntervalMs = 250;
+const int Preferences::defaultWebclientProgressPushIntervalMs = 1000;
 
 const QString Preferences::dontShowExportLinkDialogKey =
     QString::fromLatin1("dontShowExportLinkDialogKey");
@@ -2249,6 +2255,86 @@ void Preferences::setLastExit(long long value)
     mutex.unlock();
 }
 
+int Preferences::getFlightRecorderSizeMB()
+{
+    mutex.lock();
+    QString currentAccount;
+    if (logged())
+    {
+        mSettings->endGroup();
+        currentAccount = mSettings->value(currentAccountKey).toString();
+    }
+
+    int value = getValue<int>(flightRecorderSizeMBKey, defaultFlightRecorderSizeMB);
+
+    if (!currentAccount.isEmpty())
+    {
+        mSettings->beginGroup(currentAccount);
+    }
+
+    mutex.unlock();
+    return value;
+}
+
+void Preferences::setFlightRecorderSizeMB(int value)
+{
+    mutex.lock();
+    QString currentAccount;
+    if (logged())
+    {
+        mSettings->endGroup();
+        currentAccount = mSettings->value(currentAccountKey).toString();
+    }
+
+    mSettings->setValue(flightRecorderSizeMBKey, value);
+
+    if (!currentAccount.isEmpty())
+    {
+        mSettings->beginGroup(currentAccount);
+    }
+    mutex.unlock();
+}
+
+int Preferences::getFileLogLevel()
+{
+    mutex.lock();
+    QString currentAccount;
+    if (logged())
+    {
+        mSettings->endGroup();
+        currentAccount = mSettings->value(currentAccountKey).toString();
+    }
+
+    int value = getValue<int>(fileLogLevelKey, defaultFileLogLevel);
+
+    if (!currentAccount.isEmpty())
+    {
+        mSettings->beginGroup(currentAccount);
+    }
+
+    mutex.unlock();
+    return value;
+}
+
+void Preferences::setFileLogLevel(int value)
+{
+    mutex.lock();
+    QString currentAccount;
+    if (logged())
+    {
+        mSettings->endGroup();
+        currentAccount = mSettings->value(currentAccountKey).toString();
+    }
+
+    mSettings->setValue(fileLogLevelKey, value);
+
+    if (!currentAccount.isEmpty())
+    {
+        mSettings->beginGroup(currentAccount);
+    }
+    mutex.unlock();
+}
+
 QSet<MegaHandle> Preferences::getDisabledSyncTags()
 {
     QMutexLocker qm(&mutex);
@@ -2408,7 +2494,7 @@ bool Preferences::isCrashed()
 void Preferences::setCrashed(bool value)
 {
     setValueConcurrently(isCrashedKey, value);
-    sync();
+    flushNow();
 }
 
 QString Preferences::crashedUserID()
@@ -2419,7 +2505,7 @@ QString Preferences::crashedUserID()
 void Preferences::setCrashedUserID(const QString& value)
 {
     setValueConcurrently(crashedUserIDKey, value);
-    sync();
+    flushNow();
 }
 
 bool Preferences::getGlobalPaused()
@@ -2591,6 +2677,23 @@ void Preferences::sync()
     mSettings->sync();
 }
 
+void Preferences::flushNow()
+{
+    QMutexLocker locker(&mutex);
+    if (!mSettings)
+    {
+        return;
+    }
+
+    mSettings->flushNow();
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG,
+                 QString::fromUtf8("Preferences flushed: %1 writes requested, %2 disk flushes")
+                     .arg(mSettings->getWritesRequested())
+                     .arg(mSettings->getDiskFlushes())
+                     .toUtf8()
+                     .constData());
+}
+
 void Preferences::setThemeType(ThemeType theme)
 {
     auto currentValue(getThemeType());
@@ -351,6 +351,12 @@ public:
     void setLastReboot(long long value);
     long long getLastExit();
     void setLastExit(long long value);
+    // In-memory ring of the last log lines at full verbosity, 0 to disable it
+    int getFlightRecorderSizeMB();
+    void setFlightRecorderSizeMB(int value);
+    // Lines with a higher (more verbose) level are only kept in the flight recorder
+    int getFileLogLevel();
+    void setFileLogLevel(int value);
     QSet<mega::MegaHandle> getDisabledSyncTags();
     void setDisabledSyncTags(QSet<mega::MegaHandle> disabledSyncs);
     bool getNotifyDisabledSyncsOnLogin();
@@ -409,7 +415,10 @@ public:
     void clearTempTransfersPath();
     void clearTemporalBandwidth();
     void clearAll();
+    // The changes are written to disk in batches, sync() only asks for the next one
     void sync();
+    // Writes the pending changes now, for the shutdown and crash paths
+    void flushNow();
 
     void setDontShowExportLinkDialog(bool value);
     bool getDontShowExportLinkDialog();
@@ -602,6 +611,8 @@ public:
 
     //In this section, you need to move the keys to make them accessible from outside
     static const int minSyncStateChangeProcessingIntervalMs;
+    static const int minWebclientProgressPushIntervalMs;
+    static const int defaultWebclientProgressPushIntervalMs;
 
 protected:
     QMutex mutex;
@@ -742,6 +753,8 @@ protected:
     static const QString previousCrashesKey;
     static const QString lastRebootKey;
     static const QString lastExitKey;
+    static const QString flightRecorderSizeMBKey;
+    static const QString fileLogLevelKey;
     static const QString disableOverlayIconsKey;
     static const QString disableFileVersioningKey;
     static const QString disableLeftPaneIconsKey;
@@ -842,6 +855,8 @@ protected:
     static const bool defaultSystemTrayPromptSuppressed;
     static const bool defaultAskOnExclusionRemove;
     static const int defaultLastVersion;
+    static const int defaultFlightRecorderSizeMB;
+    static const int defaultFileLogLevel;
 
     static const ThemeType defaultTheme;
 
@@ -2,6 +2,7 @@
 
 // clang-format off
 #include "Platform.h"
+#include "ChunkedLogArchive.h"
 #include "gzjoin.h"
 #include "MegaApiSynchronizedRequest.h"
 #include "MegaApplication.h"
@@ -26,6 +27,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 #ifndef WIN32
 #include "megaapi.h"
@@ -1139,30 +1141,77 @@ QString Utilities::joinLogZipFiles(MegaApi *megaApi, const QDateTime *timestampS
         gzinit(&crc, &tot, pFile);
 
         QFileInfoList logFiles = logDir.entryInfoList(QStringList() << QString::fromUtf8("MEGAsync.[0-9]*.log"), QDir::Files);
-        int nLogFiles = logFiles.count();
 
         std::sort(logFiles.begin(), logFiles.end(), [](const QFileInfo &v1, const QFileInfo &v2){
             return v1.fileName().remove(QRegExp(QString::fromUtf8("[^\\d]"))).toInt() > v2.fileName().remove(QRegExp(QString::fromUtf8("[^\\d]"))).toInt();} );
 
+        // Logs with index are copied chunk by chunk, the rest (previous versions) whole
+        struct LogToJoin
+        {
+            QFileInfo file;
+            bool indexed;
+            QVector<ChunkedLogArchive::Chunk> chunks;
+        };
+        QVector<LogToJoin> logsToJoin;
+
         foreach (QFileInfo i, logFiles)
         {
-            --nLogFiles;
+            bool isLastLog = i.fileName() == QString::fromUtf8("MEGAsync.0.log"); //keep at least the last log
+            LogToJoin log{i, false, {}};
+            log.indexed = ChunkedLogArchive::readIndex(i.absoluteFilePath(), log.chunks);
 
             if (timestampSince)
             {
-                if ( i.lastModified() < *timestampSince && i.fileName() != QString::fromUtf8("MEGAsync.0.log")) //keep at least the last log
+                if (log.indexed)
+                {
+                    auto chunks = ChunkedLogArchive::chunksSince(log.chunks, *timestampSince);
+                    if (chunks.isEmpty() && isLastLog && !log.chunks.isEmpty())
+                    {
+                        chunks.append(log.chunks.last());
+                    }
+                    log.chunks = chunks;
+
+                    if (log.chunks.isEmpty())
+                    {
+                        continue;
+                    }
+                }
+                else if (i.lastModified() < *timestampSince && !isLastLog)
                 {
                     continue;
                 }
             }
 
+            logsToJoin.append(log);
+        }
+
+        for (int index = 0; index < logsToJoin.size(); ++index)
+        {
+            const auto& log = logsToJoin.at(index);
+            bool isLastFile = index == logsToJoin.size() - 1;
+
             try
             {
+                if (log.indexed)
+                {
+                    if (!ChunkedLogArchive::copyChunks(log.file.absoluteFilePath(), log.chunks, pFile, &crc, &tot))
+                    {
+                        throw std::runtime_error("Unable to copy the chunks of " + log.file.fileName().toStdString());
+                    }
+
+                    if (isLastFile)
+                    {
+                        ChunkedLogArchive::finish(pFile, crc, tot);
+                    }
+                }
+                else
+                {
 #ifdef _WIN32
-                gzcopy(i.absoluteFilePath().toStdWString().c_str(), nLogFiles, &crc, &tot, pFile);
+                    gzcopy(log.file.absoluteFilePath().toStdWString().c_str(), !isLastFile, &crc, &tot, pFile);
 #else
-                gzcopy(i.absoluteFilePath().toUtf8().constData(), nLogFiles, &crc, &tot, pFile);
+                    gzcopy(log.file.absoluteFilePath().toUtf8().constData(), !isLastFile, &crc, &tot, pFile);
 #endif
+                }
             }
             catch (const std::exception& e)
             {
@@ -1176,6 +1225,11 @@ QString Utilities::joinLogZipFiles(MegaApi *megaApi, const QDateTime *timestampS
             }
         }
 
+        if (logsToJoin.isEmpty())
+        {
+            ChunkedLogArchive::finish(pFile, crc, tot);
+        }
+
         fclose(pFile);
         return joinLogsFile.absoluteFilePath();
     }
@@ -4,6 +4,7 @@ set(DESKTOP_APP_CONTROL_HEADERS
     ${CMAKE_CURRENT_LIST_DIR}/AppState.h
     ${CMAKE_CURRENT_LIST_DIR}/AppStatsEvents.h
     ${CMAKE_CURRENT_LIST_DIR}/AsyncHandler.h
+    ${CMAKE_CURRENT_LIST_DIR}/ChunkedLogArchive.h
     ${CMAKE_CURRENT_LIST_DIR}/ConnectivityChecker.h
     ${CMAKE_CURRENT_LIST_DIR}/CrashHandler.h
     ${CMAKE_CURRENT_LIST_DIR}/DialogOpener.h
@@ -20,6 +21,7 @@ set(DESKTOP_APP_CONTROL_HEADERS
     ${CMAKE_CURRENT_LIST_DIR}/LinkProcessor.h
     ${CMAKE_CURRENT_LIST_DIR}/LinkObject.h
     ${CMAKE_CURRENT_LIST_DIR}/LoginController.h
+    ${CMAKE_CURRENT_LIST_DIR}/LogRingBuffer.h
     ${CMAKE_CURRENT_LIST_DIR}/MegaDownloader.h
     ${CMAKE_CURRENT_LIST_DIR}/MegaSyncLogger.h
     ${CMAKE_CURRENT_LIST_DIR}/MegaUploader.h
@@ -37,6 +39,7 @@ set(DESKTOP_APP_CONTROL_HEADERS
     ${CMAKE_CURRENT_LIST_DIR}/gzjoin.h
     ${CMAKE_CURRENT_LIST_DIR}/qrcodegen.h
     ${CMAKE_CURRENT_LIST_DIR}/MegaApiSynchronizedRequest.h
+    ${CMAKE_CURRENT_LIST_DIR}/MpscRingBuffer.h
     ${CMAKE_CURRENT_LIST_DIR}/MergeMEGAFolders.h
     ${CMAKE_CURRENT_LIST_DIR}/MEGAPathCreator.h
     ${CMAKE_CURRENT_LIST_DIR}/MoveToMEGABin.h
@@ -61,6 +64,7 @@ set(DESKTOP_APP_CONTROL_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/AccountStatusController.cpp
     ${CMAKE_CURRENT_LIST_DIR}/AppState.cpp
     ${CMAKE_CURRENT_LIST_DIR}/AppStatsEvents.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ChunkedLogArchive.cpp
     ${CMAKE_CURRENT_LIST_DIR}/ConnectivityChecker.cpp
     ${CMAKE_CURRENT_LIST_DIR}/CrashHandler.cpp
     ${CMAKE_CURRENT_LIST_DIR}/DialogOpener.cpp
@@ -9,6 +9,7 @@
 #include <TransfersModel.h>
 
 #include <QCloseEvent>
+#include <QDateTime>
 #include <QRegExp>
 
 using namespace mega;
@@ -26,6 +27,12 @@ BugReportDialog::BugReportDialog(QWidget* parent, MegaSyncLogger& logger):
     ui->bSubmit->setDefault(true);
     ui->bSubmit->setEnabled(false);
 
+    // Item data is the number of hours of log to attach, 0 for the whole log
+    ui->cbLogPeriod->addItem(tr("Whole log"), 0);
+    ui->cbLogPeriod->addItem(tr("Last hour"), 1);
+    ui->cbLogPeriod->addItem(tr("Last 24 hours"), 24);
+    ui->cbLogPeriod->setEnabled(ui->cbAttachLogs->isChecked());
+
     mController->attachLogToReport(ui->cbAttachLogs->isChecked());
 
     connect(mController.get(),
@@ -59,6 +66,7 @@ BugReportDialog::BugReportDialog(QWidget* parent, MegaSyncLogger& logger):
             [this](bool checked)
             {
                 mController->attachLogToReport(checked);
+                ui->cbLogPeriod->setEnabled(checked);
             });
 
     connect(ui->teDescribeBug,
@@ -206,6 +214,10 @@ void BugReportDialog::onReportFailed()
 
 void BugReportDialog::onSubmitClicked()
 {
+    const int hours = ui->cbLogPeriod->currentData().toInt();
+    mController->setLogTimeWindow(hours > 0 ?
+                                      QDateTime::currentDateTimeUtc().addSecs(-hours * 3600) :
+                                      QDateTime());
     mController->submitReport();
 }
 
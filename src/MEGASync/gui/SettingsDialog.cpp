@@ -787,7 +787,7 @@ void SettingsDialog::on_cOverlayIcons_toggled(bool checked)
 
     setOverlayCheckboxEnabled(false, checked);
 
-#ifdef Q_OS_MACOS
+#if defined(Q_OS_MACOS) || defined(Q_OS_LINUX)
     Platform::getInstance()->notifyRestartSyncFolders();
 #endif
     mApp->notifyChangeToAllFolders();
@@ -16,6 +16,9 @@
 #include <QToolTip>
 
 const char* INDEX_PROPERTY = "INDEX";
+// The first page is small to show the first results soon, the next ones grow to need less queries
+const int SEARCH_FIRST_PAGE_SIZE = 100;
+const int SEARCH_MAX_PAGE_SIZE = 10000;
 
 NodeRequester::NodeRequester(NodeSelectorModel* model):
     QObject(nullptr),
@@ -77,6 +80,7 @@ void NodeRequester::requestNodeAndCreateChildren(NodeSelectorModelItem* item,
             {
                 lockDataMutex(true);
                 item->createChildItems(std::move(childNodesFiltered));
+                addChildrenByHandle(item);
                 lockDataMutex(false);
                 emit nodesReady(item);
             }
@@ -84,50 +88,134 @@ void NodeRequester::requestNodeAndCreateChildren(NodeSelectorModelItem* item,
     }
 }
 
-void NodeRequester::search(const QString& text, NodeSelectorModelItemSearch::Types typesAllowed)
+void NodeRequester::search(const QString& text,
+                           NodeSelectorModelItemSearch::Types typesAllowed,
+                           int searchId)
 {
-    if (text.isEmpty())
+    if (text.isEmpty() || !isCurrentSearch(searchId))
     {
         return;
     }
+    mSearchCanceled = false;
+
+    if (refineSearch(text, typesAllowed))
+    {
+        emit searchItemsCreated();
+        return;
+    }
 
     {
         QMutexLocker a(&mSearchMutex);
         QMutexLocker d(&mDataMutex);
         qDeleteAll(mRootItems);
         mRootItems.clear();
+        mItemsByHandle.clear();
     }
-    mSearchCanceled = false;
+    mLastSearchText = text;
+    mLastSearchTypes = typesAllowed;
+    mLastSearchComplete = false;
 
     std::unique_ptr<mega::MegaSearchFilter> searchFilter(mega::MegaSearchFilter::createInstance());
     searchFilter->byName(text.toUtf8().constData());
 
-    auto nodeList = std::unique_ptr<mega::MegaNodeList>(
-        MegaSyncApp->getMegaApi()->search(searchFilter.get(),
-                                          mega::MegaApi::ORDER_NONE,
-                                          mCancelToken.get()));
-    QList<NodeSelectorModelItem*> items;
     mSearchedTypes = NodeSelectorModelItemSearch::Type::NONE;
+    size_t offset(0);
+    int pageSize(SEARCH_FIRST_PAGE_SIZE);
+    bool firstPage(true);
+
+    while (true)
+    {
+        std::unique_ptr<mega::MegaSearchPage> searchPage(
+            mega::MegaSearchPage::createInstance(offset, static_cast<size_t>(pageSize)));
+        auto nodeList = std::unique_ptr<mega::MegaNodeList>(
+            MegaSyncApp->getMegaApi()->search(searchFilter.get(),
+                                              // The pages are read by offset, so the order must be
+                                              // stable for them not to skip or repeat nodes
+                                              mega::MegaApi::ORDER_DEFAULT_ASC,
+                                              mCancelToken.get(),
+                                              searchPage.get()));
+        if (!nodeList || isSearchCanceled(searchId))
+        {
+            return;
+        }
 
-    for (int i = 0; i < nodeList->size(); i++)
-    {
-        auto item = createSearchItem(nodeList->get(i), typesAllowed);
-        if (item)
+        QList<NodeSelectorModelItem*> items;
+        for (int i = 0; i < nodeList->size(); i++)
         {
-            items.append(item);
+            auto item = createSearchItem(nodeList->get(i), typesAllowed);
+            if (item)
+            {
+                items.append(item);
+            }
         }
+
+        if (isSearchCanceled(searchId))
+        {
+            qDeleteAll(items);
+            return;
+        }
+
+        if (firstPage)
+        {
+            // The model is reset with the first page, the next ones are inserted as new rows
+            QMutexLocker d(&mDataMutex);
+            appendRootItems(items);
+            emit searchItemsCreated();
+            firstPage = false;
+        }
+        else if (!items.isEmpty())
+        {
+            emit searchItemsPageCreated(items, searchId);
+        }
+
+        if (nodeList->size() < pageSize)
+        {
+            mLastSearchComplete = true;
+            return;
+        }
+
+        offset += static_cast<size_t>(nodeList->size());
+        pageSize = std::min(pageSize * 2, SEARCH_MAX_PAGE_SIZE);
     }
+}
 
-    if (isAborted() || mSearchCanceled)
+// When the text only adds characters to the last complete search, its results are a subset of the
+// current ones, so there is no need to search the whole account again
+bool NodeRequester::refineSearch(const QString& text,
+                                 NodeSelectorModelItemSearch::Types typesAllowed)
+{
+    const QChar wildcard(QLatin1Char('*'));
+    if (!mLastSearchComplete || typesAllowed != mLastSearchTypes ||
+        !text.startsWith(mLastSearchText, Qt::CaseInsensitive) || text.contains(wildcard))
     {
-        qDeleteAll(items);
+        return false;
     }
-    else
+
+    QMutexLocker a(&mSearchMutex);
+    QMutexLocker d(&mDataMutex);
+    auto previousItems(mRootItems);
+    mRootItems.clear();
+    mItemsByHandle.clear();
+    mSearchedTypes = NodeSelectorModelItemSearch::Type::NONE;
+
+    QList<NodeSelectorModelItem*> items;
+    for (auto item: previousItems)
     {
-        QMutexLocker d(&mDataMutex);
-        mRootItems.append(items);
-        emit searchItemsCreated();
+        auto searchItem(static_cast<NodeSelectorModelItemSearch*>(item));
+        if (QString::fromUtf8(item->getNode()->getName()).contains(text, Qt::CaseInsensitive))
+        {
+            mSearchedTypes |= searchItem->getType();
+            items.append(item);
+        }
+        else
+        {
+            delete item;
+        }
     }
+    appendRootItems(items);
+    mLastSearchText = text;
+
+    return true;
 }
 
 void NodeRequester::addSearchRootItem(QList<std::shared_ptr<mega::MegaNode>> nodes,
@@ -152,7 +240,7 @@ void NodeRequester::addSearchRootItem(QList<std::shared_ptr<mega::MegaNode>> nod
         if (!items.isEmpty())
         {
             QMutexLocker d(&mDataMutex);
-            mRootItems.append(items);
+            appendRootItems(items);
             emit rootItemsAdded();
         }
     }
@@ -219,7 +307,8 @@ void NodeRequester::createCloudDriveRootItem()
         auto item = new NodeSelectorModelItemCloudDrive(std::move(root), mShowFiles);
         if (item->isValid())
         {
-            mRootItems.append(item);
+            QMutexLocker d(&mDataMutex);
+            appendRootItems({item});
         }
         else
         {
@@ -303,7 +392,10 @@ void NodeRequester::createIncomingSharesRootItems(std::shared_ptr<mega::MegaNode
     }
     else
     {
-        mRootItems.append(items);
+        {
+            QMutexLocker d(&mDataMutex);
+            appendRootItems(items);
+        }
         emit megaIncomingSharesRootItemsCreated();
     }
 }
@@ -346,7 +438,10 @@ void NodeRequester::addIncomingSharesRootItem(std::shared_ptr<mega::MegaNode> no
         }
         else
         {
-            mRootItems.append(item);
+            {
+                QMutexLocker d(&mDataMutex);
+                appendRootItems({item});
+            }
             emit rootItemsAdded();
         }
     }
@@ -365,7 +460,10 @@ void NodeRequester::createRubbishRootItems()
             mShowFiles);
         if (item->isValid())
         {
-            mRootItems.append(item);
+            {
+                QMutexLocker d(&mDataMutex);
+                appendRootItems({item});
+            }
             emit megaRubbishRootItemsCreated();
         }
         else
@@ -390,7 +488,8 @@ void NodeRequester::createBackupRootItems(mega::MegaHandle backupsHandle)
                 // Here we are setting my backups node as vault node in the item, it is not the same
                 // vault node that we get doing megaapi->getVaultNode(), we have to hide it here
                 // thats why are doing this trick. The real vault is the parent of my backups folder
-                mRootItems.append(item);
+                QMutexLocker d(&mDataMutex);
+                appendRootItems({item});
             }
         }
     }
@@ -408,6 +507,7 @@ void NodeRequester::onAddNodesRequested(QList<std::shared_ptr<mega::MegaNode>> n
     auto lastChild = parentItem->getNumChildren();
     lockDataMutex(true);
     auto childrenItem = parentItem->addNodes(std::move(newNodes));
+    addItemsByHandle(childrenItem);
     lockDataMutex(false);
     foreach(auto& childItem, childrenItem)
     {
@@ -431,14 +531,22 @@ void NodeRequester::onAddNodesRequested(QList<std::shared_ptr<mega::MegaNode>> n
 void NodeRequester::removeItem(NodeSelectorModelItem* item)
 {
     QMutexLocker lock(&mDataMutex);
-    item->deleteLater();
+    if (item)
+    {
+        auto handle(item->getNode()->getHandle());
+        if (mItemsByHandle.value(handle) == item)
+        {
+            mItemsByHandle.remove(handle);
+        }
+        item->deleteLater();
+    }
 }
 
 void NodeRequester::removeRootItem(NodeSelectorModelItem* item)
 {
     QMutexLocker lock(&mDataMutex);
     item->deleteLater();
-    mRootItems.removeOne(item);
+    takeRootItem(item);
     emit rootItemsDeleted();
 }
 
@@ -449,16 +557,11 @@ void NodeRequester::removeRootItem(std::shared_ptr<mega::MegaNode> node)
         return;
     }
 
-    auto rootFound = std::find_if(mRootItems.begin(),
-                                  mRootItems.end(),
-                                  [node](NodeSelectorModelItem* item)
-                                  {
-                                      return item->getNode()->getHandle() == node->getHandle();
-                                  });
-
-    if (rootFound != mRootItems.end())
+    QMutexLocker lock(&mDataMutex);
+    NodeSelectorModelItem* rootFound(mItemsByHandle.value(node->getHandle()));
+    if (rootIndexOfLocked(rootFound) >= 0)
     {
-        mRootItems.removeOne(*rootFound);
+        takeRootItem(rootFound);
         emit rootItemsDeleted();
     }
 }
@@ -472,7 +575,7 @@ int NodeRequester::rootIndexSize() const
 int NodeRequester::rootIndexOf(NodeSelectorModelItem* item)
 {
     QMutexLocker lock(&mDataMutex);
-    return mRootItems.indexOf(item);
+    return rootIndexOfLocked(item);
 }
 
 NodeSelectorModelItem* NodeRequester::getRootItem(int index) const
@@ -481,7 +584,91 @@ NodeSelectorModelItem* NodeRequester::getRootItem(int index) const
     return mRootItems.at(index);
 }
 
-void NodeRequester::restartSearch()
+NodeSelectorModelItem* NodeRequester::findItemByHandle(mega::MegaHandle handle, int& row) const
+{
+    QMutexLocker lock(&mDataMutex);
+    NodeSelectorModelItem* item(mItemsByHandle.value(handle));
+    if (item && item->getNode()->getHandle() == handle)
+    {
+        // The item may have been taken from its parent or from the roots and not deleted yet
+        auto parent(item->getParent());
+        row = parent ? parent->indexOf(item) : rootIndexOfLocked(item);
+        if (row >= 0)
+        {
+            return item;
+        }
+    }
+
+    row = -1;
+    return nullptr;
+}
+
+void NodeRequester::addItemsByHandle(const QList<QPointer<NodeSelectorModelItem>>& items)
+{
+    for (const auto& item: items)
+    {
+        if (item)
+        {
+            mItemsByHandle.insert(item->getNode()->getHandle(), item);
+        }
+    }
+}
+
+void NodeRequester::addChildrenByHandle(NodeSelectorModelItem* item)
+{
+    for (int i = 0; i < item->getNumChildren(); ++i)
+    {
+        auto child(item->getChild(i));
+        if (child)
+        {
+            mItemsByHandle.insert(child->getNode()->getHandle(), child);
+        }
+    }
+}
+
+void NodeRequester::appendRootItems(const QList<NodeSelectorModelItem*>& items)
+{
+    for (auto item: items)
+    {
+        item->setRow(mRootItems.size());
+        mRootItems.append(item);
+        mItemsByHandle.insert(item->getNode()->getHandle(), item);
+    }
+}
+
+void NodeRequester::takeRootItem(NodeSelectorModelItem* item)
+{
+    auto row(rootIndexOfLocked(item));
+    if (row < 0)
+    {
+        return;
+    }
+
+    mRootItems.removeAt(row);
+    for (int i = row; i < mRootItems.size(); ++i)
+    {
+        mRootItems.at(i)->setRow(i);
+    }
+
+    auto handle(item->getNode()->getHandle());
+    if (mItemsByHandle.value(handle) == item)
+    {
+        mItemsByHandle.remove(handle);
+    }
+}
+
+int NodeRequester::rootIndexOfLocked(NodeSelectorModelItem* item) const
+{
+    if (item && !item->getParent() && item->row() >= 0 && item->row() < mRootItems.size() &&
+        mRootItems.at(item->row()) == item)
+    {
+        return item->row();
+    }
+
+    return -1;
+}
+
+int NodeRequester::restartSearch()
 {
     if (mCancelToken)
     {
@@ -489,6 +676,19 @@ void NodeRequester::restartSearch()
         mSearchCanceled = true;
         mCancelToken.reset(mega::MegaCancelToken::createInstance());
     }
+
+    return ++mSearchId;
+}
+
+bool NodeRequester::isCurrentSearch(int searchId) const
+{
+    return searchId == mSearchId;
+}
+
+void NodeRequester::addSearchItemsPage(const QList<NodeSelectorModelItem*>& items)
+{
+    QMutexLocker lock(&mDataMutex);
+    appendRootItems(items);
 }
 
 void NodeRequester::cancelCurrentRequest()
@@ -505,6 +705,11 @@ bool NodeRequester::isAborted()
     return mAborted || (mCancelToken && mCancelToken->isCancelled());
 }
 
+bool NodeRequester::isSearchCanceled(int searchId)
+{
+    return isAborted() || mSearchCanceled || !isCurrentSearch(searchId);
+}
+
 bool NodeRequester::showFiles() const
 {
     return mShowFiles.load();
@@ -2047,7 +2252,7 @@ void NodeSelectorModel::deleteNodeFromModel(const QModelIndex& index)
                 int row = parent->indexOf(item);
                 beginRemoveRows(index.parent(), row, row);
                 mNodeRequesterWorker->lockDataMutex(true);
-                auto itemToRemove = parent->findChildNode(node);
+                auto itemToRemove = parent->takeChild(item);
                 mNodeRequesterWorker->lockDataMutex(false);
                 emit removeItem(itemToRemove);
                 endRemoveRows();
@@ -2626,18 +2831,12 @@ QModelIndex NodeSelectorModel::getIndexFromNode(const std::shared_ptr<mega::Mega
 {
     if (node)
     {
-        auto childrenCount = rowCount(parent);
-        for (int row = 0; row < childrenCount; ++row)
+        int row(-1);
+        if (auto item = mNodeRequesterWorker->findItemByHandle(node->getHandle(), row))
         {
-            auto indexToCheck = index(row, 0, parent);
-            NodeSelectorModelItem* item =
-                static_cast<NodeSelectorModelItem*>(indexToCheck.internalPointer());
-            if (item)
+            if (item->getParent() == static_cast<NodeSelectorModelItem*>(parent.internalPointer()))
             {
-                if (item->getNode()->getHandle() == node->getHandle())
-                {
-                    return indexToCheck;
-                }
+                return createIndex(row, 0, item);
             }
         }
     }
@@ -2792,6 +2991,18 @@ bool NodeSelectorModel::showAccess(mega::MegaNode* node) const
 QModelIndex NodeSelectorModel::findIndexByNodeHandle(const mega::MegaHandle& handle,
                                                      const QModelIndex& parent)
 {
+    if (!parent.isValid())
+    {
+        // Every loaded item is indexed by handle, so the tree does not need to be walked
+        int row(-1);
+        if (auto item = mNodeRequesterWorker->findItemByHandle(handle, row))
+        {
+            return createIndex(row, NodeSelectorModel::Column::NODE, item);
+        }
+
+        return QModelIndex();
+    }
+
     for (int i = 0; i < rowCount(parent); ++i)
     {
         QModelIndex idx = index(i, NodeSelectorModel::Column::NODE, parent);
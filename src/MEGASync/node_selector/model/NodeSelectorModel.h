@@ -9,6 +9,7 @@
 #include "Utilities.h"
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QIcon>
 #include <QList>
 #include <QPointer>
@@ -85,12 +86,18 @@ public:
     int rootIndexSize() const;
     int rootIndexOf(NodeSelectorModelItem* item);
     NodeSelectorModelItem* getRootItem(int index) const;
+    // Constant time lookup of the loaded items, row is its position in its parent or in the roots
+    NodeSelectorModelItem* findItemByHandle(mega::MegaHandle handle, int& row) const;
 
     bool trySearchLock() const;
     void lockSearchMutex(bool state) const;
 
     void cancelCurrentRequest();
-    void restartSearch();
+    // Cancels the running search and returns the id of the next one
+    int restartSearch();
+    bool isCurrentSearch(int searchId) const;
+    // Called from the model thread, between its beginInsertRows and endInsertRows
+    void addSearchItemsPage(const QList<NodeSelectorModelItem*>& items);
 
     const NodeSelectorModelItemSearch::Types& searchedTypes() const;
 
@@ -100,7 +107,7 @@ public:
 
 public slots:
     void requestNodeAndCreateChildren(NodeSelectorModelItem* item, const QModelIndex& parentIndex);
-    void search(const QString& text, NodeSelectorModelItemSearch::Types typesAllowed);
+    void search(const QString& text, NodeSelectorModelItemSearch::Types typesAllowed, int searchId);
     void createCloudDriveRootItem();
     void createIncomingSharesRootItems(std::shared_ptr<mega::MegaNodeList> nodeList);
     void createRubbishRootItems();
@@ -127,6 +134,8 @@ signals:
     void rootItemsDeleted();
     void megaBackupRootItemsCreated();
     void searchItemsCreated();
+    // Results found after the first page, still not in the root items
+    void searchItemsPageCreated(QList<NodeSelectorModelItem*> items, int searchId);
     void nodeAdded(NodeSelectorModelItem* item);
     void nodesAdded(QList<QPointer<NodeSelectorModelItem>> item);
 
@@ -135,8 +144,16 @@ private slots:
 
 private:
     bool isAborted();
+    bool isSearchCanceled(int searchId);
+    bool refineSearch(const QString& text, NodeSelectorModelItemSearch::Types typesAllowed);
     NodeSelectorModelItem* createSearchItem(mega::MegaNode* node,
                                             NodeSelectorModelItemSearch::Types typesAllowed);
+    // Must be called with the data mutex locked
+    void addItemsByHandle(const QList<QPointer<NodeSelectorModelItem>>& items);
+    void addChildrenByHandle(NodeSelectorModelItem* item);
+    void appendRootItems(const QList<NodeSelectorModelItem*>& items);
+    void takeRootItem(NodeSelectorModelItem* item);
+    int rootIndexOfLocked(NodeSelectorModelItem* item) const;
 
     std::atomic<bool> mShowFiles{true};
     std::atomic<bool> mShowReadOnlyFolders{true};
@@ -146,10 +163,17 @@ private:
     std::atomic<bool> mNodesRequested{false};
     NodeSelectorModel* mModel;
     QList<NodeSelectorModelItem*> mRootItems;
+    // Items can be deleted without going through the requester, so entries are validated on read
+    QHash<mega::MegaHandle, QPointer<NodeSelectorModelItem>> mItemsByHandle;
     mutable QMutex mDataMutex;
     mutable QMutex mSearchMutex;
     std::shared_ptr<mega::MegaCancelToken> mCancelToken;
     NodeSelectorModelItemSearch::Types mSearchedTypes;
+    std::atomic<int> mSearchId{0};
+    // Last search, whose results can be filtered when the text is refined
+    QString mLastSearchText;
+    NodeSelectorModelItemSearch::Types mLastSearchTypes;
+    bool mLastSearchComplete{false};
 };
 
 class AddNodesQueue: public QObject
@@ -17,6 +17,7 @@ NodeSelectorModelItem::NodeSelectorModelItem(std::unique_ptr<MegaNode> node,
     mOwnerEmail(QString()),
     mStatus(Status::NONE),
     mRequestingChildren(false),
+    mRow(0),
     mShowFiles(showFiles),
     mNodeAccess(mega::MegaShare::ACCESS_OWNER),
     mNodeAccessLastUpdate(0),
@@ -80,11 +81,7 @@ void NodeSelectorModelItem::createChildItems(std::unique_ptr<mega::MegaNodeList>
             auto child = createModelItem(std::move(node), mShowFiles, this);
             if (child->isValid())
             {
-                connect(child,
-                        &NodeSelectorModelItem::destroyed,
-                        this,
-                        &NodeSelectorModelItem::onChildDestroyed);
-                mChildItems.append(child);
+                appendChild(child);
             }
             else
             {
@@ -178,7 +175,13 @@ int NodeSelectorModelItem::getNumChildren()
 
 int NodeSelectorModelItem::indexOf(NodeSelectorModelItem* item)
 {
-    return mChildItems.indexOf(item);
+    if (item && item->mRow >= 0 && item->mRow < mChildItems.size() &&
+        mChildItems.at(item->mRow) == item)
+    {
+        return item->mRow;
+    }
+
+    return -1;
 }
 
 QString NodeSelectorModelItem::getOwnerName() const
@@ -205,6 +208,7 @@ void NodeSelectorModelItem::setOwner(std::unique_ptr<mega::MegaUser> user)
 
     mOwner = std::move(user);
     mOwnerEmail = QString::fromUtf8(mOwner->getEmail());
+    invalidateSortKeys();
     mFullNameAttribute = UserAttributes::FullName::requestFullName(mOwner->getEmail());
     if (mFullNameAttribute)
     {
@@ -233,6 +237,7 @@ void NodeSelectorModelItem::setOwner(std::unique_ptr<mega::MegaUser> user)
 
 void NodeSelectorModelItem::onFullNameAttributeReady()
 {
+    invalidateSortKeys();
     emit infoUpdated(Qt::DisplayRole);
 }
 
@@ -326,11 +331,7 @@ QList<QPointer<NodeSelectorModelItem>>
         if (child->isValid())
         {
             items.append(child);
-            connect(child,
-                    &NodeSelectorModelItem::destroyed,
-                    this,
-                    &NodeSelectorModelItem::onChildDestroyed);
-            mChildItems.append(child);
+            appendChild(child);
             mChildrenCounter++;
         }
         else
@@ -341,23 +342,35 @@ QList<QPointer<NodeSelectorModelItem>>
     return items;
 }
 
-QPointer<NodeSelectorModelItem> NodeSelectorModelItem::findChildNode(std::shared_ptr<MegaNode> node)
+QPointer<NodeSelectorModelItem> NodeSelectorModelItem::takeChild(NodeSelectorModelItem* item)
 {
-    NodeSelectorModelItem* returnNode(nullptr);
+    auto row(indexOf(item));
+    if (row < 0)
+    {
+        return nullptr;
+    }
 
-    if (node)
+    mChildItems.removeAt(row);
+    // The rows of the following children move one position up
+    for (int i = row; i < mChildItems.size(); ++i)
     {
-        for (int i = 0; i < mChildItems.size(); i++)
+        if (mChildItems.at(i))
         {
-            if (mChildItems[i]->getNode()->getHandle() == node->getHandle())
-            {
-                returnNode = mChildItems.takeAt(i);
-                break;
-            }
+            mChildItems.at(i)->mRow = i;
         }
     }
 
-    return returnNode;
+    return item;
+}
+
+void NodeSelectorModelItem::appendChild(NodeSelectorModelItem* child)
+{
+    connect(child,
+            &NodeSelectorModelItem::destroyed,
+            this,
+            &NodeSelectorModelItem::onChildDestroyed);
+    child->mRow = mChildItems.size();
+    mChildItems.append(child);
 }
 
 void NodeSelectorModelItem::displayFiles(bool enable)
@@ -365,18 +378,54 @@ void NodeSelectorModelItem::displayFiles(bool enable)
     mShowFiles = enable;
 }
 
-int NodeSelectorModelItem::row()
+int NodeSelectorModelItem::row() const
 {
-    if (NodeSelectorModelItem* parent = getParent())
-    {
-        return parent->mChildItems.indexOf(const_cast<NodeSelectorModelItem*>(this));
-    }
-    return 0;
+    return mRow;
+}
+
+void NodeSelectorModelItem::setRow(int row)
+{
+    mRow = row;
 }
 
 void NodeSelectorModelItem::updateNode(std::shared_ptr<mega::MegaNode> node)
 {
+    // The sort keys are built from the node under the same lock
+    QMutexLocker lock(&mSortKeysMutex);
     mNode = node;
+    mSortKeysValid = false;
+    ++mSortKeysVersion;
+}
+
+NodeSelectorModelItem::SortKeys NodeSelectorModelItem::getSortKeys()
+{
+    QMutexLocker lock(&mSortKeysMutex);
+    if (!mSortKeysValid)
+    {
+        mSortKeys = SortKeys();
+        mSortKeys.date = mNode->getCreationTime();
+        mSortKeys.isFile = mNode->isFile();
+        mSortKeys.version = mSortKeysVersion;
+        mSortKeysValid = true;
+    }
+
+    return mSortKeys;
+}
+
+void NodeSelectorModelItem::setSortKeys(const SortKeys& keys)
+{
+    QMutexLocker lock(&mSortKeysMutex);
+    if (mSortKeysValid && keys.version == mSortKeysVersion)
+    {
+        mSortKeys = keys;
+    }
+}
+
+void NodeSelectorModelItem::invalidateSortKeys()
+{
+    QMutexLocker lock(&mSortKeysMutex);
+    mSortKeysValid = false;
+    ++mSortKeysVersion;
 }
 
 void NodeSelectorModelItem::calculateSyncStatus()
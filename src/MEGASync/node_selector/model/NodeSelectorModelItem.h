@@ -3,10 +3,13 @@
 
 #include "megaapi.h"
 
+#include <QCollator>
 #include <QIcon>
 #include <QList>
+#include <QMutex>
 
 #include <memory>
+#include <optional>
 
 namespace UserAttributes
 {
@@ -23,6 +26,19 @@ class NodeSelectorModelItem: public QObject
 public:
     static const int ICON_SIZE;
 
+    // Values compared by the proxy models to sort the items. The collator keys and the access are
+    // computed the first time they are needed
+    struct SortKeys
+    {
+        std::optional<QCollatorSortKey> name;
+        std::optional<QCollatorSortKey> owner;
+        std::optional<int> access;
+        int64_t date = 0;
+        bool isFile = false;
+        // Keys completed for a previous node or owner are not stored
+        unsigned int version = 0;
+    };
+
     enum class Status
     {
         SYNC = 0,
@@ -68,13 +84,22 @@ public:
     bool isInRubbishBin() const;
     QPointer<NodeSelectorModelItem> addNode(std::shared_ptr<mega::MegaNode> node);
     QList<QPointer<NodeSelectorModelItem>> addNodes(QList<std::shared_ptr<mega::MegaNode>> nodes);
-    QPointer<NodeSelectorModelItem> findChildNode(std::shared_ptr<mega::MegaNode> node);
+    QPointer<NodeSelectorModelItem> takeChild(NodeSelectorModelItem* item);
     void displayFiles(bool enable);
     void setChatFilesFolder();
-    int row();
+    // Position in the parent children, or in the model root items if it has no parent
+    int row() const;
+    void setRow(int row);
     void updateNode(std::shared_ptr<mega::MegaNode> node);
     void calculateSyncStatus();
 
+    // The proxy sorts from a worker thread and the GUI thread, and the node and the owner are
+    // updated from others, so the keys are copied and stored under a lock. The keys completed by
+    // the caller are kept with setSortKeys
+    SortKeys getSortKeys();
+    void setSortKeys(const SortKeys& keys);
+    void invalidateSortKeys();
+
     bool requestingChildren() const;
     void setRequestingChildren(bool newRequestingChildren);
 
@@ -90,6 +115,7 @@ protected:
     Status mStatus;
     bool mRequestingChildren;
     int mChildrenCounter;
+    int mRow;
     bool mShowFiles;
     bool mChildrenAreInit;
     mutable int mNodeAccess;
@@ -99,6 +125,10 @@ protected:
     std::shared_ptr<mega::MegaNode> mNode;
     QList<QPointer<NodeSelectorModelItem>> mChildItems;
     std::unique_ptr<mega::MegaUser> mOwner;
+    QMutex mSortKeysMutex;
+    SortKeys mSortKeys;
+    bool mSortKeysValid = false;
+    unsigned int mSortKeysVersion = 0;
 
 private slots:
     void onFullNameAttributeReady();
@@ -106,6 +136,8 @@ private slots:
     void onChildDestroyed();
 
 private:
+    void appendChild(NodeSelectorModelItem* child);
+
     virtual NodeSelectorModelItem* createModelItem(std::unique_ptr<mega::MegaNode> node,
                                                    bool showFiles,
                                                    NodeSelectorModelItem* parentItem = 0) = 0;
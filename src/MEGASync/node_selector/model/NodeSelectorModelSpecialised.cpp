@@ -473,6 +473,14 @@ NodeSelectorModelSearch::NodeSelectorModelSearch(NodeSelectorModelItemSearch::Ty
     qRegisterMetaType<NodeSelectorModelItemSearch::Types>("NodeSelectorModelItemSearch::Types");
 }
 
+NodeSelectorModelSearch::~NodeSelectorModelSearch()
+{
+    foreach(auto page, mPendingSearchPages)
+    {
+        qDeleteAll(page.first);
+    }
+}
+
 void NodeSelectorModelSearch::firstLoad()
 {
     connect(this,
@@ -488,6 +496,11 @@ void NodeSelectorModelSearch::firstLoad()
             this,
             &NodeSelectorModelSearch::onRootItemsCreated,
             Qt::QueuedConnection);
+    connect(mNodeRequesterWorker,
+            &NodeRequester::searchItemsPageCreated,
+            this,
+            &NodeSelectorModelSearch::onSearchItemsPageCreated,
+            Qt::QueuedConnection);
 }
 
 void NodeSelectorModelSearch::createRootNodes()
@@ -498,9 +511,9 @@ void NodeSelectorModelSearch::createRootNodes()
 
 void NodeSelectorModelSearch::searchByText(const QString& text)
 {
-    mNodeRequesterWorker->restartSearch();
+    auto searchId(mNodeRequesterWorker->restartSearch());
     addRootItems();
-    emit searchNodes(text, mAllowedTypes);
+    emit searchNodes(text, mAllowedTypes, searchId);
 }
 
 void NodeSelectorModelSearch::stopSearch()
@@ -634,6 +647,13 @@ bool NodeSelectorModelSearch::canCopyNodes() const
 void NodeSelectorModelSearch::proxyInvalidateFinished()
 {
     mNodeRequesterWorker->lockSearchMutex(false);
+
+    auto pendingPages(mPendingSearchPages);
+    mPendingSearchPages.clear();
+    foreach(auto page, pendingPages)
+    {
+        onSearchItemsPageCreated(page.first, page.second);
+    }
 }
 
 bool NodeSelectorModelSearch::showAccess(mega::MegaNode* node) const
@@ -655,6 +675,35 @@ void NodeSelectorModelSearch::onRootItemsCreated()
     }
 }
 
+void NodeSelectorModelSearch::onSearchItemsPageCreated(QList<NodeSelectorModelItem*> items,
+                                                       int searchId)
+{
+    // Results of a search that has been restarted or stopped since the page was found
+    if (!mNodeRequesterWorker->isCurrentSearch(searchId))
+    {
+        foreach(auto item, items)
+        {
+            item->deleteLater();
+        }
+        return;
+    }
+
+    // The proxy sorts in another thread with the source model signals blocked while the search
+    // lock is held, so the rows are inserted once it finishes (proxyInvalidateFinished)
+    if (!mNodeRequesterWorker->trySearchLock())
+    {
+        mPendingSearchPages.append(qMakePair(items, searchId));
+        return;
+    }
+
+    auto totalRows = rowCount(QModelIndex());
+    beginInsertRows(QModelIndex(), totalRows, totalRows + items.size() - 1);
+    mNodeRequesterWorker->addSearchItemsPage(items);
+    endInsertRows();
+
+    mNodeRequesterWorker->lockSearchMutex(false);
+}
+
 const NodeSelectorModelItemSearch::Types& NodeSelectorModelSearch::searchedTypes() const
 {
     return mNodeRequesterWorker->searchedTypes();
@@ -146,7 +146,7 @@ class NodeSelectorModelSearch: public NodeSelectorModel
 public:
     explicit NodeSelectorModelSearch(NodeSelectorModelItemSearch::Types allowedType,
                                      QObject* parent = 0);
-    ~NodeSelectorModelSearch() = default;
+    ~NodeSelectorModelSearch();
 
     void firstLoad() override;
     void createRootNodes() override;
@@ -179,7 +179,7 @@ protected:
     bool showAccess(mega::MegaNode* node) const override;
 
 signals:
-    void searchNodes(const QString& text, NodeSelectorModelItemSearch::Types);
+    void searchNodes(const QString& text, NodeSelectorModelItemSearch::Types, int searchId);
     void nodeTypeHasChanged();
     void requestAddSearchRootItem(QList<std::shared_ptr<mega::MegaNode>> nodes,
                                   NodeSelectorModelItemSearch::Types typesAllowed);
@@ -187,9 +187,12 @@ signals:
 
 private slots:
     void onRootItemsCreated();
+    void onSearchItemsPageCreated(QList<NodeSelectorModelItem*> items, int searchId);
 
 private:
     NodeSelectorModelItemSearch::Types mAllowedTypes;
+    // Pages received while the proxy sorts with the search lock held, with their search id
+    QList<QPair<QList<NodeSelectorModelItem*>, int>> mPendingSearchPages;
 };
 
 class NodeSelectorModelRubbish: public NodeSelectorModel
@@ -82,6 +82,10 @@ QModelIndex NodeSelectorProxyModel::getIndexFromHandle(const mega::MegaHandle& h
     {
         return QModelIndex();
     }
+    if (auto megaModel = getMegaModel())
+    {
+        return mapFromSource(megaModel->findIndexByNodeHandle(handle, QModelIndex()));
+    }
     auto megaApi = MegaSyncApp->getMegaApi();
     auto node = std::shared_ptr<mega::MegaNode>(megaApi->getNodeByHandle(handle));
     QModelIndex ret = getIndexFromNode(node);
@@ -109,32 +113,32 @@ void NodeSelectorProxyModel::deleteNode(const QModelIndex& item)
 
 bool NodeSelectorProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
 {
-    auto lIsFileVar(left.data(toInt(NodeSelectorModelRoles::IS_FILE_ROLE)));
-    auto rIsFileVar(right.data(toInt(NodeSelectorModelRoles::IS_FILE_ROLE)));
+    auto lItem(static_cast<NodeSelectorModelItem*>(left.internalPointer()));
+    auto rItem(static_cast<NodeSelectorModelItem*>(right.internalPointer()));
 
     // Logic to put the empty space always at the bottom
     {
-        if (!lIsFileVar.isValid())
+        if (!left.isValid() || !lItem)
         {
             return sortOrder() == Qt::DescendingOrder;
         }
 
-        if (!rIsFileVar.isValid())
+        if (!right.isValid() || !rItem)
         {
             return sortOrder() != Qt::DescendingOrder;
         }
     }
 
-    bool lIsFile = lIsFileVar.toBool();
-    bool rIsFile = rIsFileVar.toBool();
+    auto lKeys(lItem->getSortKeys());
+    auto rKeys(rItem->getSortKeys());
 
     auto result(false);
 
-    if (lIsFile && !rIsFile)
+    if (lKeys.isFile && !rKeys.isFile)
     {
         result = sortOrder() == Qt::DescendingOrder;
     }
-    else if (!lIsFile && rIsFile)
+    else if (!lKeys.isFile && rKeys.isFile)
     {
         result = sortOrder() != Qt::DescendingOrder;
     }
@@ -145,41 +149,70 @@ bool NodeSelectorProxyModel::lessThan(const QModelIndex& left, const QModelIndex
             (left.column() == NodeSelectorModel::Column::LAST_MODIFIED_DATE &&
              right.column() == NodeSelectorModel::Column::LAST_MODIFIED_DATE))
         {
-            result = left.data(toInt(NodeSelectorModelRoles::DATE_ROLE)).value<int64_t>() <
-                     right.data(toInt(NodeSelectorModelRoles::DATE_ROLE)).value<int64_t>();
+            result = lKeys.date < rKeys.date;
+        }
+        else if (left.column() == NodeSelectorModel::Column::USER &&
+                 right.column() == NodeSelectorModel::Column::USER)
+        {
+            result = getOwnerSortKey(left, lItem, lKeys)
+                         .compare(getOwnerSortKey(right, rItem, rKeys)) < 0;
+        }
+        else if (left.column() == NodeSelectorModel::Column::ACCESS &&
+                 right.column() == NodeSelectorModel::Column::ACCESS)
+        {
+            result = getAccessSortKey(left, lItem, lKeys) < getAccessSortKey(right, rItem, rKeys);
         }
         else
         {
-            int lStatus(0);
-            int rStatus(0);
-
-            if (lStatus != rStatus)
-            {
-                result = lStatus < rStatus;
-            }
-            else if (left.column() == NodeSelectorModel::Column::USER &&
-                     right.column() == NodeSelectorModel::Column::USER)
-            {
-                result = mCollator.compare(left.data(Qt::ToolTipRole).toString(),
-                                           right.data(Qt::ToolTipRole).toString()) < 0;
-            }
-            else if (left.column() == NodeSelectorModel::Column::ACCESS &&
-                     right.column() == NodeSelectorModel::Column::ACCESS)
-            {
-                result = left.data(toInt(NodeSelectorModelRoles::ACCESS_ROLE)).toInt() <
-                         right.data(toInt(NodeSelectorModelRoles::ACCESS_ROLE)).toInt();
-            }
-            else
-            {
-                result = mCollator.compare(left.data(Qt::DisplayRole).toString(),
-                                           right.data(Qt::DisplayRole).toString()) < 0;
-            }
+            result = getNameSortKey(left, lItem, lKeys)
+                         .compare(getNameSortKey(right, rItem, rKeys)) < 0;
         }
     }
 
     return result;
 }
 
+const QCollatorSortKey&
+    NodeSelectorProxyModel::getNameSortKey(const QModelIndex& index,
+                                           NodeSelectorModelItem* item,
+                                           NodeSelectorModelItem::SortKeys& keys) const
+{
+    if (!keys.name)
+    {
+        keys.name = mCollator.sortKey(index.data(Qt::DisplayRole).toString());
+        item->setSortKeys(keys);
+    }
+
+    return *keys.name;
+}
+
+const QCollatorSortKey&
+    NodeSelectorProxyModel::getOwnerSortKey(const QModelIndex& index,
+                                            NodeSelectorModelItem* item,
+                                            NodeSelectorModelItem::SortKeys& keys) const
+{
+    if (!keys.owner)
+    {
+        keys.owner = mCollator.sortKey(index.data(Qt::ToolTipRole).toString());
+        item->setSortKeys(keys);
+    }
+
+    return *keys.owner;
+}
+
+int NodeSelectorProxyModel::getAccessSortKey(const QModelIndex& index,
+                                             NodeSelectorModelItem* item,
+                                             NodeSelectorModelItem::SortKeys& keys) const
+{
+    if (!keys.access)
+    {
+        keys.access = index.data(toInt(NodeSelectorModelRoles::ACCESS_ROLE)).toInt();
+        item->setSortKeys(keys);
+    }
+
+    return *keys.access;
+}
+
 void NodeSelectorProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
 {
     QSortFilterProxyModel::setSourceModel(sourceModel);
@@ -58,6 +58,16 @@ signals:
 private:
     QModelIndex findIndexInParentList(mega::MegaNode* NodeToFind,
                                       QModelIndex sourceModelParent = QModelIndex());
+    // Complete the keys copied from the item and store them back in it
+    const QCollatorSortKey& getNameSortKey(const QModelIndex& index,
+                                           NodeSelectorModelItem* item,
+                                           NodeSelectorModelItem::SortKeys& keys) const;
+    const QCollatorSortKey& getOwnerSortKey(const QModelIndex& index,
+                                            NodeSelectorModelItem* item,
+                                            NodeSelectorModelItem::SortKeys& keys) const;
+    int getAccessSortKey(const QModelIndex& index,
+                         NodeSelectorModelItem* item,
+                         NodeSelectorModelItem::SortKeys& keys) const;
     QCollator mCollator;
     int mSortColumn;
     Qt::SortOrder mOrder;
@@ -5,6 +5,9 @@
 
 #include <sys/types.h>
 
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <pwd.h>
 #include <unistd.h>
 
@@ -12,7 +15,18 @@ using namespace mega;
 using namespace std;
 
 constexpr char ASCII_FILE_SEP = 0x1C;
+constexpr char ASCII_RECORD_SEP = 0x1E;
 constexpr int  BUFSIZE = 1024;
+// Batch query: "Q:<payload size>:<payload>", the payload has one "path<ASCII_FILE_SEP><0|1>"
+// record per path, separated by ASCII_RECORD_SEP. The states are answered in a single line,
+// separated by ':' and in the order of the records. An empty batch is answered with an empty
+// line, so the extensions can check if the server supports batches (older ones answer "9").
+constexpr char OP_BATCH_PATH_STATE = 'Q';
+constexpr char BATCH_STATE_SEP = ':';
+constexpr int  BATCH_MAX_SIZE_DIGITS = 10;
+constexpr qint64 BATCH_MAX_PAYLOAD_SIZE = 16 * 1024 * 1024;
+// Unprocessed bytes kept for a client while its batch query is answered: room for the next batch
+constexpr int CLIENT_MAX_PENDING_SIZE = 2 * BATCH_MAX_PAYLOAD_SIZE;
 constexpr char RESPONSE_SYNCED[]  = "0";
 constexpr char RESPONSE_PENDING[] = "1";
 constexpr char RESPONSE_SYNCING[] = "2";
@@ -22,8 +36,11 @@ constexpr char RESPONSE_DEFAULT[] = "9";
 constexpr char RESPONSE_ERROR[]   = "10";
 
 ExtServer::ExtServer(MegaApplication* app):
-    QObject()
+    QObject(),
+    mBatchQueryTarget(std::make_shared<BatchQueryTarget>())
 {
+    mBatchQueryTarget->server = this;
+
     connect(this,
             &ExtServer::newUploadQueue,
             app,
@@ -48,7 +65,11 @@ ExtServer::ExtServer(MegaApplication* app):
 
     // construct local socket path
     sockPath = MegaApplication::applicationDataPath() + QDir::separator() + QString::fromLatin1("mega.socket");
+}
 
+// Called from the ExtServer thread, so the local server and the clients live in it
+void ExtServer::start()
+{
     //LOG_info << "Starting Ext server";
 
     // make sure previous socket file is removed
@@ -68,6 +89,12 @@ ExtServer::ExtServer(MegaApplication* app):
 
 ExtServer::~ExtServer()
 {
+    // The batch queries still running drop their answers
+    {
+        QMutexLocker lock(&mBatchQueryTarget->mutex);
+        mBatchQueryTarget->server = nullptr;
+    }
+
     // Stop accepting new connections
     if (m_localServer)
     {
@@ -87,6 +114,7 @@ ExtServer::~ExtServer()
         client->deleteLater();
     }
     m_clients.clear();
+    mClientStates.clear();
 
     // Remove socket file on disk
     QLocalServer::removeServer(sockPath);
@@ -107,6 +135,7 @@ void ExtServer::acceptConnection()
         connect(client, SIGNAL(disconnected()), this, SLOT(onClientDisconnected()));
 
         m_clients.append(client);
+        mClientStates.insert(client, ClientState());
     }
 }
 
@@ -117,6 +146,7 @@ void ExtServer::onClientDisconnected()
     if (!client)
         return;
     m_clients.removeAll(client);
+    mClientStates.remove(client);
     client->deleteLater();
 
     //LOG_debug << "Client disconnected";
@@ -134,21 +164,223 @@ void ExtServer::onClientData()
         return;
     }
 
-    static thread_local char buf[BUFSIZE] = {'\0'};
-    qint64 count;
-    do
+    auto& state(mClientStates[client]);
+    state.buffer.append(client->readAll());
+    if (state.busy && state.buffer.size() - state.readPos > CLIENT_MAX_PENDING_SIZE)
     {
-        count = client->readLine(buf, sizeof(buf));
-        if (count > 0)
+        // The client keeps sending without waiting for the answers: drop it
+        client->disconnect(this);
+        m_clients.removeAll(client);
+        mClientStates.remove(client);
+        client->abort();
+        client->deleteLater();
+        return;
+    }
+
+    processClientRequests(client);
+}
+
+void ExtServer::processClientRequests(QLocalSocket* client)
+{
+    auto& state(mClientStates[client]);
+    auto& buffer(state.buffer);
+
+    while (!state.busy && state.readPos < buffer.size())
+    {
+        auto start(state.readPos);
+
+        if (buffer.at(start) == OP_BATCH_PATH_STATE)
+        {
+            // Wait for the whole header and payload
+            auto sizeEnd(buffer.indexOf(':', start + 2));
+            if (sizeEnd < 0 && buffer.size() - start <= 2 + BATCH_MAX_SIZE_DIGITS)
+            {
+                break;
+            }
+
+            bool ok(sizeEnd > start + 2);
+            auto payloadSize(ok ? QByteArray::fromRawData(buffer.constData() + start + 2,
+                                                          sizeEnd - start - 2)
+                                      .toLongLong(&ok) :
+                                  0);
+            if (!ok || payloadSize < 0 || payloadSize > BATCH_MAX_PAYLOAD_SIZE)
+            {
+                // The stream can not be resynchronized
+                buffer.clear();
+                state.readPos = 0;
+                client->write(QByteArray(RESPONSE_DEFAULT).append('\n'));
+                return;
+            }
+
+            if (buffer.size() < sizeEnd + 1 + payloadSize)
+            {
+                break;
+            }
+
+            auto payload(buffer.mid(sizeEnd + 1, static_cast<int>(payloadSize)));
+            state.readPos = sizeEnd + 1 + static_cast<int>(payloadSize);
+            if (state.readPos < buffer.size() && buffer.at(state.readPos) == '\n')
+            {
+                state.readPos++;
+            }
+
+            answerBatchQuery(client, payload);
+        }
+        else
         {
-            const char *out = GetAnswerToRequest(buf);
-            if (out) {
-                client->write(out);
-                client->write("\n");
+            // Single requests come one by one, usually without line terminator. The request is
+            // terminated in place: the buffer is always null-terminated at its end
+            auto lineEnd(buffer.indexOf('\n', start));
+            if (lineEnd < 0)
+            {
+                lineEnd = buffer.size();
+                state.readPos = lineEnd;
+            }
+            else
+            {
+                buffer[lineEnd] = '\0';
+                state.readPos = lineEnd + 1;
             }
-            std::fill_n(buf, count, '\0');
+
+            // The requests have a type and a separator at least
+            const char* out(RESPONSE_DEFAULT);
+            if (lineEnd - start >= 2)
+            {
+                out = GetAnswerToRequest(buffer.constData() + start);
+            }
+
+            QByteArray response(out);
+            client->write(response.append('\n'));
         }
-    } while (count > 0);
+    }
+
+    // Drop the processed requests, the pending bytes of an incomplete one are kept
+    if (state.readPos >= buffer.size())
+    {
+        buffer.clear();
+        state.readPos = 0;
+    }
+    else if (state.readPos > 0 && !state.busy)
+    {
+        buffer.remove(0, state.readPos);
+        state.readPos = 0;
+    }
+}
+
+void ExtServer::answerBatchQuery(QLocalSocket* client, const QByteArray& payload)
+{
+    if (payload.isEmpty())
+    {
+        client->write("\n");
+        return;
+    }
+
+    mClientStates[client].busy = true;
+
+    // The SDK lookups of a folder with thousands of items would block the GUI thread
+    auto overlayIconsDisabled(Preferences::instance()->overlayIconsDisabled());
+    QPointer<QLocalSocket> socket(client);
+    auto target(mBatchQueryTarget);
+    ThreadPoolSingleton::getInstance()->push(
+        [target, socket, payload, overlayIconsDisabled]()
+        {
+            QByteArray response;
+            const auto records(payload.split(ASCII_RECORD_SEP));
+            for (const auto& record: records)
+            {
+                auto possep(record.lastIndexOf(ASCII_FILE_SEP));
+                bool forceGetState = possep >= 0 && record.mid(possep + 1) == "1";
+                string path(possep >= 0 ? record.left(possep).toStdString() :
+                                          record.toStdString());
+
+                if (!response.isEmpty())
+                {
+                    response.append(BATCH_STATE_SEP);
+                }
+                response.append(getPathState(path, forceGetState, overlayIconsDisabled));
+            }
+            response.append('\n');
+
+            // The server is deleted when its thread finishes. Holding the mutex, it can not be
+            // deleted while the answer is queued, and the queued call is dropped if it is deleted
+            // before the call is delivered
+            QMutexLocker lock(&target->mutex);
+            auto server(target->server);
+            if (!server)
+            {
+                return;
+            }
+
+            Utilities::queueFunctionInObjectThread(server,
+                                                   [server, socket, response]()
+                                                   {
+                                                       server->onBatchQueryAnswered(socket,
+                                                                                    response);
+                                                   });
+        });
+}
+
+void ExtServer::onBatchQueryAnswered(QPointer<QLocalSocket> client, const QByteArray& response)
+{
+    if (!client || !mClientStates.contains(client))
+    {
+        return;
+    }
+
+    client->write(response);
+    mClientStates[client].busy = false;
+    processClientRequests(client);
+}
+
+const char* ExtServer::getPathState(const std::string& path,
+                                    bool forceGetState,
+                                    bool overlayIconsDisabled)
+{
+    int state = MegaApi::STATE_NONE;
+    if ((forceGetState || !overlayIconsDisabled) && !path.empty())
+    {
+        string scontent(path);
+        state = MegaSyncApp->getMegaApi()->syncPathState(&scontent);
+    }
+
+    switch(state)
+    {
+        case MegaApi::STATE_SYNCED:
+            return RESPONSE_SYNCED;
+        case MegaApi::STATE_SYNCING:
+            return RESPONSE_SYNCING;
+        case MegaApi::STATE_PENDING:
+            return RESPONSE_PENDING;
+        case MegaApi::STATE_IGNORED:
+        {
+            int runState = MegaSync::SyncRunningState::RUNSTATE_DISABLED;
+            std::unique_ptr<MegaSync> megaSync(
+                MegaSyncApp->getMegaApi()->getSyncByPath(path.c_str()));
+            if (megaSync != nullptr)
+            {
+                runState = megaSync->getRunState();
+            }
+
+            if (runState == MegaSync::SyncRunningState::RUNSTATE_SUSPENDED)
+            {
+                return RESPONSE_PAUSED;
+            }
+            return RESPONSE_IGNORED;
+        }
+        case MegaApi::STATE_NONE:
+        default:
+        {
+            // This case is when the extension wants to display overlays.
+            // RESPONSE_ERROR will make it display no overlay and keep the folder icon.
+            // We don't want to send RESPONSE_ERROR when forceGetState is true
+            // to avoid breaking contextual menu.
+            if (!forceGetState && overlayIconsDisabled)
+            {
+                return RESPONSE_ERROR;
+            }
+            return RESPONSE_DEFAULT;
+        }
+    }
 }
 
 // parse incoming request and send response back to client
@@ -170,28 +402,9 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
                 break;
             }
 
-            bool ok;
-            QStringList parameters = QString::fromLatin1(content).split(QLatin1Char(':'));
-
-            if (parameters.size() != 3)
-            {
-                break;
-            }
-
-            int stringId = parameters[0].toInt(&ok);
-            if (!ok)
-            {
-                break;
-            }
-
-            int numFiles = parameters[1].toInt(&ok);
-            if (!ok || numFiles < 0)
-            {
-                break;
-            }
-
-            int numFolders = parameters[2].toInt(&ok);
-            if (!ok || numFolders < 0)
+            int stringId, numFiles, numFolders;
+            if (!parseStringRequest(content, stringId, numFiles, numFolders)
+                || numFiles < 0 || numFolders < 0)
             {
                 break;
             }
@@ -217,7 +430,6 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
         // get the state of an object
         case 'P':
         {
-            int state = MegaApi::STATE_NONE;
             string scontent(content);
 
             // ASCII_FILE_SEP is used to separate the file name and an optional '1' or '0'
@@ -227,70 +439,18 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
             bool forceGetState = possep != string::npos
                                  && (possep + 1) < scontent.size()
                                  && scontent.at(possep + 1) == '1';
-
-            if (forceGetState || !Preferences::instance()->overlayIconsDisabled())
+            if (possep != string::npos)
             {
-                if (possep != string::npos)
-                {
-                    scontent.resize(possep);
-                }
-                if (!scontent.empty())
-                {
-                    state = MegaSyncApp->getMegaApi()->syncPathState(&scontent);
-                    mLastPath = scontent;
-                }
+                scontent.resize(possep);
             }
 
-            const char* syncStatus = RESPONSE_DEFAULT;
-            switch(state)
+            auto overlayIconsDisabled(Preferences::instance()->overlayIconsDisabled());
+            if ((forceGetState || !overlayIconsDisabled) && !scontent.empty())
             {
-                case MegaApi::STATE_SYNCED:
-                    syncStatus = RESPONSE_SYNCED;
-                    break;
-                case MegaApi::STATE_SYNCING:
-                    syncStatus = RESPONSE_SYNCING;
-                    break;
-                case MegaApi::STATE_PENDING:
-                    syncStatus = RESPONSE_PENDING;
-                    break;
-                case MegaApi::STATE_IGNORED:
-                {
-                    int runState = MegaSync::SyncRunningState::RUNSTATE_DISABLED;
-                    auto megaSync = MegaSyncApp->getMegaApi()->getSyncByPath(scontent.c_str());
-                    if (megaSync != nullptr)
-                    {
-                        runState = megaSync->getRunState();
-                    }
-
-                    if (runState == MegaSync::SyncRunningState::RUNSTATE_SUSPENDED)
-                    {
-                        syncStatus = RESPONSE_PAUSED;
-                    }
-                    else
-                    {
-                        syncStatus = RESPONSE_IGNORED;
-                    }
-                    break;
-                }
-                case MegaApi::STATE_NONE:                
-                default:
-                {
-                    // This case is when the extension wants to display overlays.
-                    // RESPONSE_ERROR will make it display no overlay and keep the folder icon.
-                    // We don't want to send RESPONSE_ERROR when forceGetState is true
-                    // to avoid breaking contextual menu.
-                    if (!forceGetState && Preferences::instance()->overlayIconsDisabled())
-                    {
-                        syncStatus = RESPONSE_ERROR;
-                    }
-                    else
-                    {
-                        syncStatus = RESPONSE_DEFAULT;
-                    }
-                }
+                mLastPath = scontent;
             }
 
-            strncpy(out, syncStatus, BUFSIZE);
+            strncpy(out, getPathState(scontent, forceGetState, overlayIconsDisabled), BUFSIZE);
             break;
         }
         case 'E':
@@ -336,6 +496,47 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
     return out;
 }
 
+// Parses "<stringId>:<numFiles>:<numFolders>" in place
+bool ExtServer::parseStringRequest(const char* content, int& stringId, int& numFiles, int& numFolders)
+{
+    int* values[] = {&stringId, &numFiles, &numFolders};
+    const char* current(content);
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        char* end(nullptr);
+        errno = 0;
+        long value(strtol(current, &end, 10));
+        if (end == current || errno || value < INT_MIN || value > INT_MAX)
+        {
+            return false;
+        }
+        *values[i] = static_cast<int>(value);
+
+        bool last(i + 1 == sizeof(values) / sizeof(values[0]));
+        if (!last)
+        {
+            if (*end != ':')
+            {
+                return false;
+            }
+            current = end + 1;
+        }
+        else
+        {
+            while (isspace(static_cast<unsigned char>(*end)))
+            {
+                end++;
+            }
+            if (*end != '\0')
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 QString ExtServer::getActionName(const int actionId)
 {
     QString name(QString::fromLatin1(RESPONSE_DEFAULT));
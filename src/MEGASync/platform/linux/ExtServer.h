@@ -3,6 +3,10 @@
 
 #include "MegaApplication.h"
 
+#include <QMutex>
+
+#include <memory>
+
 typedef enum {
    STRING_UPLOAD = 0,
    STRING_GETLINK = 1,
@@ -29,15 +33,44 @@ class ExtServer: public QObject
      QStringList backupList;
 
  public Q_SLOTS:
+    void start();
     void acceptConnection();
     void onClientData();
     void onClientDisconnected();
  private:
+    struct ClientState
+    {
+        // Bytes received. The requests are parsed in place, from readPos
+        QByteArray buffer;
+        int readPos = 0;
+        // A batch query is being answered in the thread pool: the next requests wait for it,
+        // so the responses keep the order of the requests
+        bool busy = false;
+    };
+
+    // Shared with the batch query tasks, which can outlive the server. The server is cleared on
+    // destruction, and the answers are only queued to it while holding the mutex
+    struct BatchQueryTarget
+    {
+        QMutex mutex;
+        ExtServer* server = nullptr;
+    };
+
     QString sockPath;
+    std::shared_ptr<BatchQueryTarget> mBatchQueryTarget;
     QList<QLocalSocket *> m_clients;
+    QHash<QLocalSocket*, ClientState> mClientStates;
     std::string mLastPath;
 
+    void processClientRequests(QLocalSocket* client);
+    void answerBatchQuery(QLocalSocket* client, const QByteArray& payload);
+    void onBatchQueryAnswered(QPointer<QLocalSocket> client, const QByteArray& response);
+    static const char* getPathState(const std::string& path,
+                                    bool forceGetState,
+                                    bool overlayIconsDisabled);
+
     const char *GetAnswerToRequest(const char *buf);
+    static bool parseStringRequest(const char* content, int& stringId, int& numFiles, int& numFolders);
     QString getActionName(const int actionId);
 
     void addToQueue(QQueue<QString>& queue, const char* content);
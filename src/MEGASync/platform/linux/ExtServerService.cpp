@@ -0,0 +1,18 @@
+#include "ExtServerService.h"
+
+ExtServerService::ExtServerService(MegaApplication *receiver)
+{
+    mExtServer = new ExtServer(receiver);
+    mExtServer->moveToThread(&mThreadExtServer);
+    connect(&mThreadExtServer, &QThread::started, mExtServer, &ExtServer::start);
+    connect(&mThreadExtServer, &QThread::finished, mExtServer, &QObject::deleteLater);
+
+    mThreadExtServer.setObjectName(QString::fromLatin1("ExtServer"));
+    mThreadExtServer.start();
+}
+
+ExtServerService::~ExtServerService()
+{
+    mThreadExtServer.quit();
+    mThreadExtServer.wait();
+}
@@ -0,0 +1,29 @@
+#ifndef EXTSERVERSERVICE_H
+#define EXTSERVERSERVICE_H
+
+#include "ExtServer.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QThread>
+
+/**
+ * @brief Service instance to manage communications with the file manager extensions
+ *
+ * Class that runs the ExtServer in its own thread, so the requests of the extensions (one per
+ * file shown when a folder is opened) do not compete with the GUI. The requests that open a
+ * dialog are forwarded to the MegaApplication thread by ExtServer signals.
+ */
+class ExtServerService : public QObject
+{
+    Q_OBJECT
+public:
+    ExtServerService(MegaApplication *receiver);
+    ~ExtServerService();
+
+private:
+    QThread mThreadExtServer;
+    QPointer<ExtServer> mExtServer;
+};
+
+#endif // EXTSERVERSERVICE_H
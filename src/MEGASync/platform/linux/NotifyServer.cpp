@@ -9,8 +9,22 @@
 using namespace mega;
 using namespace std;
 
+namespace
+{
+// Item changes received during this window are sent together
+constexpr int COALESCE_WINDOW_MS = 100;
+// More changed items than this in the same folder and window are sent as a folder message
+constexpr int FOLDER_COLLAPSE_THRESHOLD = 64;
+// Pending bytes of a client before its item messages are deferred, and before they are resumed
+constexpr qint64 CLIENT_MAX_PENDING_BYTES = 1024 * 1024;
+constexpr qint64 CLIENT_RESUME_PENDING_BYTES = 64 * 1024;
+constexpr qint64 STATS_LOG_INTERVAL_MS = 60 * 1000;
+}
+
 NotifyServer::NotifyServer():
-    QObject()
+    QObject(),
+    mFlushScheduled(false),
+    mLastLoggedRawEvents(0)
 {
     // construct local socket path
     mSockPath = MegaApplication::applicationDataPath() + QDir::separator() +
@@ -23,6 +37,11 @@ NotifyServer::NotifyServer():
 
     mLocalServer = new QLocalServer(this);
 
+    mFlushTimer.setSingleShot(true);
+    mFlushTimer.setInterval(COALESCE_WINDOW_MS);
+    connect(&mFlushTimer, &QTimer::timeout, this, &NotifyServer::flushPendingItems);
+    mStatsLogTimer.start();
+
     // start listening for new connections
     if (!mLocalServer->listen(mSockPath))
     {
@@ -33,10 +52,14 @@ NotifyServer::NotifyServer():
 
     connect(mLocalServer, &QLocalServer::newConnection, this, &NotifyServer::acceptConnection);
     connect(this, &NotifyServer::sendToAll, this, &NotifyServer::doSendToAll);
+    connect(this, &NotifyServer::flushRequested, this, &NotifyServer::scheduleFlush);
 }
 
 NotifyServer::~NotifyServer()
 {
+    mFlushTimer.stop();
+    logStats(true);
+
     // Stop accepting new connections
     if (mLocalServer)
     {
@@ -54,6 +77,7 @@ NotifyServer::~NotifyServer()
         client->deleteLater();
     }
     mClients.clear();
+    mClientStates.clear();
 
     // Remove socket file path
     QLocalServer::removeServer(mSockPath);
@@ -73,28 +97,25 @@ void NotifyServer::acceptConnection()
         }
 
         connect(client, &QLocalSocket::disconnected, this, &NotifyServer::onClientDisconnected);
+        connect(client, &QLocalSocket::bytesWritten, this, &NotifyServer::onClientBytesWritten);
 
         // send the list of current synced folders to the new client
-        int localFolders = 0;
-        SyncInfo* model = SyncInfo::instance();
-        for (auto& syncSetting: model->getAllSyncSettings())
+        QByteArray syncs;
+        for (const auto& syncFolder: getActiveSyncFolders())
         {
-            QString c =
-                QDir::toNativeSeparators(QDir(syncSetting->getLocalFolder()).canonicalPath());
-            if (!c.isEmpty() && syncSetting->isActive())
-            {
-                localFolders++;
-                client->write(createPayload(NotifyType::SyncAdded, c.toUtf8().constData()));
-            }
+            syncs.append(createPayload(NotifyType::SyncAdded, syncFolder.toUtf8()));
         }
 
-        if (!localFolders)
+        if (syncs.isEmpty())
         {
             // send an empty sync
-            client->write(createPayload(NotifyType::SyncAdded, QLatin1String(".").latin1()));
+            syncs.append(createPayload(NotifyType::SyncAdded, QLatin1String(".").latin1()));
         }
 
+        client->write(syncs);
+
         mClients.append(client);
+        mClientStates.insert(client, ClientState());
     }
 }
 
@@ -105,23 +126,103 @@ void NotifyServer::onClientDisconnected()
     if (!client)
         return;
     mClients.removeAll(client);
+    mClientStates.remove(client);
     client->deleteLater();
 
     // LOG_debug << "Client disconnected";
 }
 
+void NotifyServer::onClientBytesWritten()
+{
+    QLocalSocket* client = qobject_cast<QLocalSocket*>(sender());
+    if (client && client->bytesToWrite() < CLIENT_RESUME_PENDING_BYTES)
+    {
+        sendDeferredFolders(client);
+    }
+}
+
 // send string to all connected clients
 void NotifyServer::doSendToAll(const QByteArray& payload)
 {
+    // Keep the order: the pending item changes were notified before this message
+    flushPendingItems();
+
     for (QLocalSocket* socket: mClients)
     {
         if (socket && socket->state() == QLocalSocket::ConnectedState) {
             socket->write(payload);
-            socket->flush();
         }
     }
 }
 
+void NotifyServer::scheduleFlush()
+{
+    if (!mFlushTimer.isActive())
+    {
+        mFlushTimer.start();
+    }
+}
+
+void NotifyServer::flushPendingItems()
+{
+    mFlushTimer.stop();
+
+    QHash<QString, PendingFolder> pendingFolders;
+    {
+        QMutexLocker lock(&mPendingMutex);
+        pendingFolders.swap(mPendingFolders);
+        mFlushScheduled = false;
+    }
+
+    if (pendingFolders.isEmpty())
+    {
+        return;
+    }
+
+    QByteArray batch;
+    QList<QString> folders;
+    quint64 messages(0);
+
+    for (auto it = pendingFolders.cbegin(); it != pendingFolders.cend(); ++it)
+    {
+        const auto& folder(it.key());
+        folders.append(folder);
+
+        if (it.value().collapsed)
+        {
+            batch.append(createPayload(NotifyType::FolderChanged, folderPath(folder).toUtf8()));
+            messages++;
+        }
+        else
+        {
+            for (const auto& name : it.value().names)
+            {
+                batch.append(createPayload(NotifyType::ItemChanged, (folder + name).toUtf8()));
+                messages++;
+            }
+        }
+    }
+
+    for (QLocalSocket* client: mClients)
+    {
+        writeToClient(client, batch, folders);
+    }
+
+    {
+        QMutexLocker lock(&mPendingMutex);
+        mStats.messagesSent += messages;
+        mStats.batchesSent++;
+    }
+
+    logStats();
+}
+
+NotifyServer::Stats NotifyServer::getStats() const
+{
+    QMutexLocker lock(&mPendingMutex);
+    return mStats;
+}
+
 QByteArray NotifyServer::createPayload(NotifyType type, const QByteArray& data)
 {
     QByteArray payload;
@@ -131,9 +232,137 @@ QByteArray NotifyServer::createPayload(NotifyType type, const QByteArray& data)
     return payload;
 }
 
+QString NotifyServer::folderPath(const QString& folder)
+{
+    // Folders are kept with the trailing separator, except for the root
+    if (folder.size() > 1 && folder.endsWith(QLatin1Char('/')))
+    {
+        return folder.left(folder.size() - 1);
+    }
+
+    return folder;
+}
+
+void NotifyServer::writeToClient(QLocalSocket* client,
+                                 const QByteArray& batch,
+                                 const QList<QString>& folders)
+{
+    if (!client || client->state() != QLocalSocket::ConnectedState)
+    {
+        return;
+    }
+
+    auto& state(mClientStates[client]);
+
+    // The client is not reading: do not queue more items, refresh their folders later
+    if (client->bytesToWrite() > CLIENT_MAX_PENDING_BYTES)
+    {
+        for (const auto& folder : folders)
+        {
+            state.deferredFolders.insert(folder);
+        }
+
+        QMutexLocker lock(&mPendingMutex);
+        mStats.batchesDeferred++;
+        return;
+    }
+
+    sendDeferredFolders(client);
+    client->write(batch);
+}
+
+void NotifyServer::sendDeferredFolders(QLocalSocket* client)
+{
+    auto state(mClientStates.find(client));
+    if (state == mClientStates.end() || state->deferredFolders.isEmpty())
+    {
+        return;
+    }
+
+    QByteArray batch;
+    for (const auto& folder : qAsConst(state->deferredFolders))
+    {
+        batch.append(createPayload(NotifyType::FolderChanged, folderPath(folder).toUtf8()));
+    }
+
+    {
+        QMutexLocker lock(&mPendingMutex);
+        mStats.messagesSent += state->deferredFolders.size();
+        mStats.batchesSent++;
+    }
+
+    state->deferredFolders.clear();
+    client->write(batch);
+}
+
+void NotifyServer::logStats(bool force)
+{
+    if (!force && mStatsLogTimer.elapsed() < STATS_LOG_INTERVAL_MS)
+    {
+        return;
+    }
+
+    auto stats(getStats());
+    mStatsLogTimer.restart();
+    if (stats.rawEvents == mLastLoggedRawEvents)
+    {
+        return;
+    }
+    mLastLoggedRawEvents = stats.rawEvents;
+
+    QString message = QString::fromUtf8("Notify server: %1 item events, %2 deduplicated, %3 collapsed into folders. "
+                                        "%4 messages sent in %5 batches, %6 batches deferred")
+                          .arg(stats.rawEvents)
+                          .arg(stats.deduplicated)
+                          .arg(stats.collapsed)
+                          .arg(stats.messagesSent)
+                          .arg(stats.batchesSent)
+                          .arg(stats.batchesDeferred);
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, message.toUtf8().constData());
+}
+
 void NotifyServer::notifyItemChange(const QString& localPath)
 {
-    emit sendToAll(createPayload(NotifyType::ItemChanged, localPath.toUtf8()));
+    auto nameIndex(localPath.lastIndexOf(QLatin1Char('/')) + 1);
+    auto folder(localPath.left(nameIndex));
+    auto name(localPath.mid(nameIndex));
+
+    auto requestFlush(false);
+    {
+        QMutexLocker lock(&mPendingMutex);
+        mStats.rawEvents++;
+
+        auto& pendingFolder(mPendingFolders[folder]);
+        if (pendingFolder.collapsed)
+        {
+            mStats.collapsed++;
+        }
+        else if (pendingFolder.names.contains(name))
+        {
+            mStats.deduplicated++;
+        }
+        else
+        {
+            pendingFolder.names.insert(name);
+            if (!folder.isEmpty() && pendingFolder.names.size() > FOLDER_COLLAPSE_THRESHOLD)
+            {
+                mStats.collapsed += pendingFolder.names.size();
+                pendingFolder.names.clear();
+                pendingFolder.collapsed = true;
+            }
+        }
+
+        if (!mFlushScheduled)
+        {
+            mFlushScheduled = true;
+            requestFlush = true;
+        }
+    }
+
+    if (requestFlush)
+    {
+        emit flushRequested();
+    }
 }
 
 void NotifyServer::notifySyncAdd(const QString& path)
@@ -145,3 +374,40 @@ void NotifyServer::notifySyncDel(const QString& path)
 {
     emit sendToAll(createPayload(NotifyType::SyncDeleted, path.toUtf8()));
 }
+
+void NotifyServer::notifyAllSyncsChanged()
+{
+    // The extensions drop their cached states on every sync added message. Then the sync folders
+    // and the children they show are refreshed
+    QByteArray payload;
+    const auto syncFolders(getActiveSyncFolders());
+    for (const auto& syncFolder: syncFolders)
+    {
+        payload.append(createPayload(NotifyType::SyncAdded, syncFolder.toUtf8()));
+    }
+    for (const auto& syncFolder: syncFolders)
+    {
+        payload.append(createPayload(NotifyType::ItemChanged, syncFolder.toUtf8()));
+        payload.append(createPayload(NotifyType::FolderChanged, syncFolder.toUtf8()));
+    }
+
+    if (!payload.isEmpty())
+    {
+        emit sendToAll(payload);
+    }
+}
+
+QStringList NotifyServer::getActiveSyncFolders() const
+{
+    QStringList syncFolders;
+    SyncInfo* model = SyncInfo::instance();
+    for (auto& syncSetting: model->getAllSyncSettings())
+    {
+        QString c = QDir::toNativeSeparators(QDir(syncSetting->getLocalFolder()).canonicalPath());
+        if (!c.isEmpty() && syncSetting->isActive())
+        {
+            syncFolders.append(c);
+        }
+    }
+    return syncFolders;
+}
@@ -3,16 +3,47 @@
 
 #include "MegaApplication.h"
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+/// Notifies the file manager extensions (Nautilus, Nemo, Dolphin) about the synced paths whose
+/// state changed, so they refresh the overlay icons.
+/// Item changes are coalesced: paths are deduplicated during a short window and sent to every
+/// client as a single batch of lines (one write per client). When many items of the same folder
+/// change in a window, a single folder message is sent instead, and the extension refreshes the
+/// children it is showing. Clients that do not read fast enough do not get more item messages
+/// until they drain their buffer; they receive the folder messages of what they missed instead.
 class NotifyServer: public QObject
 {
     Q_OBJECT
 
 public:
+    struct Stats
+    {
+        quint64 rawEvents = 0;
+        // Repeated paths in the same window
+        quint64 deduplicated = 0;
+        // Item changes replaced by a folder message
+        quint64 collapsed = 0;
+        quint64 messagesSent = 0;
+        quint64 batchesSent = 0;
+        // Batches not written to a slow client
+        quint64 batchesDeferred = 0;
+    };
+
     NotifyServer();
     virtual ~NotifyServer();
     void notifyItemChange(const QString& localPath);
     void notifySyncAdd(const QString& path);
     void notifySyncDel(const QString& path);
+    // The states of all the synced paths may have changed (e.g. the overlay icons were toggled)
+    void notifyAllSyncsChanged();
+
+    Stats getStats() const;
 
 protected:
     QPointer<QLocalServer> mLocalServer;
@@ -20,7 +51,10 @@ protected:
 public Q_SLOTS:
     void acceptConnection();
     void onClientDisconnected();
+    void onClientBytesWritten();
     void doSendToAll(const QByteArray& payload);
+    void scheduleFlush();
+    void flushPendingItems();
 
 private:
     enum class NotifyType : char
@@ -28,16 +62,47 @@ private:
         SyncAdded = 'A',
         SyncDeleted = 'D',
         ItemChanged = 'P',
+        FolderChanged = 'F',
         EndLine = '\n'
      };
 
+     struct PendingFolder
+     {
+         QSet<QString> names;
+         bool collapsed = false;
+     };
+
+     struct ClientState
+     {
+         // Folders of the batches not written because the client was too slow
+         QSet<QString> deferredFolders;
+     };
+
      MegaApplication* app;
      QString mSockPath;
      QList<QLocalSocket*> mClients;
+     QHash<QLocalSocket*, ClientState> mClientStates;
+
+     // Item changes may come from the SDK threads
+     mutable QMutex mPendingMutex;
+     QHash<QString, PendingFolder> mPendingFolders;
+     bool mFlushScheduled;
+     Stats mStats;
+
+     QTimer mFlushTimer;
+     QElapsedTimer mStatsLogTimer;
+     quint64 mLastLoggedRawEvents;
+
      QByteArray createPayload(NotifyType type, const QByteArray& data);
+     QStringList getActiveSyncFolders() const;
+     static QString folderPath(const QString& folder);
+     void writeToClient(QLocalSocket* client, const QByteArray& batch, const QList<QString>& folders);
+     void sendDeferredFolders(QLocalSocket* client);
+     void logStats(bool force = false);
 
  signals:
      void sendToAll(const QByteArray& str);
+     void flushRequested();
 };
 
 #endif
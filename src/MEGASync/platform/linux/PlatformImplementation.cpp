@@ -169,7 +169,7 @@ void PlatformImplementation::startShellDispatcher(MegaApplication *receiver)
 {
     if (!ext_server)
     {
-        ext_server = new ExtServer(receiver);
+        ext_server = new ExtServerService(receiver);
     }
 
     if (!notify_server)
@@ -231,7 +231,11 @@ void PlatformImplementation::syncFolderRemoved(QString syncPath, QString /*syncN
 
 void PlatformImplementation::notifyRestartSyncFolders()
 {
-
+    // Sent regardless of the overlay icons preference, as it is used when that preference changes
+    if (notify_server)
+    {
+        notify_server->notifyAllSyncsChanged();
+    }
 }
 
 void PlatformImplementation::notifyAllSyncFoldersAdded()
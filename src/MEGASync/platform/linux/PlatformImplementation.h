@@ -2,7 +2,7 @@
 #define LINUXPLATFORM_H
 
 #include "AbstractPlatform.h"
-#include "ExtServer.h"
+#include "ExtServerService.h"
 #include "NotifyServer.h"
 
 #include <xcb/xcb.h>
@@ -80,7 +80,7 @@ private:
     void maybeEmitTheme();
     void setupGSettingsThemeCli();
 
-    ExtServer* ext_server = nullptr;
+    ExtServerService* ext_server = nullptr;
     NotifyServer *notify_server = nullptr;
     QString autostart_dir;
     QString desktop_file;
@@ -93,11 +93,13 @@ target_sources_conditional(${ExecutableTarget}
    PRIVATE
    ${CMAKE_CURRENT_LIST_DIR}/linux/PlatformImplementation.h
    ${CMAKE_CURRENT_LIST_DIR}/linux/ExtServer.h
+   ${CMAKE_CURRENT_LIST_DIR}/linux/ExtServerService.h
    ${CMAKE_CURRENT_LIST_DIR}/linux/NotifyServer.h
    ${CMAKE_CURRENT_LIST_DIR}/linux/DolphinFileManager.h
    ${CMAKE_CURRENT_LIST_DIR}/linux/NautilusFileManager.h
    ${CMAKE_CURRENT_LIST_DIR}/linux/PlatformImplementation.cpp
    ${CMAKE_CURRENT_LIST_DIR}/linux/ExtServer.cpp
+   ${CMAKE_CURRENT_LIST_DIR}/linux/ExtServerService.cpp
    ${CMAKE_CURRENT_LIST_DIR}/linux/NotifyServer.cpp
    ${CMAKE_CURRENT_LIST_DIR}/linux/PowerOptions.cpp
    ${CMAKE_CURRENT_LIST_DIR}/linux/PlatformStrings.cpp
@@ -15,6 +15,7 @@
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPainterPath>
+#include <QResizeEvent>
 
 const int PEN_WIDTH = 2;
 const int UPDATE_SIZE_TIMER = 50;
@@ -151,11 +152,23 @@ QSize StalledIssueDelegate::sizeHint(const QStyleOptionViewItem& option, const Q
         StalledIssue::Type sizeType = index.parent().isValid() ? StalledIssue::Body : StalledIssue::Header;
         size = stalledIssueItem.getDelegateSize(sizeType);
 
-        if(!size.isValid() && mFreshStart)
+        if(!size.isValid())
         {
             auto parentRow(index.parent().isValid() ? index.parent().row() : index.row());
-            if((mVisibleIndexesRange.isEmpty() && parentRow > StalledIssuesDelegateWidgetsCache::DELEGATEWIDGETS_CACHESIZE)
-               || (!mVisibleIndexesRange.isEmpty() && !mVisibleIndexesRange.contains(parentRow)))
+            bool isOutOfView((mVisibleIndexesRange.isEmpty() && parentRow > StalledIssuesDelegateWidgetsCache::DELEGATEWIDGETS_CACHESIZE)
+               || (!mVisibleIndexesRange.isEmpty() && !mVisibleIndexesRange.contains(parentRow)));
+
+            // Issues already measured, even in a previous list, don't need a widget while out of view
+            if(isOutOfView)
+            {
+                size = mCacheManager.getCachedSize(stalledIssueItem, sizeType);
+                if(size.isValid())
+                {
+                    stalledIssueItem.setDelegateSize(size, sizeType);
+                }
+            }
+
+            if(!size.isValid() && isOutOfView && mFreshStart)
             {
                 auto averageSizeInfo(mAverageHeaderHeight.value(stalledIssueItem.consultData()->getReason()));
                 auto averageSize = averageSizeInfo.second;
@@ -196,6 +209,8 @@ QSize StalledIssueDelegate::sizeHint(const QStyleOptionViewItem& option, const Q
             if(w)
             {
                 size = w->sizeHint();
+                mCacheManager.cacheSize(stalledIssueItem, sizeType, size);
+
                 if(mFreshStart)
                 {
                     if(mAverageHeaderHeight.contains(stalledIssueItem.consultData()->getReason()))
@@ -479,6 +494,13 @@ bool StalledIssueDelegate::eventFilter(QObject *object, QEvent *event)
 {
     if(object == mView && event->type() == QEvent::Resize)
     {
+        // The heights depend on the width
+        auto resizeEvent(static_cast<QResizeEvent*>(event));
+        if(resizeEvent->oldSize().width() != resizeEvent->size().width())
+        {
+            mCacheManager.resetCachedSizes();
+        }
+
         mUpdateSizeHintTimerFromResize.start(UPDATE_SIZE_TIMER);
 
     }
@@ -15,7 +15,9 @@
 const int StalledIssuesDelegateWidgetsCache::DELEGATEWIDGETS_CACHESIZE = 30;
 
 StalledIssuesDelegateWidgetsCache::StalledIssuesDelegateWidgetsCache(QStyledItemDelegate *delegate)
-    : mDelegate(delegate)
+    : mStalledIssueHeaderWidgets(DELEGATEWIDGETS_CACHESIZE)
+    , mStalledIssueWidgets(DELEGATEWIDGETS_CACHESIZE)
+    , mDelegate(delegate)
 {}
 
 void StalledIssuesDelegateWidgetsCache::setProxyModel(StalledIssuesProxyModel *proxyModel)
@@ -25,47 +27,65 @@ void StalledIssuesDelegateWidgetsCache::setProxyModel(StalledIssuesProxyModel *p
 
 void StalledIssuesDelegateWidgetsCache::reset()
 {
-    foreach(auto headerCase, mStalledIssueHeaderWidgets)
+    foreach(auto headerCase, mStalledIssueHeaderWidgets.widgets())
     {
         headerCase->reset();
     }
 
     mStalledIssueHeaderWidgets.clear();
 
-    foreach(auto map, mStalledIssueWidgets.values())
+    qDeleteAll(mStalledIssueWidgets.widgets());
+
+    mStalledIssueWidgets.clear();
+}
+
+QSize StalledIssuesDelegateWidgetsCache::getCachedSize(const StalledIssueVariant& issue, StalledIssue::Type type) const
+{
+    auto stall(issue.consultData()->getOriginalStall());
+    return stall ? mSizesByHash.value(qMakePair(stall->getHash(), static_cast<int>(type))) : QSize();
+}
+
+void StalledIssuesDelegateWidgetsCache::cacheSize(const StalledIssueVariant& issue, StalledIssue::Type type, const QSize& size) const
+{
+    auto stall(issue.consultData()->getOriginalStall());
+    if(stall && size.isValid())
     {
-        qDeleteAll(map);
+        mSizesByHash.insert(qMakePair(stall->getHash(), static_cast<int>(type)), size);
     }
+}
 
-    mStalledIssueWidgets.clear();
+void StalledIssuesDelegateWidgetsCache::resetCachedSizes()
+{
+    mSizesByHash.clear();
 }
 
-int StalledIssuesDelegateWidgetsCache::getMaxCacheRow(int row) const
+int StalledIssuesDelegateWidgetsCache::createdWidgets() const
 {
-    auto nbRowsMaxInView(DELEGATEWIDGETS_CACHESIZE);
-    return row % nbRowsMaxInView;
+    return mStalledIssueHeaderWidgets.createdWidgets() + mStalledIssueWidgets.createdWidgets();
 }
 
 StalledIssueHeader *StalledIssuesDelegateWidgetsCache::getStalledIssueHeaderWidget(const QModelIndex &sourceIndex,
-                                                                                   const QModelIndex& proxyIndex,
+                                                                                   const QModelIndex&,
                                                                                    QWidget *parent,
                                                                                    const StalledIssueVariant &issue,
                                                                                    const QSize &size) const
 {
-    auto row = getMaxCacheRow(proxyIndex.row());
-    auto& header = mStalledIssueHeaderWidgets[row];
+    auto createHeader = [this, parent]()
+    {
+        auto header = new StalledIssueHeader(parent);
+        header->setDelegate(mDelegate);
+        return header;
+    };
+
+    HeaderWidgetsPool::Acquired acquired;
+    QPointer<StalledIssueHeader> header(
+        mStalledIssueHeaderWidgets.acquire(0, QPersistentModelIndex(sourceIndex), createHeader, acquired));
 
-    bool isNew(!header);
+    bool isNew(acquired == HeaderWidgetsPool::Acquired::CREATED);
     bool needsUpdate(isNew ||
                header->getCurrentIndex() != sourceIndex ||
                issue.consultData()->needsUIUpdate(StalledIssue::Type::Header));
 
-    if(isNew)
-    {
-        header = new StalledIssueHeader(parent);
-        header->setDelegate(mDelegate);
-    }
-
     if(needsUpdate)
     {
         createHeaderCaseWidget(header, issue);
@@ -96,36 +116,32 @@ StalledIssueHeader *StalledIssuesDelegateWidgetsCache::getStalledIssueHeaderWidg
 }
 
 StalledIssueBaseDelegateWidget *StalledIssuesDelegateWidgetsCache::getStalledIssueInfoWidget(const QModelIndex& sourceIndex,
-                                                                                             const QModelIndex& proxyIndex,
+                                                                                             const QModelIndex&,
                                                                                              QWidget *parent,
                                                                                              const StalledIssueVariant &issue,
                                                                                              const QSize& size) const
 {
-    auto row = getMaxCacheRow(proxyIndex.parent().row());
-
-    auto reason = issue.consultData()->getReason();
-    auto& itemsByRowMap = mStalledIssueWidgets[toInt(reason)];
-    auto& item = itemsByRowMap[row];
+    auto createBody = [this, parent, &issue]()
+    {
+        auto item = createBodyWidget(parent, issue);
+        item->setDelegate(mDelegate);
+        return item;
+    };
 
-    bool isNew(!item ||
-               item->getCurrentIndex() != sourceIndex);
+    // The body widgets of the same reason are the same class, so the one least recently used is
+    // pointed to the new issue instead of being created again
+    BodyWidgetsPool::Acquired acquired;
+    QPointer<StalledIssueBaseDelegateWidget> item(mStalledIssueWidgets.acquire(
+        toInt(issue.consultData()->getReason()), QPersistentModelIndex(sourceIndex), createBody, acquired));
 
-    if(isNew)
+    if(acquired == BodyWidgetsPool::Acquired::CREATED)
     {
-        if(item)
-        {
-            item->deleteLater();
-        }
-
-        item = createBodyWidget(parent, issue);
-        item->setDelegate(mDelegate);
         item->resize(QSize(size.width(), item->size().height()));
         item->updateUi(sourceIndex, issue);
         item->init();
-
-        itemsByRowMap.insert(row, item);
     }
-    else if(issue.consultData()->needsUIUpdate(StalledIssue::Type::Body))
+    else if(item->getCurrentIndex() != sourceIndex ||
+            issue.consultData()->needsUIUpdate(StalledIssue::Type::Body))
     {
         item->updateUi(sourceIndex, issue);
     }
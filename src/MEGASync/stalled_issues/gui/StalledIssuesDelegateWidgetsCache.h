@@ -2,10 +2,12 @@
 #define STALLEDISSUEHEADERWIDGETMANAGER_H
 
 #include "StalledIssue.h"
+#include "StalledIssuesWidgetsPool.h"
 #include "megaapi.h"
 
-#include <QMap>
+#include <QHash>
 #include <QModelIndex>
+#include <QPersistentModelIndex>
 #include <QPointer>
 #include <QStyledItemDelegate>
 
@@ -35,11 +37,22 @@ public:
 
     void reset();
 
+    // Sizes measured by issue hash, kept across model refreshes so rows out of view don't need
+    // a widget to get their size hint. They depend on the view width
+    QSize getCachedSize(const StalledIssueVariant& issue, StalledIssue::Type type) const;
+    void cacheSize(const StalledIssueVariant& issue, StalledIssue::Type type, const QSize& size) const;
+    void resetCachedSizes();
+
+    int createdWidgets() const;
+
 private:
-    mutable QMap<int,QPointer<StalledIssueHeader>> mStalledIssueHeaderWidgets;
-    mutable QMap<unsigned int, QMap<int, QPointer<StalledIssueBaseDelegateWidget>>> mStalledIssueWidgets;
+    // Headers are a single kind, bodies are a kind by stall reason
+    using HeaderWidgetsPool = StalledIssuesWidgetsPool<int, QPersistentModelIndex, QPointer<StalledIssueHeader>>;
+    using BodyWidgetsPool = StalledIssuesWidgetsPool<unsigned int, QPersistentModelIndex, QPointer<StalledIssueBaseDelegateWidget>>;
 
-    int getMaxCacheRow(int row) const;
+    mutable HeaderWidgetsPool mStalledIssueHeaderWidgets;
+    mutable BodyWidgetsPool mStalledIssueWidgets;
+    mutable QHash<QPair<unsigned long long, int>, QSize> mSizesByHash;
 
     StalledIssueBaseDelegateWidget* createBodyWidget(QWidget *parent, const StalledIssueVariant &issue) const;
     StalledIssueHeaderCase* createHeaderCaseWidget(StalledIssueHeader* header, const StalledIssueVariant &issue) const;
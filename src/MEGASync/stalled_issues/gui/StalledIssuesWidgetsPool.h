@@ -0,0 +1,110 @@
+#ifndef STALLEDISSUESWIDGETSPOOL_H
+#define STALLEDISSUESWIDGETSPOOL_H
+
+#include <QList>
+#include <QMap>
+
+#include <algorithm>
+
+/// Responsability: keeps a bounded pool of delegate widgets by kind (a header, or the body of a
+/// stall reason) so scrolling recycles them instead of destroying and creating them again.
+/// A widget is looked up by the key (index) it shows. When there is none, the least recently used
+/// widget of the same kind is recycled, and a new one is only created while the kind has less than
+/// sizeByKind widgets. Widgets which evaluate to false (a null QPointer) are dropped.
+template <class Kind, class Key, class Widget>
+class StalledIssuesWidgetsPool
+{
+public:
+    enum class Acquired
+    {
+        FOUND,
+        RECYCLED,
+        CREATED
+    };
+
+    explicit StalledIssuesWidgetsPool(int sizeByKind):
+        mSizeByKind(sizeByKind),
+        mCreatedWidgets(0)
+    {}
+
+    template <class CreateFunc>
+    Widget acquire(const Kind& kind, const Key& key, CreateFunc createFunc, Acquired& acquired)
+    {
+        auto& entries = mEntriesByKind[kind];
+        entries.erase(std::remove_if(entries.begin(),
+                                     entries.end(),
+                                     [](const Entry& entry)
+                                     {
+                                         return !entry.widget;
+                                     }),
+                      entries.end());
+
+        // The most recently used ones are at the end
+        for (int index = entries.size() - 1; index >= 0; --index)
+        {
+            if (entries.at(index).key == key)
+            {
+                entries.move(index, entries.size() - 1);
+                acquired = Acquired::FOUND;
+                return entries.last().widget;
+            }
+        }
+
+        if (entries.size() >= mSizeByKind)
+        {
+            auto entry(entries.takeFirst());
+            entry.key = key;
+            entries.append(entry);
+            acquired = Acquired::RECYCLED;
+            return entry.widget;
+        }
+
+        Entry entry;
+        entry.key = key;
+        entry.widget = createFunc();
+        entries.append(entry);
+        mCreatedWidgets++;
+        acquired = Acquired::CREATED;
+        return entry.widget;
+    }
+
+    QList<Widget> widgets() const
+    {
+        QList<Widget> widgets;
+        for (const auto& entries: mEntriesByKind)
+        {
+            for (const auto& entry: entries)
+            {
+                if (entry.widget)
+                {
+                    widgets.append(entry.widget);
+                }
+            }
+        }
+        return widgets;
+    }
+
+    void clear()
+    {
+        mEntriesByKind.clear();
+    }
+
+    // Total of widgets created, to measure how many are recycled
+    int createdWidgets() const
+    {
+        return mCreatedWidgets;
+    }
+
+private:
+    struct Entry
+    {
+        Key key;
+        Widget widget;
+    };
+
+    QMap<Kind, QList<Entry>> mEntriesByKind;
+    int mSizeByKind;
+    int mCreatedWidgets;
+};
+
+#endif // STALLEDISSUESWIDGETSPOOL_H
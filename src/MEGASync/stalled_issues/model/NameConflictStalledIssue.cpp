@@ -238,6 +238,16 @@ bool NameConflictedStalledIssue::containsHandle(mega::MegaHandle handle)
     return false;
 }
 
+QList<mega::MegaHandle> NameConflictedStalledIssue::getHandles() const
+{
+    QList<mega::MegaHandle> handles;
+    foreach(auto& cloudConflictedName, mCloudConflictedNames.getConflictedNames())
+    {
+        handles.append(cloudConflictedName->mHandle);
+    }
+    return handles;
+}
+
 void NameConflictedStalledIssue::updateHandle(mega::MegaHandle handle)
 {
     if(mLastModifiedNode.isValid())
@@ -527,6 +527,7 @@ public:
 
     bool containsHandle(mega::MegaHandle handle) override;
     void updateHandle(mega::MegaHandle handle) override;
+    QList<mega::MegaHandle> getHandles() const override;
     void updateName() override;
 
     bool checkForExternalChanges() override;
@@ -825,6 +825,17 @@ void StalledIssue::updateIssue(const mega::MegaSyncStall* stallIssue)
     endFillingIssue();
 }
 
+QList<mega::MegaHandle> StalledIssue::getHandles() const
+{
+    QList<mega::MegaHandle> handles;
+    auto cloudData(consultCloudData());
+    if (cloudData && cloudData->getPathHandle() != mega::INVALID_HANDLE)
+    {
+        handles.append(cloudData->getPathHandle());
+    }
+    return handles;
+}
+
 bool StalledIssue::isUnsolved() const
 {
     return mIsSolved == SolveType::UNSOLVED;
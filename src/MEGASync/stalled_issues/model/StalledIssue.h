@@ -302,6 +302,8 @@ public:
 
     virtual bool containsHandle(mega::MegaHandle handle){return getCloudData() && getCloudData()->getPathHandle() == handle;}
     virtual void updateHandle(mega::MegaHandle handle){if(getCloudData()){getCloudData()->setPathHandle(handle);}}
+    // Handles which containsHandle is true for
+    virtual QList<mega::MegaHandle> getHandles() const;
     virtual void updateName(){}
 
     virtual bool checkForExternalChanges();
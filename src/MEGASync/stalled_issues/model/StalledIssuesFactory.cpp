@@ -102,63 +102,80 @@ void StalledIssuesCreator::createIssues(const mega::MegaSyncStallMap* stallsMap,
 
                 StalledIssueVariant variant;
                 StalledIssueSPtr d;
+                bool reused(false);
 
-                if (stall->reason() ==
-                    mega::MegaSyncStall::SyncStallReason::MoveOrRenameCannotOccur)
+                // An unsolved issue received again on the UI update is the same stall: the previous
+                // one is reused, so it is not filled again and its UI state is kept
+                if (updateType == UpdateType::UI && !multiStepIssueSolver &&
+                    stall->reason() != mega::MegaSyncStall::SyncStallReason::MoveOrRenameCannotOccur)
                 {
-                    d = mMoveOrRenameCannotOccurFactory->createIssue(multiStepIssueSolver, stall);
-
-                    // If we find a MoveOrRenameCannotOccur issue, we don´t want to show
-                    // the DeleteWaitingOnMove and DeleteOrMoveWaitingOnScanning
-                    reasonsToFilter
-                        << mega::MegaSyncStall::SyncStallReason::DeleteWaitingOnMoves
-                        << mega::MegaSyncStall::SyncStallReason::DeleteOrMoveWaitingOnScanning;
+                    auto previousIssue(mPreviousIssues.value(hash));
+                    if (previousIssue.isValid() && previousIssue.consultData()->isUnsolved())
+                    {
+                        variant = previousIssue;
+                        reused = true;
+                    }
                 }
-                else
+
+                if (!reused)
                 {
                     if (stall->reason() ==
-                        mega::MegaSyncStall::SyncStallReason::NamesWouldClashWhenSynced)
-                    {
-                        d = std::make_shared<NameConflictedStalledIssue>(stall);
-                    }
-                    else if (stall->reason() == mega::MegaSyncStall::SyncStallReason::DownloadIssue)
+                        mega::MegaSyncStall::SyncStallReason::MoveOrRenameCannotOccur)
                     {
-                        d = DownloadFileIssueFactory::createAndFillIssue(stall);
-                    }
-                    else if (stall->couldSuggestIgnoreThisPath(false, 0) ||
-                             stall->couldSuggestIgnoreThisPath(false, 1) ||
-                             stall->couldSuggestIgnoreThisPath(true, 0) ||
-                             stall->couldSuggestIgnoreThisPath(true, 1))
-                    {
-                        d = std::make_shared<IgnoredStalledIssue>(stall);
-                    }
-                    else if (StalledIssue::isCloudNodeBlocked(stall))
-                    {
-                        d = std::make_shared<CloudNodeIsBlockedIssue>(stall);
-                    }
-                    else if (stall->reason() ==
-                             mega::MegaSyncStall::SyncStallReason::FolderMatchedAgainstFile)
-                    {
-                        d = std::make_shared<FolderMatchedAgainstFileIssue>(stall);
-                    }
-                    else if (stall->reason() ==
-                                 mega::MegaSyncStall::SyncStallReason::
-                                     LocalAndRemoteChangedSinceLastSyncedState_userMustChoose ||
-                             stall->reason() ==
-                                 mega::MegaSyncStall::SyncStallReason::
-                                     LocalAndRemotePreviouslyUnsyncedDiffer_userMustChoose)
-                    {
-                        d = std::make_shared<LocalOrRemoteUserMustChooseStalledIssue>(stall);
+                        d = mMoveOrRenameCannotOccurFactory->createIssue(multiStepIssueSolver, stall);
+
+                        // If we find a MoveOrRenameCannotOccur issue, we don´t want to show
+                        // the DeleteWaitingOnMove and DeleteOrMoveWaitingOnScanning
+                        reasonsToFilter
+                            << mega::MegaSyncStall::SyncStallReason::DeleteWaitingOnMoves
+                            << mega::MegaSyncStall::SyncStallReason::DeleteOrMoveWaitingOnScanning;
                     }
                     else
                     {
-                        d = std::make_shared<StalledIssue>(stall);
+                        if (stall->reason() ==
+                            mega::MegaSyncStall::SyncStallReason::NamesWouldClashWhenSynced)
+                        {
+                            d = std::make_shared<NameConflictedStalledIssue>(stall);
+                        }
+                        else if (stall->reason() == mega::MegaSyncStall::SyncStallReason::DownloadIssue)
+                        {
+                            d = DownloadFileIssueFactory::createAndFillIssue(stall);
+                        }
+                        else if (stall->couldSuggestIgnoreThisPath(false, 0) ||
+                                 stall->couldSuggestIgnoreThisPath(false, 1) ||
+                                 stall->couldSuggestIgnoreThisPath(true, 0) ||
+                                 stall->couldSuggestIgnoreThisPath(true, 1))
+                        {
+                            d = std::make_shared<IgnoredStalledIssue>(stall);
+                        }
+                        else if (StalledIssue::isCloudNodeBlocked(stall))
+                        {
+                            d = std::make_shared<CloudNodeIsBlockedIssue>(stall);
+                        }
+                        else if (stall->reason() ==
+                                 mega::MegaSyncStall::SyncStallReason::FolderMatchedAgainstFile)
+                        {
+                            d = std::make_shared<FolderMatchedAgainstFileIssue>(stall);
+                        }
+                        else if (stall->reason() ==
+                                     mega::MegaSyncStall::SyncStallReason::
+                                         LocalAndRemoteChangedSinceLastSyncedState_userMustChoose ||
+                                 stall->reason() ==
+                                     mega::MegaSyncStall::SyncStallReason::
+                                         LocalAndRemotePreviouslyUnsyncedDiffer_userMustChoose)
+                        {
+                            d = std::make_shared<LocalOrRemoteUserMustChooseStalledIssue>(stall);
+                        }
+                        else
+                        {
+                            d = std::make_shared<StalledIssue>(stall);
+                        }
                     }
-                }
 
-                if (d)
-                {
-                    variant = StalledIssueVariant(d, stall);
+                    if (d)
+                    {
+                        variant = StalledIssueVariant(d, stall);
+                    }
                 }
 
                 if (!variant.isValid() || variant.shouldBeIgnored())
@@ -181,7 +198,10 @@ void StalledIssuesCreator::createIssues(const mega::MegaSyncStallMap* stallsMap,
                 {
                     // Init issue file/folder attributes, needed to check if the issue is
                     // autosolvable
-                    variant.getData()->endFillingIssue();
+                    if (!reused)
+                    {
+                        variant.getData()->endFillingIssue();
+                    }
 
                     if (updateType == UpdateType::EVENT)
                     {
@@ -296,6 +316,15 @@ void StalledIssuesCreator::createIssues(const mega::MegaSyncStallMap* stallsMap,
             }
         }
 
+        if (updateType == UpdateType::UI)
+        {
+            mPreviousIssues.clear();
+            for (const auto& issue: qAsConst(mStalledIssues.mActiveStalledIssues))
+            {
+                mPreviousIssues.insert(issue.consultData()->getOriginalStall()->getHash(), issue);
+            }
+        }
+
         finish();
     }
 }
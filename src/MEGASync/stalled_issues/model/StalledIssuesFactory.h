@@ -120,6 +120,8 @@ private:
     QMultiMap<mega::MegaSyncStall::SyncStallReason,
         MultiStepIssueSolverBase*> mMultiStepIssueSolversByReason;
     std::shared_ptr<MoveOrRenameCannotOccurFactory> mMoveOrRenameCannotOccurFactory;
+    // Active issues of the last UI update, by stall hash
+    QHash<size_t, StalledIssueVariant> mPreviousIssues;
 };
 
 Q_DECLARE_METATYPE(StalledIssuesCreator::IssuesCount)
@@ -16,6 +16,9 @@
 #include "StatsEventHandler.h"
 #include "SyncController.h"
 
+#include <QSemaphore>
+#include <QtConcurrent/QtConcurrent>
+
 StalledIssuesReceiver::StalledIssuesReceiver(QObject* parent) : QObject(parent), mega::MegaRequestListener()
 {
     connect(&mIssueCreator, &StalledIssuesCreator::solvingIssues, this, &StalledIssuesReceiver::solvingIssues);
@@ -67,6 +70,8 @@ const int UPDATE_ISSUES_INTERVAL = 5000; /*5 seconds*/
 const int UPDATE_ISSUES_MAX_INTERVAL = 300000; /*5 minutes*/
 const int UPDATE_ISSUES_INTERVAL_DELAY_CONSTANT = 2;
 const int MAX_EMPTY_STALLED_LIST_ALLOWED = 5;
+const int SOLVE_ISSUES_MAX_THREADS = 4;
+const int SOLVE_ISSUES_PROGRESS_WAIT_MS = 100;
 
 StalledIssuesModel::StalledIssuesModel():
     QAbstractItemModel(),
@@ -78,6 +83,7 @@ StalledIssuesModel::StalledIssuesModel():
 {
     mStalledIssuesThread = new QThread();
     mStalledIssuesReceiver = new StalledIssuesReceiver();
+    mSolveIssuesThreadPool.setMaxThreadCount(SOLVE_ISSUES_MAX_THREADS);
 
     mRequestListener =
         std::make_unique<mega::QTMegaRequestListener>(mMegaApi, mStalledIssuesReceiver);
@@ -280,7 +286,7 @@ void StalledIssuesModel::onProcessStalledIssues(ReceivedStalledIssues issuesRece
             [this, issuesReceived, updateType, updateTimer]() mutable {
                 if (updateType == UpdateType::UI)
                 {
-                    reset();
+                    removeOutdatedIssues(issuesReceived.activeStalledIssues());
                 }
 
                 checkActiveIssues(issuesReceived.activeStalledIssues());
@@ -413,6 +419,88 @@ void StalledIssuesModel::checkIssues(StalledIssuesVariantList& list,
     }
 }
 
+void StalledIssuesModel::removeOutdatedIssues(const StalledIssuesVariantList& receivedIssues)
+{
+    QSet<long long unsigned> receivedHashes;
+    for (const auto& issue: receivedIssues)
+    {
+        receivedHashes.insert(issue.consultData()->getOriginalStall()->getHash());
+    }
+
+    QSet<const StalledIssue*> solvedIssues;
+    for (const auto& issue: qAsConst(mSolvedStalledIssues))
+    {
+        solvedIssues.insert(issue.consultData().get());
+    }
+
+    // Solved issues are kept as in reset(), and the active ones while they are still stalled
+    QSet<long long unsigned> keptHashes;
+    QVector<bool> keepRow(mStalledIssues.size(), false);
+    for (int row = 0; row < mStalledIssues.size(); ++row)
+    {
+        auto issue(mStalledIssues.at(row).consultData());
+        auto hash(issue->getOriginalStall()->getHash());
+
+        if (solvedIssues.contains(issue.get()))
+        {
+            keepRow[row] = true;
+        }
+        else if (issue->isValid() && (issue->isUnsolved() || issue->isBeingSolved()) &&
+                 receivedHashes.contains(hash) && !keptHashes.contains(hash))
+        {
+            keptHashes.insert(hash);
+            keepRow[row] = true;
+        }
+    }
+
+    // Remove the rest from the bottom, one block of contiguous rows at a time
+    int row(mStalledIssues.size() - 1);
+    while (row >= 0)
+    {
+        if (keepRow.at(row))
+        {
+            --row;
+            continue;
+        }
+
+        auto last(row);
+        while (row > 0 && !keepRow.at(row - 1))
+        {
+            --row;
+        }
+
+        beginRemoveRows(QModelIndex(), row, last);
+        mModelMutex.lockForWrite();
+        mStalledIssues.erase(mStalledIssues.begin() + row, mStalledIssues.begin() + last + 1);
+        mFilterRecords.remove(row, last - row + 1);
+        mModelMutex.unlock();
+        endRemoveRows();
+
+        --row;
+    }
+
+    mFailedStalledIssues.clear();
+    mStalledIssuesByOrder.clear();
+    mCountByFilterCriterion.clear();
+    mStalledIssueRowByHash.clear();
+    mStalledIssuesByHandle.clear();
+
+    for (int row = 0; row < mStalledIssues.size(); ++row)
+    {
+        auto issue(mStalledIssues.at(row).consultData());
+        mStalledIssuesByOrder.insert(issue.get(), row);
+        addStalledIssueHandles(issue.get());
+        mStalledIssueRowByHash.insert(issue->getOriginalStall()->getHash(), issue.get());
+
+        auto criterion(solvedIssues.contains(issue.get()) ?
+                           StalledIssueFilterCriterion::SOLVED_CONFLICTS :
+                           StalledIssue::getCriterionByReason(issue->getReason()));
+        mCountByFilterCriterion[static_cast<int>(criterion)]++;
+    }
+
+    emit stalledIssuesCountChanged();
+}
+
 void StalledIssuesModel::appendCachedIssuesToModel(
     const StalledIssuesVariantList& list, StalledIssueFilterCriterion type)
 {
@@ -434,6 +522,8 @@ void StalledIssuesModel::appendCachedIssuesToModel(
 
             mStalledIssues.append(issue);
             mStalledIssuesByOrder.insert(issue.consultData().get(), rowCount(QModelIndex()) - 1);
+            addStalledIssueHandles(issue.consultData().get());
+            mFilterRecords.append(createFilterRecord(issue.consultData().get()));
 
             if (type == StalledIssueFilterCriterion::ALL_ISSUES)
             {
@@ -514,6 +604,46 @@ StalledIssueVariant StalledIssuesModel::getStalledIssueByRow(int row) const
     return issue;
 }
 
+QVector<bool> StalledIssuesModel::getRowsAcceptedByFilter(StalledIssueFilterCriterion criterion) const
+{
+    QVector<bool> acceptedRows;
+    mModelMutex.lockForRead();
+    acceptedRows.reserve(mFilterRecords.size());
+    for (const auto& record: mFilterRecords)
+    {
+        acceptedRows.append(acceptsFilterCriterion(record, criterion));
+    }
+    mModelMutex.unlock();
+    return acceptedRows;
+}
+
+StalledIssuesModel::FilterRecord StalledIssuesModel::createFilterRecord(const StalledIssue* issue)
+{
+    FilterRecord record;
+    record.issue = issue;
+    record.criterion = StalledIssue::getCriterionByReason(issue->getReason());
+    return record;
+}
+
+bool StalledIssuesModel::acceptsFilterCriterion(const FilterRecord& record,
+                                                StalledIssueFilterCriterion criterion)
+{
+    // The solved state changes, so it is read from the issue
+    if (!record.issue->isUnsolved())
+    {
+        if (record.issue->isSolved() && !record.issue->isPotentiallySolved())
+        {
+            return criterion == StalledIssueFilterCriterion::SOLVED_CONFLICTS;
+        }
+        else if (record.issue->isFailed() && criterion == StalledIssueFilterCriterion::FAILED_CONFLICTS)
+        {
+            return true;
+        }
+    }
+
+    return criterion == StalledIssueFilterCriterion::ALL_ISSUES || record.criterion == criterion;
+}
+
 StalledIssueVariant StalledIssuesModel::getIssueVariantByIssue(const StalledIssue* issue)
 {
     auto row(mStalledIssuesByOrder.value(issue, -1));
@@ -560,30 +690,37 @@ void StalledIssuesModel::onNodesUpdate(mega::MegaApi*, mega::MegaNodeList* nodes
                 }
 
                 mega::MegaNode *node = copiedNodes->get(i);
+                auto issues(mStalledIssuesByHandle.values(node->getHandle()));
+                if (issues.isEmpty())
+                {
+                    continue;
+                }
+
                 if (node->getChanges() & mega::MegaNode::CHANGE_TYPE_PARENT)
                 {
                     std::unique_ptr<mega::MegaNode> parentNode(MegaSyncApp->getMegaApi()->getNodeByHandle(node->getParentHandle()));
                     if(parentNode && parentNode->getType() == mega::MegaNode::TYPE_FILE)
                     {
-                        for(int row = 0; row < rowCount(QModelIndex()); ++row)
+                        // The node now hangs from a file (a version), look for the first file
+                        // whose parent is not a file, once for all the issues containing it
+                        auto currentParentHandle(parentNode->getHandle());
+                        while (parentNode && parentNode->getType() == mega::MegaNode::TYPE_FILE)
+                        {
+                            currentParentHandle = parentNode->getHandle();
+                            parentNode.reset(MegaSyncApp->getMegaApi()->getParentNode(parentNode.get()));
+                        }
+
+                        foreach(auto issue, issues)
                         {
-                            auto item(getStalledIssueByRow(row));
+                            auto item(getIssueVariantByIssue(issue));
 
-                            if(item.getData()->containsHandle(node->getHandle()))
+                            if(item.isValid() && item.getData()->containsHandle(node->getHandle()))
                             {
-                                auto parentFound(false);
-                                while (!parentFound)
-                                {
-                                    auto currentParentHandle(parentNode->getHandle());
-                                    auto parentNodeRaw(MegaSyncApp->getMegaApi()->getParentNode(parentNode.get()));
-                                    parentNode.reset(parentNodeRaw);
-                                    if(!parentNode || parentNode->getType() != mega::MegaNode::TYPE_FILE)
-                                    {
-                                        item.getData()->updateHandle(currentParentHandle);
-                                        item.getData()->resetUIUpdated();
-                                        parentFound = true;
-                                    }
-                                }
+                                item.getData()->updateHandle(currentParentHandle);
+                                item.getData()->resetUIUpdated();
+
+                                mStalledIssuesByHandle.remove(node->getHandle(), issue);
+                                addStalledIssueHandles(issue);
                             }
                         }
                     }
@@ -591,11 +728,11 @@ void StalledIssuesModel::onNodesUpdate(mega::MegaApi*, mega::MegaNodeList* nodes
                 else if (node->getChanges() & mega::MegaNode::CHANGE_TYPE_COUNTER &&
                         node->isFolder())
                 {
-                    for (int row = 0; row < rowCount(QModelIndex()); ++row)
+                    foreach(auto issue, issues)
                     {
-                        auto item(getStalledIssueByRow(row));
+                        auto item(getIssueVariantByIssue(issue));
 
-                        if (item.getData()->containsHandle(node->getHandle()))
+                        if (item.isValid() && item.getData()->containsHandle(node->getHandle()))
                         {
                             item.getData()->resetUIUpdated();
                         }
@@ -796,6 +933,7 @@ bool StalledIssuesModel::removeRows(int row, int count, const QModelIndex& paren
         for (auto i (0); i < count; ++i)
         {
             mStalledIssues.removeAt(i);
+            mFilterRecords.removeAt(i);
         }
 
         endRemoveRows();
@@ -812,12 +950,14 @@ void StalledIssuesModel::updateStalledIssuedByOrder()
 {
     mStalledIssuesByOrder.clear();
     mCountByFilterCriterion.clear();
+    mStalledIssuesByHandle.clear();
 
     //Recalculate rest of items
     for(int row = 0; row < rowCount(QModelIndex()); ++row)
     {
         auto item = getStalledIssueByRow(row);
         mStalledIssuesByOrder.insert(item.consultData().get(), row);
+        addStalledIssueHandles(item.consultData().get());
 
         mCountByFilterCriterion[static_cast<int>(StalledIssue::getCriterionByReason(item.consultData()->getReason()))]++;
     }
@@ -825,6 +965,17 @@ void StalledIssuesModel::updateStalledIssuedByOrder()
     emit stalledIssuesCountChanged();
 }
 
+void StalledIssuesModel::addStalledIssueHandles(const StalledIssue* issue)
+{
+    foreach(auto handle, issue->getHandles())
+    {
+        if (!mStalledIssuesByHandle.contains(handle, issue))
+        {
+            mStalledIssuesByHandle.insert(handle, issue);
+        }
+    }
+}
+
 int StalledIssuesModel::getRowByStalledIssue(const std::shared_ptr<const StalledIssue> issue) const
 {
     return mStalledIssuesByOrder.value(issue.get(), -1);
@@ -941,6 +1092,8 @@ void StalledIssuesModel::reset()
     mStalledIssuesByOrder.clear();
     mCountByFilterCriterion.clear();
     mStalledIssueRowByHash.clear();
+    mStalledIssuesByHandle.clear();
+    mFilterRecords.clear();
     mSolvedStalledIssues.clear();
 
     endResetModel();
@@ -1056,65 +1209,75 @@ void StalledIssuesModel::solveListOfIssues(const SolveListInfo &info)
 
         StalledIssuesCreator::IssuesCount count;
         int issuesExternallyChanged(0);
-        auto totalRows(info.indexes.size());
-        foreach(auto index, info.indexes)
+        if (info.groupFunc && !info.async)
         {
-            if (checkIfUserStopSolving())
-            {
-                break;
-            }
-
-            // Don´t block the UI if the issue is being solve asynchronously
-            if (!info.async)
-            {
-                sendFixingIssuesMessage(count.currentIssueBeingSolved, totalRows);
-            }
-
-            if (mThreadFinished)
+            if (!solveListOfIssuesByGroups(info, count, issuesExternallyChanged))
             {
                 return;
             }
-
-            auto potentialIndex = getSolveIssueIndex(index);
-            mModelMutex.lockForRead();
-            auto issue(mStalledIssues.at(potentialIndex.row()));
-            mModelMutex.unlock();
-
-            if (issue.getData())
+        }
+        else
+        {
+            auto totalRows(info.indexes.size());
+            foreach(auto index, info.indexes)
             {
-                if (issue.getData()->isFailed())
+                if (checkIfUserStopSolving())
                 {
-                    mFailedStalledIssues.removeOne(issue);
-                    mCountByFilterCriterion[static_cast<int>(
-                        StalledIssueFilterCriterion::FAILED_CONFLICTS)]--;
+                    break;
                 }
 
-                if (issue.getData()->checkForExternalChanges())
+                // Don´t block the UI if the issue is being solve asynchronously
+                if (!info.async)
                 {
-                    issuesExternallyChanged++;
-                    count.issuesFailed++;
+                    sendFixingIssuesMessage(count.currentIssueBeingSolved, totalRows);
                 }
-                else
+
+                if (mThreadFinished)
                 {
-                    if (info.solveFunc)
+                    return;
+                }
+
+                auto potentialIndex = getSolveIssueIndex(index);
+                mModelMutex.lockForRead();
+                auto issue(mStalledIssues.at(potentialIndex.row()));
+                mModelMutex.unlock();
+
+                if (issue.getData())
+                {
+                    if (issue.getData()->isFailed())
+                    {
+                        mFailedStalledIssues.removeOne(issue);
+                        mCountByFilterCriterion[static_cast<int>(
+                            StalledIssueFilterCriterion::FAILED_CONFLICTS)]--;
+                    }
+
+                    if (issue.getData()->checkForExternalChanges())
+                    {
+                        issuesExternallyChanged++;
+                        count.issuesFailed++;
+                    }
+                    else
                     {
-                        auto result(info.solveFunc(potentialIndex.row()));
-                        if (!info.async)
+                        if (info.solveFunc)
                         {
-                            if (result)
+                            auto result(info.solveFunc(potentialIndex.row()));
+                            if (!info.async)
                             {
-                                count.issuesFixed++;
-                            }
-                            else
-                            {
-                                count.issuesFailed++;
+                                if (result)
+                                {
+                                    count.issuesFixed++;
+                                }
+                                else
+                                {
+                                    count.issuesFailed++;
+                                }
+                                issueSolvingFinished(issue.getData().get(), result);
                             }
-                            issueSolvingFinished(issue.getData().get(), result);
                         }
                     }
                 }
+                count.currentIssueBeingSolved++;
             }
-            count.currentIssueBeingSolved++;
         }
 
         if (!info.async)
@@ -1148,6 +1311,196 @@ void StalledIssuesModel::solveListOfIssues(const SolveListInfo &info)
     });
 }
 
+bool StalledIssuesModel::solveListOfIssuesByGroups(const SolveListInfo& info,
+                                                   StalledIssuesCreator::IssuesCount& count,
+                                                   int& issuesExternallyChanged)
+{
+    struct SolveTask
+    {
+        int row = -1;
+        StalledIssueVariant issue;
+        // Failed before solving it: it leaves the failed ones only if it is processed
+        bool wasFailed = false;
+        bool processed = false;
+        bool externallyChanged = false;
+        bool solved = false;
+    };
+
+    std::vector<SolveTask> tasks;
+    tasks.reserve(static_cast<size_t>(info.indexes.size()));
+    // The groups sharing a key are merged, and the merged ones are left empty
+    QVector<QVector<size_t>> groupTasks;
+    QHash<QString, int> groupByKey;
+
+    foreach(auto index, info.indexes)
+    {
+        SolveTask task;
+        task.row = getSolveIssueIndex(index).row();
+        task.issue = getStalledIssueByRow(task.row);
+
+        if (task.issue.getData())
+        {
+            task.wasFailed = task.issue.getData()->isFailed();
+
+            auto keys(info.groupFunc(task.row));
+            int group(-1);
+            foreach(auto key, keys)
+            {
+                auto keyGroup(groupByKey.value(key, -1));
+                if (keyGroup < 0 || keyGroup == group)
+                {
+                    continue;
+                }
+
+                if (group < 0)
+                {
+                    group = keyGroup;
+                }
+                else
+                {
+                    groupTasks[group].append(groupTasks[keyGroup]);
+                    groupTasks[keyGroup].clear();
+                    for (auto it = groupByKey.begin(); it != groupByKey.end(); ++it)
+                    {
+                        if (it.value() == keyGroup)
+                        {
+                            it.value() = group;
+                        }
+                    }
+                }
+            }
+
+            if (group < 0)
+            {
+                group = groupTasks.size();
+                groupTasks.append(QVector<size_t>());
+            }
+
+            foreach(auto key, keys)
+            {
+                groupByKey.insert(key, group);
+            }
+
+            groupTasks[group].append(tasks.size());
+            tasks.push_back(task);
+        }
+    }
+
+    // Every group is solved in order in a thread of the pool, and the groups at the same time.
+    // The progress and the model are only updated from this thread
+    auto totalRows(info.indexes.size());
+    QSemaphore issuesProcessed;
+    sendFixingIssuesMessage(0, totalRows);
+
+    QList<QFuture<void>> groups;
+    for (auto& taskIndexes: groupTasks)
+    {
+        if (taskIndexes.isEmpty())
+        {
+            continue;
+        }
+
+        // Merged groups are not in the order of the list
+        std::sort(taskIndexes.begin(), taskIndexes.end());
+        groups.append(QtConcurrent::run(
+            &mSolveIssuesThreadPool,
+            [this, &info, &tasks, &issuesProcessed, taskIndexes]()
+            {
+                foreach(auto taskIndex, taskIndexes)
+                {
+                    if (mThreadFinished || mSolvingIssuesStopped)
+                    {
+                        return;
+                    }
+
+                    auto& task(tasks[taskIndex]);
+                    if (task.issue.getData()->checkForExternalChanges())
+                    {
+                        task.externallyChanged = true;
+                    }
+                    else if (info.solveFunc)
+                    {
+                        task.solved = info.solveFunc(task.row);
+                    }
+                    task.processed = true;
+
+                    issuesProcessed.release();
+                }
+            }));
+    }
+
+    int issuesReported(0);
+    while (issuesReported < static_cast<int>(tasks.size()))
+    {
+        if (issuesProcessed.tryAcquire(1, SOLVE_ISSUES_PROGRESS_WAIT_MS))
+        {
+            sendFixingIssuesMessage(++issuesReported, totalRows);
+        }
+        else if (std::all_of(groups.cbegin(),
+                             groups.cend(),
+                             [](const QFuture<void>& group)
+                             {
+                                 return group.isFinished();
+                             }))
+        {
+            // Stopped before processing all of them
+            while (issuesProcessed.tryAcquire())
+            {
+                sendFixingIssuesMessage(++issuesReported, totalRows);
+            }
+            break;
+        }
+    }
+
+    for (auto& group: groups)
+    {
+        group.waitForFinished();
+    }
+
+    // Resets the stop flag
+    checkIfUserStopSolving();
+    if (mThreadFinished)
+    {
+        return false;
+    }
+
+    for (auto& task: tasks)
+    {
+        if (!task.processed)
+        {
+            continue;
+        }
+
+        if (task.wasFailed)
+        {
+            mFailedStalledIssues.removeOne(task.issue);
+            mCountByFilterCriterion[static_cast<int>(
+                StalledIssueFilterCriterion::FAILED_CONFLICTS)]--;
+        }
+
+        if (task.externallyChanged)
+        {
+            issuesExternallyChanged++;
+            count.issuesFailed++;
+        }
+        else
+        {
+            if (task.solved)
+            {
+                count.issuesFixed++;
+            }
+            else
+            {
+                count.issuesFailed++;
+            }
+            issueSolvingFinished(task.issue.getData().get(), task.solved);
+        }
+        count.currentIssueBeingSolved++;
+    }
+
+    return true;
+}
+
 void StalledIssuesModel::showIssueExternallyChangedMessageBox()
 {
     MessageDialogInfo msgInfo;
@@ -1711,7 +2064,26 @@ void StalledIssuesModel::semiAutoSolveNameConflictIssues(const QModelIndexList&
         return result;
     };
 
+    // Solving a conflict merges and renames nodes of the parent folders, so the conflicts of the
+    // same sync are solved one after the other and only the ones of different syncs at the same time
+    auto groupIssue = [this](int row) -> QStringList
+    {
+        QStringList groups;
+        auto item(getStalledIssueByRow(row));
+        foreach(auto syncId, item.consultData()->syncIds())
+        {
+            groups.append(QString::number(syncId));
+        }
+
+        if(groups.isEmpty())
+        {
+            groups.append(QString::number(mega::INVALID_HANDLE));
+        }
+        return groups;
+    };
+
     SolveListInfo info(list, resolveIssue);
+    info.groupFunc = groupIssue;
     solveListOfIssues(info);
 }
 
@@ -15,6 +15,7 @@
 #include <QObject>
 #include <QPointer>
 #include <QReadWriteLock>
+#include <QThreadPool>
 #include <QTimer>
 
 class LoadingSceneMessageHandler;
@@ -142,6 +143,8 @@ public:
     int columnCount(const QModelIndex& = QModelIndex()) const override;
     QVariant data(const QModelIndex& index, int role) const override;
     StalledIssueVariant getStalledIssueByRow(int row) const;
+    // Whether every row is shown with the filter criterion, checked in one go
+    QVector<bool> getRowsAcceptedByFilter(StalledIssueFilterCriterion criterion) const;
     QModelIndex parent(const QModelIndex& index) const override;
     QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
@@ -266,6 +269,8 @@ private:
     void checkActiveIssues(StalledIssuesVariantList& receivedIssues);
     void checkAutoSolvedIssues(StalledIssuesVariantList& receivedIssues);
     void checkFailedAutoSolvedIssues(StalledIssuesVariantList& receivedIssues);
+    // Removes the rows not received again, so only the new issues are appended afterwards
+    void removeOutdatedIssues(const StalledIssuesVariantList& receivedIssues);
 
     void needsUpdate();
     void setIssuesRequested(bool state);
@@ -273,6 +278,7 @@ private:
     void removeRows(QModelIndexList& indexesToRemove);
     bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
     void updateStalledIssuedByOrder();
+    void addStalledIssueHandles(const StalledIssue* issue);
     int getRowByStalledIssue(const std::shared_ptr<const StalledIssue> issue) const;
     int getRowByStalledIssue(const StalledIssue* issue) const;
     void reset();
@@ -303,9 +309,16 @@ private:
         std::function<bool(int)> solveFunc = nullptr;
         std::function<void ()> startFunc = nullptr;
         std::function<void (int, bool)> finishFunc = nullptr;
+        // When set, the issues are solved in parallel: the ones sharing any of the keys returned
+        // are solved one after the other, as they may depend on each other
+        std::function<QStringList (int)> groupFunc = nullptr;
     };
 
     void solveListOfIssues(const SolveListInfo& info);
+    // Returns false if the receiver thread is finishing
+    bool solveListOfIssuesByGroups(const SolveListInfo& info,
+                                   StalledIssuesCreator::IssuesCount& count,
+                                   int& issuesExternallyChanged);
     bool issueSolvingFinished(const StalledIssue* issue);
     bool issueSolvingFinished(StalledIssue* issue, bool wasSuccessful);
     bool issueSolved(const StalledIssue* issue);
@@ -333,6 +346,19 @@ private:
     mutable StalledIssuesVariantList mFailedStalledIssues;
     mutable QHash<const StalledIssue*, int> mStalledIssuesByOrder;
     mutable QMultiHash<unsigned long long, const StalledIssue*> mStalledIssueRowByHash;
+    // Issues by the node handles they contain, so node updates only check the affected ones
+    mutable QMultiHash<mega::MegaHandle, const StalledIssue*> mStalledIssuesByHandle;
+
+    // What the filter needs from every row, in row order, so it does not go through data()
+    struct FilterRecord
+    {
+        const StalledIssue* issue = nullptr;
+        StalledIssueFilterCriterion criterion = StalledIssueFilterCriterion::ALL_ISSUES;
+    };
+    QVector<FilterRecord> mFilterRecords;
+    static FilterRecord createFilterRecord(const StalledIssue* issue);
+    static bool acceptsFilterCriterion(const FilterRecord& record,
+                                       StalledIssueFilterCriterion criterion);
 
     QHash<int, int> mCountByFilterCriterion;
 
@@ -347,6 +373,8 @@ private:
     std::atomic_bool mSolvingIssues {false};
     std::atomic_bool mIssuesSolved {false};
     std::atomic_bool mSolvingIssuesStopped {false};
+    // Bounds the filesystem and SDK requests done at the same time when solving by groups
+    QThreadPool mSolveIssuesThreadPool;
 
     //SyncDisable for backups
     QList<std::shared_ptr<SyncSettings>> mSyncsToDisable;
@@ -39,6 +39,7 @@ void StalledIssuesProxyModel::filter(StalledIssueFilterCriterion filterCriterion
             blockSignals(true);
             sourceM->blockSignals(true);
 
+            mAcceptedRows = sourceM->getRowsAcceptedByFilter(mFilterCriterion);
             invalidate();
             for (auto row = 0; row < rowCount(QModelIndex()); ++row)
             {
@@ -46,6 +47,7 @@ void StalledIssuesProxyModel::filter(StalledIssueFilterCriterion filterCriterion
                 hasChildren(proxyIndex);
             }
             QSortFilterProxyModel::sort(0, sortOrder());
+            mAcceptedRows.clear();
 
             blockSignals(false);
             sourceM->blockSignals(false);
@@ -93,6 +95,18 @@ bool StalledIssuesProxyModel::canFetchMore(const QModelIndex &parent) const
 
 bool StalledIssuesProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
+    // The body is shown with its header
+    if(source_parent.isValid())
+    {
+        return true;
+    }
+
+    // Only filled while the whole model is filtered, single rows are checked one by one
+    if(source_row < mAcceptedRows.size())
+    {
+        return mAcceptedRows.at(source_row);
+    }
+
     QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
 
     if(index.data().isValid())
@@ -38,6 +38,8 @@ private slots:
 
 private:
     StalledIssueFilterCriterion mFilterCriterion;
+    // Filter result by source row, computed by the source model in one go while filtering
+    QVector<bool> mAcceptedRows;
     QFutureWatcher<void> mFilterWatcher;
 };
 
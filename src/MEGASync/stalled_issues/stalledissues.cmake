@@ -9,6 +9,7 @@ set(DESKTOP_APP_STALLED_ISSUES_HEADERS
     ${CMAKE_CURRENT_LIST_DIR}/gui/StalledIssueFilePath.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/StalledIssuesView.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/StalledIssuesDelegateWidgetsCache.h
+    ${CMAKE_CURRENT_LIST_DIR}/gui/StalledIssuesWidgetsPool.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/StalledIssuesDialog.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/StalledIssueHeader.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/stalled_issues_cases/LocalAndRemoteDifferentWidget.h
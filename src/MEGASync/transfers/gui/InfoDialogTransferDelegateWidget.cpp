@@ -265,7 +265,7 @@ TransferBaseDelegateWidget::ActionHoverType InfoDialogTransferDelegateWidget::mo
                 {
                     update = setActionTransferIcon(mUi->lActionTransfer,
                                                    QString::fromLatin1(":/alert-circle.svg"));
-                    // Double check that the mFailedTransfer is OK
+                    // Double check that the retry info is OK
                     if (getData()->isFailed())
                     {
                         mUi->lActionTransfer->setToolTip(tr("Failed: %1").arg(getErrorText()));
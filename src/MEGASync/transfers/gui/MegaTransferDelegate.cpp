@@ -4,6 +4,7 @@
 #include "MegaDelegateHoverManager.h"
 #include "TokenParserWidgetManager.h"
 #include "TransferBaseDelegateWidget.h"
+#include "TransferManagerDelegateWidget.h"
 #include "TransfersModel.h"
 
 #include <QEvent>
@@ -27,6 +28,20 @@ MegaTransferDelegate::MegaTransferDelegate(TransfersSortFilterProxyBaseModel* mo
 MegaTransferDelegate::~MegaTransferDelegate()
 {
     qDeleteAll(mTransferItems);
+    delete mLayoutTemplate;
+}
+
+void MegaTransferDelegate::setPaintOnlyMode(bool state)
+{
+    if (state && !mRowPainter)
+    {
+        mRowPainter = std::make_unique<TransferManagerRowPainter>();
+    }
+    else if (!state)
+    {
+        mRowPainter.reset();
+        delete mLayoutTemplate;
+    }
 }
 
 void MegaTransferDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
@@ -40,12 +55,6 @@ void MegaTransferDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
         auto transferItem (qvariant_cast<TransferItem>(index.data(Qt::DisplayRole)));
         auto data = transferItem.getTransferData();
 
-        TransferBaseDelegateWidget* w (getTransferItemWidget(index, option.rect.size()));
-        if(!w)
-        {
-            return;
-        }
-
 #ifdef Q_OS_MACOS
         auto width = mView->width();
         width -= mView->contentsMargins().left();
@@ -58,6 +67,23 @@ void MegaTransferDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
         auto width (option.rect.width());
 #endif
 
+        // The hovered row is rendered with its widget, so the action buttons react to the mouse
+        if (mRowPainter && data && !(option.state & QStyle::State_MouseOver))
+        {
+            QStyleOptionViewItem rowOption(option);
+            rowOption.rect = QRect(pos, QSize(width, height));
+            if (paintRow(painter, rowOption, data))
+            {
+                return;
+            }
+        }
+
+        TransferBaseDelegateWidget* w (getTransferItemWidget(index, option.rect.size()));
+        if(!w)
+        {
+            return;
+        }
+
         // Move if position changed
         if (w->pos() != pos)
         {
@@ -116,6 +142,48 @@ bool MegaTransferDelegate::event(QEvent *event)
     return QStyledItemDelegate::event(event);
 }
 
+bool MegaTransferDelegate::paintRow(QPainter* painter,
+                                    const QStyleOptionViewItem& option,
+                                    const QExplicitlySharedDataPointer<TransferData>& data) const
+{
+    // Never shown, only used to take the geometry, fonts and colors of the rows
+    if (!mLayoutTemplate)
+    {
+        auto item(createTransferItemWidget());
+        mLayoutTemplate = dynamic_cast<TransferManagerDelegateWidget*>(item);
+        if (!mLayoutTemplate)
+        {
+            delete item;
+            return false;
+        }
+    }
+
+    auto key(mLayoutTemplate->getPaintLayoutKey(option.rect.width()));
+    if (!mRowPainter->hasLayout(key))
+    {
+        mRowPainter->setLayout(mLayoutTemplate->getPaintLayout(option.rect.size()));
+    }
+
+    mRowPainter->paint(painter, option, data);
+    return true;
+}
+
+TransferBaseDelegateWidget* MegaTransferDelegate::createTransferItemWidget() const
+{
+    auto item = mProxyModel->createTransferManagerItem(mView);
+    TokenParserWidgetManager::instance()->applyCurrentTheme(item);
+    // Setting again its own parent will tell the widget that the stylesheet needs to be
+    // reloaded
+    item->setParent(item->parentWidget(), item->windowFlags());
+
+    // Refresh completely the widget
+    item->show();
+    TokenParserWidgetManager::instance()->polish(item);
+    item->hide();
+
+    return item;
+}
+
 TransferBaseDelegateWidget *MegaTransferDelegate::getTransferItemWidget(const QModelIndex& index, const QSize& size) const
 {
     TransferBaseDelegateWidget* item(nullptr);
@@ -123,7 +191,8 @@ TransferBaseDelegateWidget *MegaTransferDelegate::getTransferItemWidget(const QM
     if(index.isValid())
     {
         auto nbRowsMaxInView(1);
-        if(size.height() > 0)
+        // In paint-only mode, the only row rendered with a widget is the hovered one
+        if(size.height() > 0 && !mRowPainter)
         {
             nbRowsMaxInView = mView->height() / size.height() + 1;
         }
@@ -131,17 +200,7 @@ TransferBaseDelegateWidget *MegaTransferDelegate::getTransferItemWidget(const QM
 
         if(row >= mTransferItems.size())
         {
-            item = mProxyModel->createTransferManagerItem(mView);
-            TokenParserWidgetManager::instance()->applyCurrentTheme(item);
-            // Setting again its own parent will tell the widget that the stylesheet needs to be
-            // reloaded
-            item->setParent(item->parentWidget(), item->windowFlags());
-
-            // Refresh completely the widget
-            item->show();
-            TokenParserWidgetManager::instance()->polish(item);
-            item->hide();
-
+            item = createTransferItemWidget();
             mTransferItems.append(item);
         }
         else
@@ -1,14 +1,19 @@
 #ifndef MEGATRANSFERDELEGATE_H
 #define MEGATRANSFERDELEGATE_H
 
+#include "TransferManagerRowPainter.h"
 #include "TransfersModel.h"
 
 #include <QAbstractButton>
 #include <QAbstractItemView>
+#include <QPointer>
 #include <QStyledItemDelegate>
 
+#include <memory>
+
 class TransfersSortFilterProxyBaseModel;
 class TransferBaseDelegateWidget;
+class TransferManagerDelegateWidget;
 
 class MegaTransferDelegate : public QStyledItemDelegate
 {
@@ -20,6 +25,10 @@ public:
 
     QSize sizeHint(const QStyleOptionViewItem&, const QModelIndex&) const override;
 
+    // Paint-only mode: rows are painted straight with QPainter, and a delegate widget is only used
+    // for the hovered row (and its mouse events). Only for Transfer Manager rows.
+    void setPaintOnlyMode(bool state);
+
 protected:
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
     bool event(QEvent *event) override;
@@ -34,11 +43,17 @@ protected slots:
 private:
     TransferBaseDelegateWidget* getTransferItemWidget(const QModelIndex& index,
                                                       const QSize& size) const;
+    TransferBaseDelegateWidget* createTransferItemWidget() const;
+    bool paintRow(QPainter* painter,
+                  const QStyleOptionViewItem& option,
+                  const QExplicitlySharedDataPointer<TransferData>& data) const;
     QAbstractButton* isButton(TransferBaseDelegateWidget* row, const QPoint& pos);
 
     TransfersSortFilterProxyBaseModel* mProxyModel;
     TransfersModel* mSourceModel;
     mutable QVector<TransferBaseDelegateWidget*> mTransferItems;
+    std::unique_ptr<TransferManagerRowPainter> mRowPainter;
+    mutable QPointer<TransferManagerDelegateWidget> mLayoutTemplate;
     QAbstractItemView* mView;
 };
 
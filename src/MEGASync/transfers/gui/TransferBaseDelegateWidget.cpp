@@ -178,15 +178,20 @@ int TransferBaseDelegateWidget::getNameAvailableSize(QWidget *nameContainer, QWi
 
 QString TransferBaseDelegateWidget::getErrorText()
 {
-    return (getData() && getData()->mFailedTransfer && getData()->mFailedTransfer->isForeignOverquota())
+    return getErrorText(getData());
+}
+
+QString TransferBaseDelegateWidget::getErrorText(const QExplicitlySharedDataPointer<TransferData>& data)
+{
+    return (data && data->isForeignOverquota())
                 ? QCoreApplication::translate("MegaError", "Destination storage is full.")
-                : getErrorInContext();
+                : getErrorInContext(data);
 }
 
-QString TransferBaseDelegateWidget::getErrorInContext()
+QString TransferBaseDelegateWidget::getErrorInContext(const QExplicitlySharedDataPointer<TransferData>& data)
 {
     auto context (mega::MegaError::ErrorContexts::API_EC_DEFAULT);
-    switch (getData()->mType)
+    switch (data->mType)
     {
         case TransferData::TRANSFER_DOWNLOAD:
         case TransferData::TRANSFER_LTCPDOWNLOAD:
@@ -204,7 +209,7 @@ QString TransferBaseDelegateWidget::getErrorInContext()
     }
 
     // SNC-4190/CON-556
-    const char* errorStr = mega::MegaError::getErrorString(getData()->mErrorCode, context);
+    const char* errorStr = mega::MegaError::getErrorString(data->mErrorCode, context);
     const char* BUSINESS_ACCOUNT_EXPIRED_STR = "Business account has expired";
 
     if (strcmp(errorStr, BUSINESS_ACCOUNT_EXPIRED_STR) == 0)
@@ -55,6 +55,9 @@ public:
 
     virtual void render(const QStyleOptionViewItem &, QPainter *painter, const QRegion &sourceRegion);
 
+    static QString getState(TRANSFER_STATES state);
+    static QString getErrorText(const QExplicitlySharedDataPointer<TransferData>& data);
+
 signals:
     void retryTransfer();
 
@@ -71,8 +74,6 @@ protected:
 
     bool event(QEvent* event) override;
 
-    QString getState(TRANSFER_STATES state);
-
     int getNameAvailableSize(QWidget* nameContainer, QWidget* syncLabel, QSpacerItem* spacer);
     QString getErrorText();
 
@@ -88,7 +89,7 @@ private:
     QHash<QWidget*, QString> mLastActionTransferIconName;
     TransferData::TransferState mPreviousState;
 
-    QString getErrorInContext();
+    static QString getErrorInContext(const QExplicitlySharedDataPointer<TransferData>& data);
 };
 
 #endif // TRANSFERBASEDELEGATEWIDGET
@@ -2,6 +2,7 @@
 
 #include "MegaApplication.h"
 #include "TransferRemainingTime.h"
+#include "TransferStringPool.h"
 #include "Utilities.h"
 
 using namespace mega;
@@ -58,17 +59,70 @@ const TransferData::TransferStates TransferData::ACTIVE_STATES_MASK = TransferDa
             TransferData::TransferState::TRANSFER_ACTIVE |
             TransferData::TransferState::TRANSFER_COMPLETING);
 
-void TransferData::update(mega::MegaTransfer* transfer)
+TransferRetryInfo::TransferRetryInfo(mega::MegaTransfer* transfer):
+    mErrorCode(MegaError::API_OK),
+    mIsFolderTransfer(transfer->isFolderTransfer()),
+    mIsForeignOverquota(transfer->isForeignOverquota()),
+    mParentPath(TransferStringPool::instance().intern(QString::fromUtf8(transfer->getParentPath()))),
+    mAppData(transfer->getAppData()),
+    mPublicNode(transfer->getPublicMegaNode())
+{
+    auto error(transfer->getLastErrorExtended());
+    if(error)
+    {
+        mErrorCode = error->getErrorCode();
+    }
+}
+
+const char* TransferRetryInfo::getAppData() const
+{
+    //The SDK uses nullptr when the transfer has no app data
+    return mAppData.isNull() ? nullptr : mAppData.constData();
+}
+
+qint64 TransferRetryInfo::bytes() const
+{
+    qint64 result(sizeof(TransferRetryInfo));
+    if(!mAppData.isNull())
+    {
+        result += static_cast<qint64>(sizeof(QArrayData)) + mAppData.capacity() + 1;
+    }
+
+    return result;
+}
+
+void TransferData::update(mega::MegaTransfer* transfer, bool poolStrings)
 {
     auto megaApi = MegaSyncApp->getMegaApi();
     if(transfer && megaApi)
     {   
         mTag = transfer->getTag();
 
-        mPath = QString::fromUtf8(transfer->getPath());
         mFolderTransferTag = transfer->getFolderTransferTag();
 
         mFilename = QString::fromUtf8(transfer->getFileName());
+
+        auto localPath(QString::fromUtf8(transfer->getPath()));
+        auto nameIndex(std::max(localPath.lastIndexOf(QLatin1Char('/')),
+                                localPath.lastIndexOf(QLatin1Char('\\'))) + 1);
+        mPathFolder = localPath.left(nameIndex);
+
+        if(poolStrings)
+        {
+            auto& stringPool(TransferStringPool::instance());
+            mFilename = stringPool.intern(mFilename);
+            mPathFolder = stringPool.intern(mPathFolder);
+        }
+
+        if(localPath.midRef(nameIndex) == mFilename)
+        {
+            mPathName = mFilename;
+        }
+        else
+        {
+            mPathName = localPath.mid(nameIndex);
+        }
+
         mType = static_cast<TransferData::TransferType>(1 << transfer->getType());
         if (transfer->isSyncTransfer())
         {
@@ -85,7 +139,7 @@ void TransferData::update(mega::MegaTransfer* transfer)
         mErrorCode = MegaError::API_OK;
         mErrorValue = 0LL;
         mTemporaryError = false;
-        mFailedTransfer = nullptr;
+        mRetryInfo.reset();
         mTransferredBytes = transfer->getTransferredBytes();
         mTotalSize = transfer->getTotalBytes();
         mIgnorePauseQueueState = false;
@@ -133,6 +187,29 @@ void TransferData::update(mega::MegaTransfer* transfer)
     }
 }
 
+void TransferData::sharePooledStrings(const TransferData* previous)
+{
+    if(!previous)
+    {
+        return;
+    }
+
+    if(mFilename == previous->mFilename)
+    {
+        auto pathNameIsFilename(mPathName.isSharedWith(mFilename));
+        mFilename = previous->mFilename;
+        if(pathNameIsFilename)
+        {
+            mPathName = mFilename;
+        }
+    }
+
+    if(mPathFolder == previous->mPathFolder)
+    {
+        mPathFolder = previous->mPathFolder;
+    }
+}
+
 bool TransferData::hasChanged(QExplicitlySharedDataPointer<TransferData> data)
 {
     bool result = true;
@@ -151,7 +228,7 @@ bool TransferData::hasChanged(QExplicitlySharedDataPointer<TransferData> data)
 
 void TransferData::removeFailedTransfer()
 {
-    mFailedTransfer.reset();
+    mRetryInfo.reset();
 }
 
 void TransferData::setPauseResume(bool isPaused)
@@ -230,12 +307,12 @@ void TransferData::setPreviousState(const TransferState &state)
 
 TransferData::TransferState TransferData::getState() const
 {
-    return mState;
+    return static_cast<TransferState>(mState);
 }
 
 TransferData::TransferState TransferData::getPreviousState() const
 {
-    return mPreviousState;
+    return static_cast<TransferState>(mPreviousState);
 }
 
 void TransferData::resetStateHasChanged()
@@ -281,8 +358,8 @@ std::unique_ptr<MegaNode> TransferData::getNode() const
 
         node.reset(MegaSyncApp->getMegaApi()->getNodeByHandle(mNodeHandle));
 
-        if(!node)
-            node.reset(mFailedTransfer->getPublicMegaNode());
+        if(!node && mRetryInfo && mRetryInfo->mPublicNode)
+            node.reset(mRetryInfo->mPublicNode->copy());
 
         return node;
     }
@@ -290,7 +367,7 @@ std::unique_ptr<MegaNode> TransferData::getNode() const
 
 QString TransferData::path() const
 {
-    QString localPath = mPath;
+    QString localPath = getRawPath();
     #ifdef WIN32
     if (localPath.startsWith(QString::fromLatin1("\\\\?\\")))
     {
@@ -300,6 +377,11 @@ QString TransferData::path() const
     return localPath;
 }
 
+QString TransferData::getRawPath() const
+{
+    return mPathFolder + mPathName;
+}
+
 bool TransferData::isPublicNode() const
 {
     auto result(false);
@@ -384,55 +466,52 @@ bool TransferData::isCompleting() const
 
 bool TransferData::isFailed() const
 {
-    return mState & TRANSFER_FAILED && mFailedTransfer;
+    return mState & TRANSFER_FAILED && mRetryInfo;
 }
 
 bool TransferData::canBeRetried() const
 {
-    if (!mFailedTransfer || !isFailed())
+    if (!mRetryInfo || !isFailed())
     {
         return false;
     }
 
-    return canBeRetried(mFailedTransfer.get());
-}
-
-bool TransferData::canBeRetried(mega::MegaTransfer* transfer)
-{
     auto result(false);
+    auto errorCode(mRetryInfo->mErrorCode);
 
-    if (transfer->isSyncTransfer())
+    if (isSyncTransfer())
     {
-        if (transfer->getType() == mega::MegaTransfer::TYPE_DOWNLOAD)
+        if (mType & TRANSFER_DOWNLOAD)
         {
-            auto error = transfer->getLastErrorExtended();
-
             // If it is not any of these errors, it can be retried
-            result = error->getErrorCode() != mega::MegaError::API_EKEY &&
-                     error->getErrorCode() != mega::MegaError::API_EBLOCKED &&
-                     error->getErrorCode() != mega::MegaError::API_EWRITE;
+            result = errorCode != mega::MegaError::API_EKEY &&
+                     errorCode != mega::MegaError::API_EBLOCKED &&
+                     errorCode != mega::MegaError::API_EWRITE;
         }
     }
     else
     {
-        if (transfer->getType() == mega::MegaTransfer::TYPE_UPLOAD)
+        if (isUpload())
         {
             result = true;
         }
         else
         {
-            auto error = transfer->getLastErrorExtended();
-
             // If it is not any of these errors, it can be retried
-            result = error->getErrorCode() != mega::MegaError::API_EARGS &&
-                     error->getErrorCode() != mega::MegaError::API_ENOENT &&
-                     error->getErrorCode() != mega::MegaError::API_EREAD;
+            result = errorCode != mega::MegaError::API_EARGS &&
+                     errorCode != mega::MegaError::API_ENOENT &&
+                     errorCode != mega::MegaError::API_EREAD;
         }
     }
 
     return result;
 }
 
+bool TransferData::isForeignOverquota() const
+{
+    return mRetryInfo && mRetryInfo->mIsForeignOverquota;
+}
+
 bool TransferData::isCancelled() const
 {
     return mState & TRANSFER_CANCELLED;
@@ -452,3 +531,21 @@ bool TransferData::wasFinished() const
 {
     return mPreviousState & FINISHED_STATES_MASK;
 }
+
+qint64 TransferData::bytes() const
+{
+    qint64 result(sizeof(TransferData));
+
+    //The name shares the buffer with mFilename (pooled) unless the SDK used another local name
+    if(!mPathName.isSharedWith(mFilename))
+    {
+        result += TransferStringPool::stringBytes(mPathName);
+    }
+
+    if(mRetryInfo)
+    {
+        result += mRetryInfo->bytes();
+    }
+
+    return result;
+}
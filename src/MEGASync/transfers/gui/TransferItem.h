@@ -25,6 +25,26 @@ static const QColor DOWNLOAD_TRANSFER_COLOR = QColor("#31B500");
 typedef int TransferTag;
 Q_DECLARE_METATYPE(TransferTag)
 
+/// Responsability: keeps what a failed transfer needs to be shown and retried, instead of a full
+/// copy of the SDK MegaTransfer (which duplicates paths, names and SDK state for every failed
+/// file). The rest of the data (type, tags, handles, path and name) is already in TransferData.
+struct TransferRetryInfo
+{
+    explicit TransferRetryInfo(mega::MegaTransfer* transfer);
+
+    const char* getAppData() const;
+    qint64 bytes() const;
+
+    int mErrorCode;
+    bool mIsFolderTransfer;
+    bool mIsForeignOverquota;
+    // Interned in TransferStringPool
+    QString mParentPath;
+    QByteArray mAppData;
+    // Only set for downloads from public links, as the node is not in the account
+    std::shared_ptr<mega::MegaNode> mPublicNode;
+};
+
 class TransferData : public QSharedData
 {
 public:
@@ -61,29 +81,33 @@ public:
 
     static const TransferTypes TYPE_MASK;
 
-    TransferData(mega::MegaTransfer* transfer = nullptr)
+    TransferData(mega::MegaTransfer* transfer = nullptr, bool poolStrings = false)
     {
         qRegisterMetaType<TransferTag>("TransferTag");
-        update(transfer);
+        update(transfer, poolStrings);
     }
 
     ~TransferData(){}
 
     TransferData(TransferData const* dr) :
         mType(dr->mType), mErrorCode(dr->mErrorCode), mTag(dr->mTag), mFolderTransferTag(dr->mFolderTransferTag),
-        mErrorValue(dr->mErrorValue), mTemporaryError(dr->mTemporaryError),
+        mFileType(dr->mFileType), mTemporaryError(dr->mTemporaryError),
+        mErrorValue(dr->mErrorValue),
         mRemainingTime(dr->mRemainingTime),
         mTotalSize(dr->mTotalSize), mPriority(dr->mPriority), mSpeed(dr->mSpeed),
         mMeanSpeed(dr->mMeanSpeed),
         mTransferredBytes(dr->mTransferredBytes),
         mNotificationNumber(dr->mNotificationNumber),
-        mFileType(dr->mFileType),
-        mParentHandle (dr->mParentHandle), mNodeHandle (dr->mNodeHandle), mFailedTransfer(dr->mFailedTransfer),
-        mFilename(dr->mFilename), mNodeAccess(mega::MegaShare::ACCESS_UNKNOWN),
-        mPath(dr->mPath), mFinishedTime(dr->mFinishedTime),mState(dr->mState), mIgnorePauseQueueState(dr->mIgnorePauseQueueState)
+        mParentHandle (dr->mParentHandle), mNodeHandle (dr->mNodeHandle), mRetryInfo(dr->mRetryInfo),
+        mFilename(dr->mFilename),
+        mPathFolder(dr->mPathFolder), mPathName(dr->mPathName), mFinishedTime(dr->mFinishedTime),
+        mState(dr->mState), mPreviousState(dr->mPreviousState), mIgnorePauseQueueState(dr->mIgnorePauseQueueState)
     {}
 
-    void update(mega::MegaTransfer* transfer);
+    //The name and folder are only interned in the pool when poolStrings is set (on start), as the
+    //pool is locked. The data of later events takes them from the previous one (sharePooledStrings)
+    void update(mega::MegaTransfer* transfer, bool poolStrings = false);
+    void sharePooledStrings(const TransferData* previous);
     bool hasChanged(QExplicitlySharedDataPointer<TransferData> data);
     void removeFailedTransfer();
 
@@ -93,12 +117,16 @@ public:
 
     static TransferData::TransferState convertState(int state);
 
+    //Members are sorted by size, so the struct has no padding holes. The 32 bits fields, which
+    //are read by the sort/filter and the counters, are kept together in the first cache line.
     TransferTypes                       mType;
     int                                 mErrorCode = 0;
     int                                 mTag = 0;
     int                                 mFolderTransferTag = 0;
-    long long                           mErrorValue = 0;
+    Utilities::FileType                 mFileType = Utilities::FileType::TYPE_OTHER;
     bool                                mTemporaryError = false;
+    bool                                mIsTempTransfer = false;
+    long long                           mErrorValue = 0;
     int64_t                             mRemainingTime = 0;
     long long                           mTotalSize = 0;
     unsigned long long                  mPriority = 0;
@@ -106,13 +134,12 @@ public:
     unsigned long long                  mMeanSpeed = 0;
     long long                           mTransferredBytes = 0;
     long long                           mNotificationNumber = 0;
-    Utilities::FileType                 mFileType = Utilities::FileType::TYPE_OTHER;
     mega::MegaHandle                    mParentHandle = 0;
     mega::MegaHandle                    mNodeHandle = 0;
-    std::shared_ptr<mega::MegaTransfer> mFailedTransfer;
+    //Only set for failed transfers
+    std::shared_ptr<const TransferRetryInfo> mRetryInfo;
+    //Interned in TransferStringPool
     QString                             mFilename;
-    int                                 mNodeAccess = 0;
-    bool                                mIsTempTransfer = false;
 
     void setState(const TransferState& state);
     void setPreviousState(const TransferState& state);
@@ -122,6 +149,8 @@ public:
     bool stateHasChanged() const;
 
     QString path() const;
+    //The path as received from the SDK (path() removes the Windows long path prefix)
+    QString getRawPath() const;
     bool isPublicNode() const;
     bool isCancelable() const;
     bool isFinished() const;
@@ -140,7 +169,7 @@ public:
     bool isCompleting() const;
     bool isFailed() const;
     bool canBeRetried() const;
-    static bool canBeRetried(mega::MegaTransfer* transfer);
+    bool isForeignOverquota() const;
     bool isCancelled() const;
     bool isTempTransfer() const;
     qint64 getSecondsSinceFinished() const;
@@ -148,11 +177,18 @@ public:
     QString getFullFormattedFinishedTime() const;
     std::unique_ptr<mega::MegaNode> getNode() const;
 
+    //Heap and struct memory used by this transfer, the pooled strings are not included
+    qint64 bytes() const;
+
 private:
-    QString         mPath;
-    QDateTime mFinishedTime;
-    TransferState   mState = TransferState::TRANSFER_NONE;
-    TransferState   mPreviousState = TransferState::TRANSFER_NONE;
+    //The path is split in the folder (interned) and the name, which is usually mFilename and
+    //then shares its buffer
+    QString         mPathFolder;
+    QString         mPathName;
+    QDateTime       mFinishedTime;
+    //TransferState values fit in 16 bits
+    quint16         mState = TransferState::TRANSFER_NONE;
+    quint16         mPreviousState = TransferState::TRANSFER_NONE;
     bool            mIgnorePauseQueueState = false;
 
 };
@@ -11,8 +11,8 @@
 
 #include <QMouseEvent>
 #include <QPainterPath>
+#include <QPixmap>
 
-constexpr uint PB_PRECISION = 1000;
 const char* ACTION_BUTTONS_VISIBILITY = "action_visible";
 const QString HOVER_TOKEN = QStringLiteral("surface-1");
 const QString SELECTED_TOKEN = QStringLiteral("surface-2");
@@ -24,7 +24,7 @@ TransferManagerDelegateWidget::TransferManagerDelegateWidget(QWidget *parent) :
     mUi (new Ui::TransferManagerDelegateWidget)
 {
     mUi->setupUi(this);
-    mUi->pbTransfer->setMaximum(PB_PRECISION);
+    mUi->pbTransfer->setMaximum(TransferManagerRowState::PB_PRECISION);
 
     //For elided texts
 
@@ -51,259 +51,83 @@ TransferManagerDelegateWidget::~TransferManagerDelegateWidget()
 
 void TransferManagerDelegateWidget::updateTransferState()
 {
-    QIcon icon;
-    QString speedString;
-    QString pauseResumeTooltip;
-    QString cancelClearTooltip;
-    bool showTPauseResume(true);
-    bool showTCancelClear(true);
-    QString timeString;
-    QString timeTooltip;
-    QString statusString;
-
-    auto state = getData()->getState();
+    auto rowState(TransferManagerRowState::create(getData(), isFailedTab()));
 
-    // Set values according to transfer state
-    switch (state)
+    // Every status has its own page
+    switch (rowState.status)
     {
-        case TransferData::TRANSFER_ACTIVE:
+        case TransferManagerRowState::Status::ACTIVE:
         {
-            if (getData()->mTransferredBytes == 0)
-            {
-                statusString = getState(TRANSFER_STATES::STATE_STARTING);
-            }
-            else
-            {
-                switch (getData()->mType)
-                {
-                    case TransferData::TRANSFER_DOWNLOAD:
-                    case TransferData::TRANSFER_LTCPDOWNLOAD:
-                    {
-                        statusString = getState(TRANSFER_STATES::STATE_DOWNLOADING);
-                        break;
-                    }
-                    case TransferData::TRANSFER_UPLOAD:
-                    {
-                        statusString = getState(TRANSFER_STATES::STATE_UPLOADING);
-                        break;
-                    }
-                    default:
-                    {
-                        statusString = getState(TRANSFER_STATES::STATE_SYNCING);
-                        break;
-                    }
-                }
-            }
-
-            if(stateHasChanged())
-            {
-                mPauseResumeTransferDefaultIconName =
-                    QLatin1String(":/pause_small_thin_outline_button_outline");
-                pauseResumeTooltip = MegaTransferView::pauseActionText(1); // Use singular form
-                cancelClearTooltip = MegaTransferView::cancelActionText(1); // Use singular form
-                mUi->wProgressBar->setVisible(true);
-                mUi->sStatus->setCurrentWidget(mUi->pActive);
-            }
-
-            timeString = getData()->mSpeed == 0 ?
-                             timeString
-                           : Utilities::getTimeString(getData()->mRemainingTime);
-
-            if(getData()->mTotalSize == getData()->mTransferredBytes)
-            {
-                speedString = QString::fromUtf8("…");
-            }
-            else
-            {
-                speedString = Utilities::getSizeString(getData()->mSpeed)
-                        + QLatin1String("/s");
-            }
-
+            mUi->sStatus->setCurrentWidget(mUi->pActive);
             break;
         }
-        case TransferData::TRANSFER_PAUSED:
+        case TransferManagerRowState::Status::PAUSED:
         {
-            if(stateHasChanged())
-            {
-                mPauseResumeTransferDefaultIconName =
-                    QLatin1String(":/play_small_thin_outline_button_outline");
-                pauseResumeTooltip = MegaTransferView::resumeActionText(1); // Use singular form
-                cancelClearTooltip = MegaTransferView::cancelActionText(1); // Use singular form
-                mUi->wProgressBar->setVisible(true);
-
-                if (getData()->mTransferredBytes != 0)
-                {
-                    mUi->lItemPaused->setText(getState(TRANSFER_STATES::STATE_PAUSED));
-                    mUi->lItemPaused->setToolTip(getState(TRANSFER_STATES::STATE_PAUSED));
-                    mUi->sStatus->setCurrentWidget(mUi->pPaused);
-                }
-                else
-                {
-                    mUi->lItemPausedQueued_1->setText(getState(TRANSFER_STATES::STATE_PAUSED));
-                    mUi->lItemPausedQueued_2->setText(
-                        getState(TRANSFER_STATES::STATE_INQUEUE_PARENTHESIS));
-                    mUi->lItemPausedQueued_1->setToolTip(getState(TRANSFER_STATES::STATE_PAUSED));
-                    mUi->lItemPausedQueued_2->setToolTip(
-                        getState(TRANSFER_STATES::STATE_INQUEUE_PARENTHESIS));
-                    mUi->sStatus->setCurrentWidget(mUi->pPausedQueued);
-                }
-            }
-
-            speedString = QString::fromUtf8("…");
-
+            mUi->lItemPaused->setText(rowState.statusText);
+            mUi->lItemPaused->setToolTip(rowState.statusText);
+            mUi->sStatus->setCurrentWidget(mUi->pPaused);
             break;
         }
-        case TransferData::TRANSFER_QUEUED:
+        case TransferManagerRowState::Status::PAUSED_QUEUED:
         {
-            if(stateHasChanged())
-            {
-                mPauseResumeTransferDefaultIconName =
-                    QLatin1String(":/pause_small_thin_outline_button_outline");
-                pauseResumeTooltip = MegaTransferView::pauseActionText(1); // Use singular form
-                cancelClearTooltip = MegaTransferView::cancelActionText(1); // Use singular form
-                mUi->wProgressBar->setVisible(true);
-                mUi->sStatus->setCurrentWidget(mUi->pQueued);
-
-                if (getData()->mErrorCode == MegaError::API_EOVERQUOTA)
-                {
-                    QString retryMsg(getData()->mErrorValue ?
-                                         getState(TRANSFER_STATES::STATE_OUT_OF_TRANSFER_QUOTA) :
-                                         getState(TRANSFER_STATES::STATE_OUT_OF_STORAGE_SPACE));
-                    mUi->lRetryMsg->setText(retryMsg);
-                    mUi->lRetryMsg->setToolTip(retryMsg);
-                    mUi->sStatus->setCurrentWidget(mUi->pRetry);
-                }
-                else
-                {
-                    mUi->lItemQueued->setText(getState(TRANSFER_STATES::STATE_INQUEUE));
-                    mUi->lItemQueued->setToolTip(getState(TRANSFER_STATES::STATE_INQUEUE));
-                    mUi->lRetryMsg->setText(getState(TRANSFER_STATES::STATE_RETRY));
-                    mUi->lRetryMsg->setToolTip(getState(TRANSFER_STATES::STATE_RETRY));
-                }
-            }
-
-            break;
-        }
-        case TransferData::TRANSFER_CANCELLED:
-        {
-            //Cancelled transfers are immediately removed from the model
-            break;
-        }
-        case TransferData::TRANSFER_COMPLETING:
-        {
-            statusString = getState(TRANSFER_STATES::STATE_COMPLETING);
-
-            if(stateHasChanged())
-            {
-                showTPauseResume = false;
-                showTCancelClear = false;
-                mUi->wProgressBar->setVisible(true);
-                mUi->sStatus->setCurrentWidget(mUi->pActive);
-                mPauseResumeTransferDefaultIconName.clear();
-            }
-
-            speedString = QString::fromUtf8("…");
-
+            mUi->lItemPausedQueued_1->setText(rowState.statusText);
+            mUi->lItemPausedQueued_1->setToolTip(rowState.statusText);
+            mUi->lItemPausedQueued_2->setText(rowState.secondaryStatusText);
+            mUi->lItemPausedQueued_2->setToolTip(rowState.secondaryStatusText);
+            mUi->sStatus->setCurrentWidget(mUi->pPausedQueued);
             break;
         }
-        case TransferData::TRANSFER_FAILED:
+        case TransferManagerRowState::Status::QUEUED:
         {
-            if(stateHasChanged())
-            {
-                mPauseResumeTransferDefaultIconName.clear();
-                mUi->sStatus->setCurrentWidget(mUi->pFailed);
-                mUi->tItemRetry->setVisible(getData()->canBeRetried());
-                mUi->tItemRetry->setText(getState(TRANSFER_STATES::STATE_RETRY));
-                mUi->tItemRetry->setToolTip(getState(TRANSFER_STATES::STATE_RETRY));
-                mUi->wProgressBar->setVisible(false);
-                cancelClearTooltip = MegaTransferView::cancelActionText(1); //Use singular form
-                mUi->lItemFailed->setText(
-                    (mColumnManager &&
-                     mColumnManager->getCurrentTab() == TransfersWidget::TM_TAB::FAILED_TAB) ?
-                        getErrorText() :
-                        getState(TRANSFER_STATES::STATE_FAILED));
-                mUi->lItemFailed->setToolTip(getErrorText());
-                showTPauseResume = false;
-            }
-
-            const auto dateTime = getData()->getFinishedDateTime();
-            timeString = MegaSyncApp->getFormattedDateByCurrentLanguage(dateTime, QLocale::FormatType::ShortFormat);
-
-            timeTooltip = getData()->getFullFormattedFinishedTime();
-            speedString = QString::fromUtf8("…");
-
+            mUi->lItemQueued->setText(rowState.statusText);
+            mUi->lItemQueued->setToolTip(rowState.statusText);
+            mUi->sStatus->setCurrentWidget(mUi->pQueued);
             break;
         }
-        case TransferData::TRANSFER_RETRYING:
+        case TransferManagerRowState::Status::RETRY_MESSAGE:
         {
-            statusString = getState(TRANSFER_STATES::STATE_RETRYING);
-
-            if(stateHasChanged())
-            {
-                mPauseResumeTransferDefaultIconName =
-                    QLatin1String(":/pause_small_thin_outline_button_outline");
-                pauseResumeTooltip = MegaTransferView::pauseActionText(1); // Use singular form
-                cancelClearTooltip = MegaTransferView::cancelActionText(1); // Use singular form
-                mUi->lItemStatus->setToolTip(getErrorText());
-                mUi->sStatus->setCurrentWidget(mUi->pActive);
-            }
-
-            if(getData()->mErrorCode == MegaError::API_EOVERQUOTA)
-            {
-                QString retryMsg (getData()->mErrorValue ? getState(TRANSFER_STATES::STATE_OUT_OF_TRANSFER_QUOTA)
-                                                    : getState(TRANSFER_STATES::STATE_OUT_OF_STORAGE_SPACE));
-                mUi->lRetryMsg->setText(retryMsg);
-                mUi->lRetryMsg->setToolTip(retryMsg);
-                mUi->sStatus->setCurrentWidget(mUi->pRetry);
-            }
+            mUi->lRetryMsg->setText(rowState.statusText);
+            mUi->lRetryMsg->setToolTip(rowState.statusText);
+            mUi->sStatus->setCurrentWidget(mUi->pRetry);
             break;
         }
-        case TransferData::TRANSFER_COMPLETED:
+        case TransferManagerRowState::Status::FAILED:
         {
-            statusString = getState(TRANSFER_STATES::STATE_COMPLETED);
-
-            if(stateHasChanged())
-            {
-                cancelClearTooltip = MegaTransferView::clearActionText(1); //Use singular form
-                showTPauseResume = false;
-                mUi->wProgressBar->setVisible(false);
-                mPauseResumeTransferDefaultIconName.clear();
-
-                mUi->sStatus->setCurrentWidget(mUi->pActive);
-            }
-            speedString = Utilities::getSizeString(getData()->mSpeed) + QLatin1String("/s");
-            auto dateTime = getData()->getFinishedDateTime();
-            timeString = MegaSyncApp->getFormattedDateByCurrentLanguage(dateTime, QLocale::FormatType::ShortFormat);
-
-            timeTooltip = getData()->getFullFormattedFinishedTime();
+            mUi->lItemFailed->setText(rowState.statusText);
+            mUi->lItemFailed->setToolTip(getErrorText());
+            mUi->sStatus->setCurrentWidget(mUi->pFailed);
             break;
         }
-        default:
-        break;
     }
 
     if(stateHasChanged())
     {
+        mUi->wProgressBar->setVisible(rowState.showProgressBar);
+        mUi->tItemRetry->setVisible(rowState.showRetry);
+        mUi->tItemRetry->setText(getState(TRANSFER_STATES::STATE_RETRY));
+        mUi->tItemRetry->setToolTip(getState(TRANSFER_STATES::STATE_RETRY));
+
         // Pause/Resume button
+        mPauseResumeTransferDefaultIconName = rowState.pauseResumeIcon;
+        bool showTPauseResume(!rowState.pauseResumeIcon.isEmpty());
         if (showTPauseResume)
         {
-            icon = Utilities::getCachedPixmap(mPauseResumeTransferDefaultIconName);
-            mUi->tPauseResumeTransfer->setIcon(icon);
-            mUi->tPauseResumeTransfer->setToolTip(pauseResumeTooltip);
+            mUi->tPauseResumeTransfer->setIcon(
+                Utilities::getCachedPixmap(mPauseResumeTransferDefaultIconName));
+            mUi->tPauseResumeTransfer->setToolTip(
+                rowState.isPaused ? MegaTransferView::resumeActionText(1) : // Use singular form
+                                    MegaTransferView::pauseActionText(1));
         }
         mUi->tPauseResumeTransfer->setProperty(ACTION_BUTTONS_VISIBILITY, showTPauseResume);
 
         // Cancel/Clear Button
-        if ((getData()->mType & TransferData::TRANSFER_SYNC)
-                && !(getData()->getState() & TransferData::TRANSFER_COMPLETED))
+        if (rowState.showCancelClear)
         {
-            showTCancelClear = false;
+            mUi->tCancelClearTransfer->setToolTip(
+                rowState.isClear ? MegaTransferView::clearActionText(1) : // Use singular form
+                                   MegaTransferView::cancelActionText(1));
         }
-        if (showTCancelClear)
-        {
-            mUi->tCancelClearTransfer->setToolTip(cancelClearTooltip);
-        }
-        mUi->tCancelClearTransfer->setProperty(ACTION_BUTTONS_VISIBILITY, showTCancelClear);
+        mUi->tCancelClearTransfer->setProperty(ACTION_BUTTONS_VISIBILITY, rowState.showCancelClear);
 
         mUi->lDone->setVisible(!(getData()->getState() & TransferData::FINISHED_STATES_MASK));
 
@@ -312,30 +136,31 @@ void TransferManagerDelegateWidget::updateTransferState()
     }
 
     //Status
+    auto statusString(rowState.status == TransferManagerRowState::Status::ACTIVE ?
+                          rowState.statusText :
+                          QString());
     mUi->lItemStatus->setText(statusString);
     mUi->lItemStatus->setToolTip(statusString);
 
     // Done label
-    auto transferedB (getData()->mTransferredBytes);
-    auto totalB (getData()->mTotalSize);
-
-    auto sizes = Utilities::getProgressSizes(transferedB, totalB);
+    auto sizes = Utilities::getProgressSizes(getData()->mTransferredBytes, getData()->mTotalSize);
 
     mUi->lDone->setText(sizes.transferredBytes + QLatin1String(" ") + QLatin1String("/"));
     mUi->lTotal->setText(QLatin1String(" ") + sizes.totalBytes + QLatin1String(" ") + sizes.units);
 
     // Progress bar
-    int permil = getData()->getState() & (TransferData::TRANSFER_COMPLETED | TransferData::TRANSFER_COMPLETING) ?
-                     PB_PRECISION
-                   : totalB > 0 ? Utilities::partPer(transferedB, totalB, PB_PRECISION)
-                                : 0;
-    mUi->pbTransfer->setValue(permil);
+    mUi->pbTransfer->setValue(rowState.permil);
 
     // Speed
-    mUi->bItemSpeed->setText(speedString);
+    mUi->bItemSpeed->setText(rowState.speed);
 
     // Remaining or finished time
-    mUi->lItemTime->setText(timeString);
+    QString timeTooltip;
+    if (getData()->getState() & (TransferData::TRANSFER_FAILED | TransferData::TRANSFER_COMPLETED))
+    {
+        timeTooltip = getData()->getFullFormattedFinishedTime();
+    }
+    mUi->lItemTime->setText(rowState.time);
     mUi->lItemTime->setToolTip(timeTooltip);
 
     mUi->bItemSpeed->setVisible(mColumnManager->getCurrentTab() !=
@@ -405,6 +230,90 @@ void TransferManagerDelegateWidget::setColumnManager(
     mColumnManager->addColumnsWidget(this, info);
 }
 
+uint TransferManagerDelegateWidget::getPaintLayoutKey(int width) const
+{
+    auto key(qHash(width) ^ qHash(static_cast<int>(ThemeManager::instance()->currentColorScheme())));
+    key = key * 31 + (isFailedTab() ? 1 : 0);
+
+    const QWidget* columns[] = {mUi->wName, mUi->wSize, mUi->cSpeedItem, mUi->sStatus,
+                                mUi->lItemTime, mUi->wClearCancel, mUi->wPauseResume};
+    for (auto column : columns)
+    {
+        key = key * 31 + qHash(column->minimumWidth());
+        key = key * 31 + (column->isHidden() ? 1 : 0);
+    }
+
+    return key;
+}
+
+TransferManagerRowPainter::Layout TransferManagerDelegateWidget::getPaintLayout(const QSize& size)
+{
+    if (this->size() != size)
+    {
+        resize(size);
+    }
+
+    // The widget is never shown, and the layouts of hidden widgets are only applied when they are
+    // rendered: render it once so the geometry of every child is up to date
+    QPixmap scratch(size);
+    scratch.fill(Qt::transparent);
+    QWidget::render(&scratch);
+
+    auto rectOf = [this](QWidget* column, QWidget* element)
+    {
+        return column->isVisibleTo(this) ? QRect(element->mapTo(this, QPoint(0, 0)), element->size())
+                                         : QRect();
+    };
+
+    TransferManagerRowPainter::Layout layout;
+    layout.key = getPaintLayoutKey(size.width());
+    layout.isFailedTab = isFailedTab();
+
+    layout.separator = rectOf(mUi->itemSepLine, mUi->itemSepLine);
+    layout.fileIcon = rectOf(mUi->tFileType, mUi->tFileType);
+
+    layout.name = rectOf(mUi->wName, mUi->lTransferName);
+    if (layout.name.isValid())
+    {
+        layout.name.setWidth(getNameAvailableSize(mUi->wTransferName, mUi->lSyncIcon, mUi->nameSpacer));
+    }
+    layout.syncIconSize = mUi->lSyncIcon->size();
+    layout.nameSpacing = mUi->wTransferName->layout()->spacing();
+    layout.progressBar = rectOf(mUi->wName, mUi->pbTransfer);
+
+    layout.size = rectOf(mUi->wSize, mUi->lDone).united(rectOf(mUi->wSize, mUi->lTotal));
+    layout.speed = rectOf(mUi->cSpeedItem, mUi->bItemSpeed);
+    layout.speedIconSize = mUi->bItemSpeed->iconSize();
+    layout.status = rectOf(mUi->sStatus, mUi->sStatus);
+    layout.time = rectOf(mUi->lItemTime, mUi->lItemTime);
+    layout.pauseResume = rectOf(mUi->wPauseResume, mUi->wPauseResume);
+    layout.cancelClear = rectOf(mUi->wClearCancel, mUi->wClearCancel);
+    layout.actionIconSize = mUi->tPauseResumeTransfer->iconSize();
+
+    layout.nameFont = mUi->lTransferName->font();
+    layout.textFont = mUi->lTotal->font();
+    layout.speedFont = mUi->bItemSpeed->font();
+    layout.timeFont = mUi->lItemTime->font();
+    layout.timeAlignment = mUi->lItemTime->alignment();
+
+    // Stylesheet colors are already in the palettes, as the widget is polished
+    layout.nameColor = mUi->lTransferName->palette().color(QPalette::WindowText);
+    layout.textColor = mUi->lTotal->palette().color(QPalette::WindowText);
+    layout.speedColor = mUi->bItemSpeed->palette().color(QPalette::ButtonText);
+    layout.timeColor = mUi->lItemTime->palette().color(QPalette::WindowText);
+    layout.successColor = mUi->lItemStatus->palette().color(QPalette::WindowText);
+    layout.warningColor = mUi->lItemPaused->palette().color(QPalette::WindowText);
+    layout.errorColor = mUi->lItemFailed->palette().color(QPalette::WindowText);
+    layout.retryMessageColor = mUi->lRetryMsg->palette().color(QPalette::WindowText);
+
+    return layout;
+}
+
+bool TransferManagerDelegateWidget::isFailedTab() const
+{
+    return mColumnManager && mColumnManager->getCurrentTab() == TransfersWidget::TM_TAB::FAILED_TAB;
+}
+
 TransferBaseDelegateWidget::ActionHoverType TransferManagerDelegateWidget::mouseHoverTransfer(bool isHover, const QPoint &pos)
 {
     bool update(false);
@@ -2,6 +2,7 @@
 #define TRANSFERMANAGERDELEGATEWIDGET_H
 
 #include "TransferBaseDelegateWidget.h"
+#include "TransferManagerRowPainter.h"
 
 #include <QDateTime>
 #include <QPointer>
@@ -27,6 +28,10 @@ public:
 
     void setColumnManager(QPointer<TransferWidgetColumnsManager> columnManager);
 
+    // Used by the paint-only mode of MegaTransferDelegate
+    uint getPaintLayoutKey(int width) const;
+    TransferManagerRowPainter::Layout getPaintLayout(const QSize& size);
+
 protected:
     void mouseDoubleClickEvent(QMouseEvent *event) override;
     bool eventFilter(QObject* watched, QEvent* event) override;
@@ -52,6 +57,7 @@ private:
 
     bool setCancelClearTransferIcon(const QString &name);
     bool setPauseResumeTransferIcon(const QString &name);
+    bool isFailedTab() const;
 
     Ui::TransferManagerDelegateWidget *mUi;
     QString mPauseResumeTransferDefaultIconName;
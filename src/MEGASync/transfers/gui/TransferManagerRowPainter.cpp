@@ -0,0 +1,361 @@
+#include "TransferManagerRowPainter.h"
+
+#include "IconTokenizer.h"
+#include "ThemeManager.h"
+#include "TokenParserWidgetManager.h"
+#include "TransferBaseDelegateWidget.h"
+#include "Utilities.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyle>
+
+#include <algorithm>
+
+namespace
+{
+// Rows visible at the same time are a few dozens, the cache is just reset when it grows too much
+constexpr int MAX_CACHED_ROWS = 512;
+constexpr int SPEED_ICON_SPACING = 4;
+constexpr int RETRY_BUTTON_PADDING = 8;
+
+const QString SELECTED_TOKEN = QStringLiteral("surface-2");
+const QString PROGRESS_BACKGROUND_TOKEN = QStringLiteral("surface-3");
+const QString PROGRESS_TOKEN = QStringLiteral("indicator-green");
+const QString SEPARATOR_TOKEN = QStringLiteral("border-subtle");
+const QString RETRY_BACKGROUND_TOKEN = QStringLiteral("button-primary");
+const QString RETRY_TEXT_TOKEN = QStringLiteral("text-inverse-accent");
+const QString ICON_TOKEN = QStringLiteral("icon-primary");
+
+const QString CANCEL_CLEAR_ICON = QStringLiteral(":/x_small_thin_outline_button_outline");
+const QString SYNC_ICON = QStringLiteral(":/sync-01.svg");
+}
+
+TransferManagerRowPainter::TransferManagerRowPainter():
+    mHasLayout(false),
+    mTheme(-1)
+{
+}
+
+bool TransferManagerRowPainter::hasLayout(uint key) const
+{
+    return mHasLayout && mLayout.key == key;
+}
+
+void TransferManagerRowPainter::setLayout(const Layout& layout)
+{
+    mLayout = layout;
+    mHasLayout = true;
+    //Elided and prepared texts depend on the layout fonts and widths
+    mRowCaches.clear();
+}
+
+void TransferManagerRowPainter::clear()
+{
+    mHasLayout = false;
+    mRowCaches.clear();
+    mPixmaps.clear();
+}
+
+void TransferManagerRowPainter::paint(QPainter* painter,
+                                      const QStyleOptionViewItem& option,
+                                      const QExplicitlySharedDataPointer<TransferData>& data)
+{
+    auto theme(static_cast<int>(ThemeManager::instance()->currentColorScheme()));
+    if (theme != mTheme)
+    {
+        mTheme = theme;
+        mPixmaps.clear();
+        refreshThemeColors();
+    }
+
+    auto content(TransferManagerRowState::create(data, mLayout.isFailedTab));
+    auto& cache(getRowCache(data->mTag));
+
+    painter->save();
+    painter->translate(option.rect.topLeft());
+
+    // Hovered rows are rendered by the delegate widget, so only the selection is painted here
+    bool showButtons(option.state & QStyle::State_Selected);
+    if (showButtons)
+    {
+        QPainterPath path;
+        painter->setRenderHint(QPainter::Antialiasing, true);
+        path.addRoundedRect(
+            QRectF(12.0, 4.0, option.rect.width() - 24.0, option.rect.height() - 8.0),
+            4,
+            4);
+        painter->fillPath(path, mSelectedColor);
+        painter->setPen(mSelectedColor);
+        painter->drawPath(path);
+    }
+
+    if (mLayout.separator.isValid())
+    {
+        painter->fillRect(mLayout.separator, mSeparatorColor);
+    }
+
+    // File type
+    if (mLayout.fileIcon.isValid())
+    {
+        if (cache.fileIconName.isEmpty())
+        {
+            cache.fileIconName =
+                Utilities::getExtensionPixmapName(data->mFilename, Utilities::AttributeType::MEDIUM);
+        }
+        painter->drawPixmap(mLayout.fileIcon.topLeft(),
+                            getPixmap(cache.fileIconName, mLayout.fileIcon.size()));
+    }
+
+    // Name and sync icon
+    if (mLayout.name.isValid())
+    {
+        const auto& name(getStaticText(cache.name, data->mFilename, mLayout.nameFont, mLayout.name.width()));
+        drawText(painter, name, mLayout.name, mLayout.nameFont, mLayout.nameColor);
+
+        if (data->isSyncTransfer())
+        {
+            QPoint syncPos(mLayout.name.left() + static_cast<int>(name.size().width()) + mLayout.nameSpacing,
+                           mLayout.name.center().y() - mLayout.syncIconSize.height() / 2);
+            painter->drawPixmap(syncPos, getPixmap(SYNC_ICON, mLayout.syncIconSize, ICON_TOKEN));
+        }
+    }
+
+    // Progress bar
+    if (content.showProgressBar && mLayout.progressBar.isValid())
+    {
+        painter->setRenderHint(QPainter::Antialiasing, true);
+        auto radius(mLayout.progressBar.height() / 2.0);
+        QPainterPath background;
+        background.addRoundedRect(mLayout.progressBar, radius, radius);
+        painter->fillPath(background, mProgressBackgroundColor);
+
+        auto chunkWidth(mLayout.progressBar.width() * content.permil / TransferManagerRowState::PB_PRECISION);
+        if (chunkWidth > 0)
+        {
+            QPainterPath chunk;
+            chunk.addRoundedRect(QRect(mLayout.progressBar.topLeft(),
+                                       QSize(chunkWidth, mLayout.progressBar.height())),
+                                 radius,
+                                 radius);
+            painter->fillPath(chunk, mProgressColor);
+        }
+    }
+
+    // Size
+    if (mLayout.size.isValid())
+    {
+        auto sizes(Utilities::getProgressSizes(data->mTransferredBytes, data->mTotalSize));
+        QString sizeString;
+        if (!(data->getState() & TransferData::FINISHED_STATES_MASK))
+        {
+            sizeString = sizes.transferredBytes + QLatin1String(" / ");
+        }
+        sizeString += sizes.totalBytes + QLatin1String(" ") + sizes.units;
+
+        drawText(painter,
+                 getStaticText(cache.size, sizeString, mLayout.textFont),
+                 mLayout.size,
+                 mLayout.textFont,
+                 mLayout.textColor);
+    }
+
+    // Speed
+    if (!mLayout.isFailedTab && mLayout.speed.isValid() && !content.speed.isEmpty())
+    {
+        auto arrowIcon(data->mType & TransferData::TRANSFER_UPLOAD ?
+                           Utilities::getPixmapName(QLatin1String("up_arrow"), Utilities::AttributeType::NONE) :
+                           Utilities::getPixmapName(QLatin1String("down_arrow"), Utilities::AttributeType::NONE));
+        const auto& speed(getStaticText(cache.speed, content.speed, mLayout.speedFont));
+
+        // The speed is a button, so the icon and the text are centered together
+        auto contentWidth(mLayout.speedIconSize.width() + SPEED_ICON_SPACING
+                          + static_cast<int>(speed.size().width()));
+        auto left(mLayout.speed.left() + std::max(0, (mLayout.speed.width() - contentWidth) / 2));
+        painter->drawPixmap(QPoint(left, mLayout.speed.center().y() - mLayout.speedIconSize.height() / 2),
+                            getPixmap(arrowIcon, mLayout.speedIconSize, ICON_TOKEN));
+
+        QRect textRect(mLayout.speed);
+        textRect.setLeft(left + mLayout.speedIconSize.width() + SPEED_ICON_SPACING);
+        drawText(painter, speed, textRect, mLayout.speedFont, mLayout.speedColor);
+    }
+
+    // Status
+    if (mLayout.status.isValid())
+    {
+        const auto& status(getStaticText(cache.status, content.statusText, mLayout.textFont, mLayout.status.width()));
+        drawText(painter, status, mLayout.status, mLayout.textFont, getStatusColor(content.status));
+
+        QRect nextRect(mLayout.status);
+        nextRect.setLeft(mLayout.status.left() + static_cast<int>(status.size().width()) + SPEED_ICON_SPACING);
+
+        if (!content.secondaryStatusText.isEmpty() && nextRect.width() > 0)
+        {
+            const auto& secondary(getStaticText(cache.secondaryStatus, content.secondaryStatusText,
+                                                mLayout.textFont, nextRect.width()));
+            drawText(painter, secondary, nextRect, mLayout.textFont, mLayout.textColor);
+        }
+        else if (content.showRetry && nextRect.width() > 0)
+        {
+            QFontMetrics metrics(mLayout.textFont);
+            auto retryText(TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_RETRY));
+            QRect retryRect(nextRect.left(),
+                            nextRect.center().y() - (metrics.height() + RETRY_BUTTON_PADDING / 2) / 2,
+                            metrics.horizontalAdvance(retryText) + RETRY_BUTTON_PADDING * 2,
+                            metrics.height() + RETRY_BUTTON_PADDING / 2);
+
+            painter->setRenderHint(QPainter::Antialiasing, true);
+            QPainterPath path;
+            path.addRoundedRect(retryRect, 4, 4);
+            painter->fillPath(path, mRetryBackgroundColor);
+            painter->setFont(mLayout.textFont);
+            painter->setPen(mRetryTextColor);
+            painter->drawText(retryRect, Qt::AlignCenter, retryText);
+        }
+    }
+
+    // Remaining or finished time
+    if (!mLayout.isFailedTab && mLayout.time.isValid() && !content.time.isEmpty())
+    {
+        drawText(painter,
+                 getStaticText(cache.time, content.time, mLayout.timeFont, mLayout.time.width()),
+                 mLayout.time,
+                 mLayout.timeFont,
+                 mLayout.timeColor,
+                 mLayout.timeAlignment);
+    }
+
+    // Action buttons, only shown on selected rows
+    if (showButtons)
+    {
+        if (!content.pauseResumeIcon.isEmpty() && mLayout.pauseResume.isValid())
+        {
+            auto iconRect(QStyle::alignedRect(Qt::LeftToRight, Qt::AlignCenter,
+                                              mLayout.actionIconSize, mLayout.pauseResume));
+            painter->drawPixmap(iconRect.topLeft(),
+                                getPixmap(content.pauseResumeIcon, mLayout.actionIconSize));
+        }
+
+        if (content.showCancelClear && mLayout.cancelClear.isValid())
+        {
+            auto iconRect(QStyle::alignedRect(Qt::LeftToRight, Qt::AlignCenter,
+                                              mLayout.actionIconSize, mLayout.cancelClear));
+            painter->drawPixmap(iconRect.topLeft(),
+                                getPixmap(CANCEL_CLEAR_ICON, mLayout.actionIconSize));
+        }
+    }
+
+    painter->restore();
+}
+
+QColor TransferManagerRowPainter::getStatusColor(TransferManagerRowState::Status status) const
+{
+    // The colors of the status labels of each page of the delegate widget
+    switch (status)
+    {
+        case TransferManagerRowState::Status::PAUSED:
+        case TransferManagerRowState::Status::PAUSED_QUEUED:
+            return mLayout.warningColor;
+        case TransferManagerRowState::Status::QUEUED:
+            return mLayout.textColor;
+        case TransferManagerRowState::Status::RETRY_MESSAGE:
+            return mLayout.retryMessageColor;
+        case TransferManagerRowState::Status::FAILED:
+            return mLayout.errorColor;
+        case TransferManagerRowState::Status::ACTIVE:
+        default:
+            return mLayout.successColor;
+    }
+}
+
+TransferManagerRowPainter::RowCache& TransferManagerRowPainter::getRowCache(TransferTag tag)
+{
+    if (mRowCaches.size() > MAX_CACHED_ROWS && !mRowCaches.contains(tag))
+    {
+        mRowCaches.clear();
+    }
+
+    return mRowCaches[tag];
+}
+
+const QStaticText& TransferManagerRowPainter::getStaticText(CachedText& cached,
+                                                            const QString& text,
+                                                            const QFont& font,
+                                                            int width)
+{
+    if (cached.text != text || cached.width != width)
+    {
+        cached.text = text;
+        cached.width = width;
+
+        cached.staticText.setTextFormat(Qt::PlainText);
+        cached.staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+        cached.staticText.setText(width >= 0 ?
+                                      QFontMetrics(font).elidedText(text, Qt::ElideMiddle, width) :
+                                      text);
+        cached.staticText.prepare(QTransform(), font);
+    }
+
+    return cached.staticText;
+}
+
+QPixmap TransferManagerRowPainter::getPixmap(const QString& iconName,
+                                             const QSize& size,
+                                             const QString& colorToken)
+{
+    auto key(QString::fromLatin1("%1_%2x%3_%4")
+                 .arg(iconName)
+                 .arg(size.width())
+                 .arg(size.height())
+                 .arg(colorToken));
+
+    auto pixmapIt(mPixmaps.constFind(key));
+    if (pixmapIt != mPixmaps.constEnd())
+    {
+        return pixmapIt.value();
+    }
+
+    auto pixmap(Utilities::getCachedPixmap(iconName).pixmap(size));
+    if (!colorToken.isEmpty())
+    {
+        auto themedPixmap(IconTokenizer::changePixmapColor(
+            pixmap,
+            TokenParserWidgetManager::instance()->getColor(colorToken)));
+        if (themedPixmap.has_value())
+        {
+            pixmap = themedPixmap.value();
+        }
+    }
+
+    mPixmaps.insert(key, pixmap);
+    return pixmap;
+}
+
+void TransferManagerRowPainter::refreshThemeColors()
+{
+    auto tokenManager(TokenParserWidgetManager::instance());
+    mSelectedColor = tokenManager->getColor(SELECTED_TOKEN);
+    mProgressBackgroundColor = tokenManager->getColor(PROGRESS_BACKGROUND_TOKEN);
+    mProgressColor = tokenManager->getColor(PROGRESS_TOKEN);
+    mSeparatorColor = tokenManager->getColor(SEPARATOR_TOKEN);
+    mRetryBackgroundColor = tokenManager->getColor(RETRY_BACKGROUND_TOKEN);
+    mRetryTextColor = tokenManager->getColor(RETRY_TEXT_TOKEN);
+}
+
+void TransferManagerRowPainter::drawText(QPainter* painter,
+                                         const QStaticText& text,
+                                         const QRect& rect,
+                                         const QFont& font,
+                                         const QColor& color,
+                                         Qt::Alignment alignment)
+{
+    auto textSize(text.size().toSize());
+    auto textRect(QStyle::alignedRect(Qt::LeftToRight,
+                                      (alignment & Qt::AlignHorizontal_Mask) | Qt::AlignVCenter,
+                                      textSize,
+                                      rect));
+
+    painter->setFont(font);
+    painter->setPen(color);
+    painter->drawStaticText(textRect.topLeft(), text);
+}
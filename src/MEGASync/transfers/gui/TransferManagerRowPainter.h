@@ -0,0 +1,124 @@
+#ifndef TRANSFERMANAGERROWPAINTER_H
+#define TRANSFERMANAGERROWPAINTER_H
+
+#include "TransferItem.h"
+#include "TransferManagerRowState.h"
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QPixmap>
+#include <QRect>
+#include <QStaticText>
+#include <QStyleOptionViewItem>
+
+class QPainter;
+
+/// Responsability: paints a Transfer Manager row straight with QPainter, without laying out and
+/// rendering a TransferManagerDelegateWidget.
+/// The geometry, fonts and colors of every element are taken from a laid out delegate widget (see
+/// TransferManagerDelegateWidget::getPaintLayout), so rows look like the widget ones. Texts are
+/// kept as QStaticText per transfer and only laid out again when they change, and icons are
+/// themed pixmaps cached by name and size.
+class TransferManagerRowPainter
+{
+public:
+    struct Layout
+    {
+        // Changes when the row width, the columns, the tab or the theme change
+        uint key = 0;
+        bool isFailedTab = false;
+
+        QRect separator;
+        QRect fileIcon;
+        // Width already discounts the sync icon, as the delegate widget does
+        QRect name;
+        QSize syncIconSize;
+        int nameSpacing = 0;
+        QRect progressBar;
+        QRect size;
+        QRect speed;
+        QSize speedIconSize;
+        QRect status;
+        QRect time;
+        QRect pauseResume;
+        QRect cancelClear;
+        QSize actionIconSize;
+
+        QFont nameFont;
+        QFont textFont;
+        QFont speedFont;
+        QFont timeFont;
+        Qt::Alignment timeAlignment;
+
+        QColor nameColor;
+        QColor textColor;
+        QColor speedColor;
+        QColor timeColor;
+        QColor successColor;
+        QColor warningColor;
+        QColor errorColor;
+        QColor retryMessageColor;
+    };
+
+    TransferManagerRowPainter();
+
+    bool hasLayout(uint key) const;
+    void setLayout(const Layout& layout);
+
+    void paint(QPainter* painter,
+               const QStyleOptionViewItem& option,
+               const QExplicitlySharedDataPointer<TransferData>& data);
+
+    void clear();
+
+private:
+    struct CachedText
+    {
+        QString text;
+        int width = -1;
+        QStaticText staticText;
+    };
+
+    struct RowCache
+    {
+        QString fileIconName;
+        CachedText name;
+        CachedText size;
+        CachedText speed;
+        CachedText status;
+        CachedText secondaryStatus;
+        CachedText time;
+    };
+
+    QColor getStatusColor(TransferManagerRowState::Status status) const;
+    RowCache& getRowCache(TransferTag tag);
+    const QStaticText& getStaticText(CachedText& cached,
+                                     const QString& text,
+                                     const QFont& font,
+                                     int width = -1);
+    QPixmap getPixmap(const QString& iconName, const QSize& size, const QString& colorToken = QString());
+    void refreshThemeColors();
+
+    void drawText(QPainter* painter,
+                  const QStaticText& text,
+                  const QRect& rect,
+                  const QFont& font,
+                  const QColor& color,
+                  Qt::Alignment alignment = Qt::AlignLeft);
+
+    Layout mLayout;
+    bool mHasLayout;
+    QHash<TransferTag, RowCache> mRowCaches;
+    QHash<QString, QPixmap> mPixmaps;
+
+    int mTheme;
+    QColor mSelectedColor;
+    QColor mProgressBackgroundColor;
+    QColor mProgressColor;
+    QColor mSeparatorColor;
+    QColor mRetryBackgroundColor;
+    QColor mRetryTextColor;
+};
+
+#endif // TRANSFERMANAGERROWPAINTER_H
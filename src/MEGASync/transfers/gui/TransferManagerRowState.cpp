@@ -0,0 +1,180 @@
+#include "TransferManagerRowState.h"
+
+#include "MegaApplication.h"
+#include "TransferBaseDelegateWidget.h"
+#include "Utilities.h"
+
+namespace
+{
+const QString PAUSE_ICON = QStringLiteral(":/pause_small_thin_outline_button_outline");
+const QString RESUME_ICON = QStringLiteral(":/play_small_thin_outline_button_outline");
+const QString NO_SPEED = QString::fromUtf8("…");
+
+QString getOverquotaText(const QExplicitlySharedDataPointer<TransferData>& data)
+{
+    return data->mErrorValue ?
+               TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_OUT_OF_TRANSFER_QUOTA) :
+               TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_OUT_OF_STORAGE_SPACE);
+}
+
+QString getFinishedTime(const QExplicitlySharedDataPointer<TransferData>& data)
+{
+    return MegaSyncApp->getFormattedDateByCurrentLanguage(data->getFinishedDateTime(),
+                                                          QLocale::FormatType::ShortFormat);
+}
+}
+
+TransferManagerRowState
+    TransferManagerRowState::create(const QExplicitlySharedDataPointer<TransferData>& data,
+                                    bool isFailedTab)
+{
+    TransferManagerRowState rowState;
+
+    auto state(data->getState());
+    switch (state)
+    {
+        case TransferData::TRANSFER_ACTIVE:
+        {
+            if (data->mTransferredBytes == 0)
+            {
+                rowState.statusText =
+                    TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_STARTING);
+            }
+            else
+            {
+                switch (data->mType)
+                {
+                    case TransferData::TRANSFER_DOWNLOAD:
+                    case TransferData::TRANSFER_LTCPDOWNLOAD:
+                    {
+                        rowState.statusText =
+                            TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_DOWNLOADING);
+                        break;
+                    }
+                    case TransferData::TRANSFER_UPLOAD:
+                    {
+                        rowState.statusText =
+                            TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_UPLOADING);
+                        break;
+                    }
+                    default:
+                    {
+                        rowState.statusText =
+                            TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_SYNCING);
+                        break;
+                    }
+                }
+            }
+
+            rowState.pauseResumeIcon = PAUSE_ICON;
+            if (data->mSpeed != 0)
+            {
+                rowState.time = Utilities::getTimeString(data->mRemainingTime);
+            }
+
+            rowState.speed = data->mTotalSize == data->mTransferredBytes ?
+                                 NO_SPEED :
+                                 Utilities::getSizeString(data->mSpeed) + QLatin1String("/s");
+            break;
+        }
+        case TransferData::TRANSFER_PAUSED:
+        {
+            rowState.statusText = TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_PAUSED);
+            if (data->mTransferredBytes == 0)
+            {
+                rowState.status = Status::PAUSED_QUEUED;
+                rowState.secondaryStatusText =
+                    TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_INQUEUE_PARENTHESIS);
+            }
+            else
+            {
+                rowState.status = Status::PAUSED;
+            }
+
+            rowState.pauseResumeIcon = RESUME_ICON;
+            rowState.isPaused = true;
+            rowState.speed = NO_SPEED;
+            break;
+        }
+        case TransferData::TRANSFER_QUEUED:
+        {
+            if (data->mErrorCode == mega::MegaError::API_EOVERQUOTA)
+            {
+                rowState.status = Status::RETRY_MESSAGE;
+                rowState.statusText = getOverquotaText(data);
+            }
+            else
+            {
+                rowState.status = Status::QUEUED;
+                rowState.statusText =
+                    TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_INQUEUE);
+            }
+
+            rowState.pauseResumeIcon = PAUSE_ICON;
+            break;
+        }
+        case TransferData::TRANSFER_COMPLETING:
+        {
+            rowState.statusText =
+                TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_COMPLETING);
+            rowState.showCancelClear = false;
+            rowState.speed = NO_SPEED;
+            break;
+        }
+        case TransferData::TRANSFER_FAILED:
+        {
+            rowState.status = Status::FAILED;
+            rowState.statusText =
+                isFailedTab ? TransferBaseDelegateWidget::getErrorText(data) :
+                              TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_FAILED);
+            rowState.showRetry = data->canBeRetried();
+            rowState.showProgressBar = false;
+            rowState.speed = NO_SPEED;
+            rowState.time = getFinishedTime(data);
+            break;
+        }
+        case TransferData::TRANSFER_RETRYING:
+        {
+            if (data->mErrorCode == mega::MegaError::API_EOVERQUOTA)
+            {
+                rowState.status = Status::RETRY_MESSAGE;
+                rowState.statusText = getOverquotaText(data);
+            }
+            else
+            {
+                rowState.statusText =
+                    TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_RETRYING);
+            }
+
+            rowState.pauseResumeIcon = PAUSE_ICON;
+            break;
+        }
+        case TransferData::TRANSFER_COMPLETED:
+        {
+            rowState.statusText =
+                TransferBaseDelegateWidget::getState(TRANSFER_STATES::STATE_COMPLETED);
+            rowState.showProgressBar = false;
+            rowState.isClear = true;
+            rowState.speed = Utilities::getSizeString(data->mSpeed) + QLatin1String("/s");
+            rowState.time = getFinishedTime(data);
+            break;
+        }
+        default:
+            //Cancelled transfers are immediately removed from the model
+            break;
+    }
+
+    if ((data->mType & TransferData::TRANSFER_SYNC) && !(state & TransferData::TRANSFER_COMPLETED))
+    {
+        rowState.showCancelClear = false;
+    }
+
+    rowState.permil =
+        state & (TransferData::TRANSFER_COMPLETED | TransferData::TRANSFER_COMPLETING) ?
+            PB_PRECISION :
+            data->mTotalSize > 0 ?
+            Utilities::partPer(data->mTransferredBytes, data->mTotalSize, PB_PRECISION) :
+            0;
+
+    return rowState;
+}
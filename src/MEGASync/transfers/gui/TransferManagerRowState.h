@@ -0,0 +1,47 @@
+#ifndef TRANSFERMANAGERROWSTATE_H
+#define TRANSFERMANAGERROWSTATE_H
+
+#include "TransferItem.h"
+
+#include <QString>
+
+/// Responsability: maps the state of a transfer to what its Transfer Manager row shows: the status
+/// texts, the speed and time strings, the progress and the actions.
+/// Both TransferManagerDelegateWidget and TransferManagerRowPainter show a row from it, so a state
+/// change only needs to be made here.
+struct TransferManagerRowState
+{
+    // Which status is shown. The widget has a page for each one, and the painter a color
+    enum class Status
+    {
+        ACTIVE,
+        PAUSED,
+        PAUSED_QUEUED,
+        QUEUED,
+        RETRY_MESSAGE,
+        FAILED
+    };
+
+    static constexpr int PB_PRECISION = 1000;
+
+    static TransferManagerRowState create(const QExplicitlySharedDataPointer<TransferData>& data,
+                                          bool isFailedTab);
+
+    Status status = Status::ACTIVE;
+    QString statusText;
+    // Only for PAUSED_QUEUED, shown after the status text
+    QString secondaryStatusText;
+    QString speed;
+    QString time;
+    bool showProgressBar = true;
+    int permil = 0;
+    bool showRetry = false;
+    // Empty when the pause/resume action is not available
+    QString pauseResumeIcon;
+    bool isPaused = false;
+    bool showCancelClear = true;
+    // Finished transfers are cleared instead of cancelled
+    bool isClear = false;
+};
+
+#endif // TRANSFERMANAGERROWSTATE_H
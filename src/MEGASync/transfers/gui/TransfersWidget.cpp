@@ -97,6 +97,7 @@ void TransfersWidget::configureTransferView()
     }
 
     tDelegate = new MegaTransferDelegate(mProxyModel, ui->tvTransfers);
+    tDelegate->setPaintOnlyMode(true);
     ui->tvTransfers->setup(this);
     ui->tvTransfers->setItemDelegate(tDelegate);
     ui->tvTransfers->setDragEnabled(true);
@@ -99,6 +99,16 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
         return false;
     };
 
+    auto getTransferErrorCode = [](mega::MegaTransfer* transfer, mega::MegaError* e) -> int {
+        auto error(transfer->getLastErrorExtended());
+        if(error)
+        {
+            return error->getErrorCode();
+        }
+
+        return e ? e->getErrorCode() : mega::MegaError::API_OK;
+    };
+
     if(transfer->isFolderTransfer())
     {
         TransferMetaDataItemId id(transfer->getTag(), transfer->getNodeHandle(), QString::fromUtf8(transfer->getFileName()), QString::fromUtf8(transfer->getPath()));
@@ -115,7 +125,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                 e->getErrorCode() != mega::MegaError::API_OK)
             {
                 state = TransferData::TRANSFER_FAILED;
-                value->failedTransfer = std::shared_ptr<mega::MegaTransfer>(transfer->copy());
+                value->errorCode = getTransferErrorCode(transfer, e);
             }
             else
             {
@@ -176,7 +186,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
             TransferData::TransferState state = TransferData::convertState(transfer->getState());
             if(state == TransferData::TRANSFER_FAILED)
             {
-                item->failedTransfer = std::shared_ptr<mega::MegaTransfer>(transfer->copy());
+                item->errorCode = getTransferErrorCode(transfer, e);
             }
 
             if(transfer->getFolderTransferTag() > 0)
@@ -1040,17 +1050,17 @@ bool TransferMetaDataContainer::start(mega::MegaTransfer *transfer)
     return false;
 }
 
-void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsigned long long appDataId)
+void TransferMetaDataContainer::retryTransfer(const QExplicitlySharedDataPointer<TransferData>& transfer, unsigned long long appDataId)
 {
     if(appDataId > 0)
     {
         auto data = TransferMetaDataContainer::getAppDataById(appDataId);
         if(data)
         {
-            if(!transfer->isFolderTransfer())
+            if(!transfer->mRetryInfo || !transfer->mRetryInfo->mIsFolderTransfer)
             {
                 QMutexLocker lock(&mMutex);
-                data->retryFailingFile(transfer->getTag(), transfer->getNodeHandle());
+                data->retryFailingFile(transfer->mTag, transfer->mNodeHandle);
             }
 
             if(data->mNonExistsFailAppId != 0)
@@ -1060,7 +1070,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
                 {
                     {
                         QMutexLocker lock(&mMutex);
-                        nonExistData->retryFailingFile(transfer->getTag(), transfer->getNodeHandle());
+                        nonExistData->retryFailingFile(transfer->mTag, transfer->mNodeHandle);
                     }
 
                     if(nonExistData->isEmpty())
@@ -1073,14 +1083,14 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
             }
         }
     }
-    else if(transfer->getFolderTransferTag() > 0)
+    else if(transfer->mFolderTransferTag > 0)
     {
-        auto data = TransferMetaDataContainer::getAppDataByFolderTransferTag(transfer->getFolderTransferTag());
+        auto data = TransferMetaDataContainer::getAppDataByFolderTransferTag(transfer->mFolderTransferTag);
         if(data)
         {
             {
                 QMutexLocker lock(&mMutex);
-                data->retryFileFromFolderFailingItem(transfer->getTag(), transfer->getFolderTransferTag(),transfer->getNodeHandle());
+                data->retryFileFromFolderFailingItem(transfer->mTag, transfer->mFolderTransferTag,transfer->mNodeHandle);
             }
 
             if(data->mNonExistsFailAppId != 0)
@@ -1090,7 +1100,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
                 {
                     {
                         QMutexLocker lock(&mMutex);
-                        nonExistData->retryFileFromFolderFailingItem(transfer->getTag(), transfer->getFolderTransferTag(), transfer->getNodeHandle());
+                        nonExistData->retryFileFromFolderFailingItem(transfer->mTag, transfer->mFolderTransferTag, transfer->mNodeHandle);
                     }
 
                     if(nonExistData->isEmpty())
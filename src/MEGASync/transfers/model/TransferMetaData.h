@@ -43,7 +43,7 @@ struct TransferMetaDataItemId
 struct TransferMetaDataItem
 {
     TransferMetaDataItem(const TransferMetaDataItemId& uid)
-        :id(uid), state(TransferData::TRANSFER_ACTIVE), failedTransfer(nullptr){}
+        :id(uid), state(TransferData::TRANSFER_ACTIVE), errorCode(mega::MegaError::API_OK){}
 
     virtual ~TransferMetaDataItem() = default;
 
@@ -51,7 +51,8 @@ struct TransferMetaDataItem
     TransferMetaDataItemId topLevelFolderId;
     TransferMetaDataItemId folderId;
     TransferData::TransferState state;
-    std::shared_ptr<mega::MegaTransfer> failedTransfer;
+    //Only the error of the failed transfer is needed, no need to keep a copy of it
+    int errorCode;
 
     virtual TransferData::TransferState getState()
     {
@@ -60,12 +61,7 @@ struct TransferMetaDataItem
 
     int getErrorCode()
     {
-        if (failedTransfer)
-        {
-            return failedTransfer->getLastErrorExtended()->getErrorCode();
-        }
-
-        return mega::MegaError::API_OK;
+        return errorCode;
     }
 };
 
@@ -444,7 +440,7 @@ public:
     static void finish(unsigned long long appId, mega::MegaTransfer* transfer, mega::MegaError* e);
     static bool finishFromFolderTransfer(mega::MegaTransfer* transfer, mega::MegaError* e);
 
-    static void retryTransfer(mega::MegaTransfer* transfer, unsigned long long appDataId);
+    static void retryTransfer(const QExplicitlySharedDataPointer<TransferData>& transfer, unsigned long long appDataId);
     static void retryAllPressed()
     {
         QMutexLocker lock(&mMutex);
@@ -455,15 +451,15 @@ public:
     }
 
     template <typename TYPE = TransferMetaData>
-    static std::shared_ptr<TYPE> getAppData(mega::MegaTransfer* transfer)
+    static std::shared_ptr<TYPE> getAppData(const QExplicitlySharedDataPointer<TransferData>& transfer)
     {
-        if(transfer->getFolderTransferTag() > 0)
+        if(transfer->mFolderTransferTag > 0)
         {
-            return getAppDataByFolderTransferTag<TYPE>(transfer->getFolderTransferTag());
+            return getAppDataByFolderTransferTag<TYPE>(transfer->mFolderTransferTag);
         }
-        else
+        else if(transfer->mRetryInfo)
         {
-            auto appData = appDataToId(transfer->getAppData());
+            auto appData = appDataToId(transfer->mRetryInfo->getAppData());
             if(appData.first)
             {
                 return getAppDataById<TYPE>(appData.second);
@@ -0,0 +1,87 @@
+#include "TransferStringPool.h"
+
+#include <QMutexLocker>
+
+TransferStringPool::TransferStringPool():
+    mBytes(0)
+{
+}
+
+TransferStringPool& TransferStringPool::instance()
+{
+    static TransferStringPool pool;
+    return pool;
+}
+
+QString TransferStringPool::intern(const QString& value)
+{
+    if(value.isEmpty())
+    {
+        return QString();
+    }
+
+    QMutexLocker lock(&mMutex);
+
+    auto pooledValue(mStrings.constFind(value));
+    if(pooledValue != mStrings.constEnd())
+    {
+        return *pooledValue;
+    }
+
+    //Strings built from the SDK (fromUtf8) usually have some extra capacity
+    QString newValue(value);
+    newValue.squeeze();
+    mStrings.insert(newValue);
+    mBytes += stringBytes(newValue);
+
+    return newValue;
+}
+
+void TransferStringPool::purge()
+{
+    QMutexLocker lock(&mMutex);
+
+    for(auto it = mStrings.begin(); it != mStrings.end();)
+    {
+        //Only the pool holds the buffer, no transfer uses it anymore
+        if(it->isDetached())
+        {
+            mBytes -= stringBytes(*it);
+            it = mStrings.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void TransferStringPool::clear()
+{
+    QMutexLocker lock(&mMutex);
+
+    mStrings.clear();
+    mBytes = 0;
+}
+
+int TransferStringPool::size() const
+{
+    QMutexLocker lock(&mMutex);
+    return mStrings.size();
+}
+
+qint64 TransferStringPool::bytes() const
+{
+    QMutexLocker lock(&mMutex);
+    return mBytes;
+}
+
+qint64 TransferStringPool::stringBytes(const QString& value)
+{
+    if(value.isNull())
+    {
+        return 0;
+    }
+
+    return static_cast<qint64>(sizeof(QArrayData)) + (value.capacity() + 1) * static_cast<qint64>(sizeof(QChar));
+}
@@ -0,0 +1,36 @@
+#ifndef TRANSFERSTRINGPOOL_H
+#define TRANSFERSTRINGPOOL_H
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+/// Responsability: shares the strings repeated across transfers (file names, parent folders...)
+/// so every TransferData points to the same QString buffer instead of owning a copy.
+/// A folder upload of thousands of files keeps a single copy of every folder path. Strings no
+/// longer used by any transfer are only released on purge(), which the TransfersModel calls
+/// after removing rows.
+class TransferStringPool
+{
+public:
+    TransferStringPool();
+
+    static TransferStringPool& instance();
+
+    QString intern(const QString& value);
+    void purge();
+    void clear();
+
+    int size() const;
+    // Heap memory used by the pooled strings
+    qint64 bytes() const;
+
+    static qint64 stringBytes(const QString& value);
+
+private:
+    mutable QMutex mMutex;
+    QSet<QString> mStrings;
+    qint64 mBytes;
+};
+
+#endif // TRANSFERSTRINGPOOL_H
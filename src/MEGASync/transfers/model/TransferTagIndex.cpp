@@ -0,0 +1,267 @@
+#include "TransferTagIndex.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+constexpr size_t MIN_BUCKETS = 16;
+constexpr int MIN_BUCKETS_BITS = 4;
+// 2^32 / golden ratio, used for Fibonacci hashing
+constexpr uint32_t HASH_MULTIPLIER = 2654435769u;
+}
+
+TransferTagIndex::TransferTagIndex():
+    mMask(0),
+    mShift(0),
+    mDirtyFrom(CLEAN),
+    mBatchDepth(0)
+{
+    rehash(MIN_BUCKETS);
+}
+
+int TransferTagIndex::append(TransferTag tag)
+{
+    assert(!contains(tag));
+
+    auto row(static_cast<int>(mSlots.size()));
+    mSlots.push_back(tag);
+
+    // Keep the load factor under 0.5, so probe sequences stay short
+    if (mSlots.size() * 2 > mBuckets.size())
+    {
+        rehash(mBuckets.size() * 2);
+    }
+    else
+    {
+        insertBucket(tag, row);
+    }
+
+    return row;
+}
+
+void TransferTagIndex::removeRows(int row, int count)
+{
+    auto total(size());
+    if (row < 0 || count <= 0 || row >= total)
+    {
+        return;
+    }
+
+    count = std::min(count, total - row);
+
+    auto first(mSlots.begin() + row);
+    auto last(first + count);
+    for (auto it = first; it != last; ++it)
+    {
+        eraseBucket(*it);
+    }
+    mSlots.erase(first, last);
+
+    markDirty(row);
+}
+
+// Same semantics as QAbstractItemModel::moveRows: destinationRow is the row before which the
+// moved rows are placed, expressed in the coordinates before the move
+void TransferTagIndex::moveRows(int sourceRow, int count, int destinationRow)
+{
+    auto total(size());
+    if (sourceRow < 0 || count <= 0 || sourceRow + count > total || destinationRow < 0 ||
+        destinationRow > total)
+    {
+        return;
+    }
+
+    auto begin(mSlots.begin());
+    if (destinationRow < sourceRow)
+    {
+        std::rotate(begin + destinationRow, begin + sourceRow, begin + sourceRow + count);
+        markDirty(destinationRow);
+    }
+    else if (destinationRow > sourceRow + count)
+    {
+        std::rotate(begin + sourceRow, begin + sourceRow + count, begin + destinationRow);
+        markDirty(sourceRow);
+    }
+}
+
+void TransferTagIndex::clear()
+{
+    mSlots.clear();
+    mDirtyFrom = CLEAN;
+    rehash(MIN_BUCKETS);
+}
+
+void TransferTagIndex::reserve(int size)
+{
+    if (size <= 0)
+    {
+        return;
+    }
+
+    mSlots.reserve(static_cast<size_t>(size));
+
+    auto bucketCount(mBuckets.size());
+    while (static_cast<size_t>(size) * 2 > bucketCount)
+    {
+        bucketCount *= 2;
+    }
+
+    if (bucketCount != mBuckets.size())
+    {
+        rehash(bucketCount);
+    }
+}
+
+int TransferTagIndex::row(TransferTag tag) const
+{
+    auto bucket(findBucket(tag));
+    if (bucket == mBuckets.size())
+    {
+        return -1;
+    }
+
+    // Rows under mDirtyFrom are always up to date
+    auto storedRow(mBuckets[bucket].row);
+    if (storedRow < mDirtyFrom)
+    {
+        return storedRow;
+    }
+
+    // Only reached when looking up inside a batch: the tag is in the shifted part of the store
+    auto begin(mSlots.cbegin() + mDirtyFrom);
+    auto it(std::find(begin, mSlots.cend(), tag));
+    return it != mSlots.cend() ? static_cast<int>(it - mSlots.cbegin()) : -1;
+}
+
+bool TransferTagIndex::contains(TransferTag tag) const
+{
+    return findBucket(tag) != mBuckets.size();
+}
+
+TransferTag TransferTagIndex::tagAt(int row) const
+{
+    return (row >= 0 && row < size()) ? mSlots[static_cast<size_t>(row)] : 0;
+}
+
+int TransferTagIndex::size() const
+{
+    return static_cast<int>(mSlots.size());
+}
+
+void TransferTagIndex::beginBatch()
+{
+    ++mBatchDepth;
+}
+
+void TransferTagIndex::endBatch()
+{
+    assert(mBatchDepth > 0);
+
+    if (mBatchDepth > 0 && --mBatchDepth == 0 && mDirtyFrom != CLEAN)
+    {
+        refreshRows();
+    }
+}
+
+bool TransferTagIndex::isInBatch() const
+{
+    return mBatchDepth > 0;
+}
+
+size_t TransferTagIndex::idealBucket(TransferTag tag) const
+{
+    return static_cast<size_t>((static_cast<uint32_t>(tag) * HASH_MULTIPLIER) >> mShift) & mMask;
+}
+
+size_t TransferTagIndex::findBucket(TransferTag tag) const
+{
+    auto bucket(idealBucket(tag));
+    while (mBuckets[bucket].row != EMPTY_BUCKET)
+    {
+        if (mBuckets[bucket].tag == tag)
+        {
+            return bucket;
+        }
+        bucket = (bucket + 1) & mMask;
+    }
+
+    return mBuckets.size();
+}
+
+void TransferTagIndex::insertBucket(TransferTag tag, int row)
+{
+    auto bucket(idealBucket(tag));
+    while (mBuckets[bucket].row != EMPTY_BUCKET && mBuckets[bucket].tag != tag)
+    {
+        bucket = (bucket + 1) & mMask;
+    }
+
+    mBuckets[bucket].tag = tag;
+    mBuckets[bucket].row = row;
+}
+
+// Backward shift deletion: no tombstones, so lookups never degrade after many removals
+void TransferTagIndex::eraseBucket(TransferTag tag)
+{
+    auto hole(findBucket(tag));
+    if (hole == mBuckets.size())
+    {
+        return;
+    }
+
+    auto next((hole + 1) & mMask);
+    while (mBuckets[next].row != EMPTY_BUCKET)
+    {
+        auto ideal(idealBucket(mBuckets[next].tag));
+        // The entry can fill the hole if its ideal bucket is not between the hole and itself
+        if (((next - ideal) & mMask) >= ((next - hole) & mMask))
+        {
+            mBuckets[hole] = mBuckets[next];
+            hole = next;
+        }
+        next = (next + 1) & mMask;
+    }
+
+    mBuckets[hole] = Bucket();
+}
+
+void TransferTagIndex::rehash(size_t bucketCount)
+{
+    int bits(MIN_BUCKETS_BITS);
+    while ((size_t(1) << bits) < bucketCount)
+    {
+        ++bits;
+    }
+
+    mBuckets.assign(size_t(1) << bits, Bucket());
+    mMask = mBuckets.size() - 1;
+    mShift = 32 - bits;
+
+    // Rows come from the slot store, so all of them are up to date after a rehash
+    for (size_t row = 0; row < mSlots.size(); ++row)
+    {
+        insertBucket(mSlots[row], static_cast<int>(row));
+    }
+    mDirtyFrom = CLEAN;
+}
+
+void TransferTagIndex::markDirty(int fromRow)
+{
+    mDirtyFrom = std::min(mDirtyFrom, fromRow);
+
+    if (mBatchDepth == 0)
+    {
+        refreshRows();
+    }
+}
+
+void TransferTagIndex::refreshRows()
+{
+    for (auto row = static_cast<size_t>(std::min(mDirtyFrom, size())); row < mSlots.size(); ++row)
+    {
+        mBuckets[findBucket(mSlots[row])].row = static_cast<int>(row);
+    }
+
+    mDirtyFrom = CLEAN;
+}
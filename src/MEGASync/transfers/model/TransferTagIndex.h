@@ -0,0 +1,63 @@
+#ifndef TRANSFERTAGINDEX_H
+#define TRANSFERTAGINDEX_H
+
+#include "TransferItem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// Responsability: keeps the row of every transfer tag of the TransfersModel without using
+/// QPersistentModelIndex (which Qt has to fix up on every removeRows/moveRows).
+/// Tags are stored in a contiguous slot store (row -> tag) and in an open-addressing hash table
+/// (tag -> row) with linear probing. Both are updated incrementally on insert, remove and move.
+/// Rows shifted by a remove/move are refreshed in a single pass; when several operations are done
+/// in a row, wrap them between beginBatch()/endBatch() so the refresh is done only once.
+class TransferTagIndex
+{
+public:
+    TransferTagIndex();
+
+    int append(TransferTag tag);
+    void removeRows(int row, int count);
+    void moveRows(int sourceRow, int count, int destinationRow);
+    void clear();
+    void reserve(int size);
+
+    int row(TransferTag tag) const;
+    bool contains(TransferTag tag) const;
+    TransferTag tagAt(int row) const;
+    int size() const;
+
+    void beginBatch();
+    void endBatch();
+    bool isInBatch() const;
+
+private:
+    struct Bucket
+    {
+        TransferTag tag = 0;
+        int row = EMPTY_BUCKET;
+    };
+
+    static constexpr int EMPTY_BUCKET = -1;
+    static constexpr int CLEAN = std::numeric_limits<int>::max();
+
+    size_t idealBucket(TransferTag tag) const;
+    size_t findBucket(TransferTag tag) const;
+    void insertBucket(TransferTag tag, int row);
+    void eraseBucket(TransferTag tag);
+    void rehash(size_t bucketCount);
+    void markDirty(int fromRow);
+    void refreshRows();
+
+    std::vector<TransferTag> mSlots;
+    std::vector<Bucket> mBuckets;
+    size_t mMask;
+    int mShift;
+    int mDirtyFrom;
+    int mBatchDepth;
+};
+
+#endif // TRANSFERTAGINDEX_H
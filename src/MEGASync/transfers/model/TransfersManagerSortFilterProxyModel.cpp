@@ -61,6 +61,7 @@ void TransfersManagerSortFilterProxyModel::sort(int sortCriterion, Qt::SortOrder
     QFuture<void> sorting = QtConcurrent::run([this]()
     {
         startProcessingInOtherThread();
+        runSortFilterEngine();
         if(sortOrder() == mSortOrder)
         {
             QSortFilterProxyModel::sort(-1,mSortOrder);
@@ -78,8 +79,8 @@ int TransfersManagerSortFilterProxyModel::getSortCriterion() const
 
 void TransfersManagerSortFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
 {
-    connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved,
-            this, &TransfersManagerSortFilterProxyModel::onRowsAboutToBeRemoved, Qt::DirectConnection);
+    connect(sourceModel, &QAbstractItemModel::rowsRemoved,
+            this, &TransfersManagerSortFilterProxyModel::onRowsRemoved, Qt::DirectConnection);
 
     QSortFilterProxyModel::setSourceModel(sourceModel);
 }
@@ -94,7 +95,6 @@ void TransfersManagerSortFilterProxyModel::refreshFilterFixedString()
 {
     updateFilters();
 
-    resetAllCounters();
     emit modelAboutToBeChanged();
 
     invalidateModel();
@@ -103,7 +103,6 @@ void TransfersManagerSortFilterProxyModel::refreshFilterFixedString()
 void TransfersManagerSortFilterProxyModel::textSearchTypeChanged()
 {
     updateFilters();
-    resetTransfersStateCounters();
     emit modelAboutToBeChanged();
 
     invalidateModel();
@@ -125,6 +124,7 @@ void TransfersManagerSortFilterProxyModel::invalidateModel()
     emit layoutAboutToBeChanged();
     QFuture<void> filtered = QtConcurrent::run([this](){
         startProcessingInOtherThread();
+        runSortFilterEngine();
 
         invalidate();
         invalidateFilter();
@@ -139,6 +139,21 @@ void TransfersManagerSortFilterProxyModel::invalidateModel()
     mFilterWatcher.setFuture(filtered);
 }
 
+//It is called from a QtConcurrent thread, with the source model blocked
+void TransfersManagerSortFilterProxyModel::runSortFilterEngine()
+{
+    auto sourceM = qobject_cast<TransfersModel*>(sourceModel());
+    if(sourceM)
+    {
+        TransfersSortFilterEngine::Filters filters{mTransferStates, mTransferTypes, mFileTypes};
+        auto transfers(sourceM->getTransfersToIterate());
+        mSortFilterEngine.process(transfers, filters, mFilterText, mSortCriterion);
+        mSortFilterEngine.setActive(true);
+        //The model is blocked, so no transfer is added while the name counters are refreshed
+        sourceM->getStateCounters().setFilterText(mFilterText, transfers);
+    }
+}
+
 void TransfersManagerSortFilterProxyModel::startProcessingInOtherThread()
 {
     blockMutexesAndSignals(true);
@@ -146,6 +161,8 @@ void TransfersManagerSortFilterProxyModel::startProcessingInOtherThread()
 
 void TransfersManagerSortFilterProxyModel::finishProcessingInOtherThread()
 {
+    //From now on, rows are sorted and filtered one by one with the live data (dynamic sort filter)
+    mSortFilterEngine.setActive(false);
     blockMutexesAndSignals(false);
 }
 
@@ -204,7 +221,6 @@ void TransfersManagerSortFilterProxyModel::setFilters(const TransferData::Transf
 
 void TransfersManagerSortFilterProxyModel::resetAllFilters()
 {
-    resetAllCounters();
     setFilters({}, {}, {});
 }
 
@@ -214,31 +230,26 @@ int  TransfersManagerSortFilterProxyModel::getNumberOfItems(TransferData::Transf
 
     if(transferType == TransferData::TransferType::TRANSFER_UPLOAD)
     {
-        nb = mUlNumber.size();
+        nb = getCounters().uploadsFound;
     }
     else if(transferType == TransferData::TransferType::TRANSFER_DOWNLOAD)
     {
-        nb = mDlNumber.size();
+        nb = getCounters().downloadsFound;
     }
 
     return nb;
 }
 
-void TransfersManagerSortFilterProxyModel::resetAllCounters()
+TransfersStateCounters::Counters TransfersManagerSortFilterProxyModel::getCounters() const
 {
-    mDlNumber.clear();
-    mUlNumber.clear();
-    resetTransfersStateCounters();
-}
+    auto sourceM = qobject_cast<TransfersModel*>(sourceModel());
+    if(sourceM)
+    {
+        TransfersSortFilterEngine::Filters filters{mTransferStates, mTransferTypes, mFileTypes};
+        return sourceM->getStateCounters().counters(filters);
+    }
 
-void TransfersManagerSortFilterProxyModel::resetTransfersStateCounters()
-{
-    mNoSyncTransfers.clear();
-    mActiveTransfers.clear();
-    mPausedTransfers.clear();
-    mCompletedTransfers.clear();
-    mFailedTransfers.clear();
-    mPermanentFailedTransfers.clear();
+    return TransfersStateCounters::Counters();
 }
 
 TransferBaseDelegateWidget*
@@ -278,9 +289,19 @@ void TransfersManagerSortFilterProxyModel::updateFilters()
 bool TransfersManagerSortFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
     bool accept(false);
+    QExplicitlySharedDataPointer<TransferData> d;
 
-    QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
-    const auto d (qvariant_cast<TransferItem>(index.data()).getTransferData());
+    //While the model is sorted and filtered as a whole, use the precomputed results
+    auto useEngine(mSortFilterEngine.isActive() && sourceRow < mSortFilterEngine.size());
+    if(useEngine)
+    {
+        d = mSortFilterEngine.transferAt(sourceRow);
+    }
+    else
+    {
+        QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+        d = qvariant_cast<TransferItem>(index.data()).getTransferData();
+    }
 
     if(d && d->mTag >= 0)
     {
@@ -289,90 +310,17 @@ bool TransfersManagerSortFilterProxyModel::filterAcceptsRow(int sourceRow, const
             return false;
         }
 
-        accept = (d->getState() & mTransferStates)
-                 && (d->mType & mTransferTypes)
-                 && (toInt(d->mFileType) & mFileTypes);
-
-        if(!mFilterText.isEmpty())
-        {
-            auto containsText = d->mFilename.contains(mFilterText,Qt::CaseInsensitive);
-            accept &= containsText;
-
-            if(containsText)
-            {
-                if (d->mType & TransferData::TRANSFER_UPLOAD && !mUlNumber.contains(d->mTag))
-                {
-                    mUlNumber.insert(d->mTag);
-                }
-                else if (d->mType & TransferData::TRANSFER_DOWNLOAD && !mDlNumber.contains(d->mTag))
-                {
-                    mDlNumber.insert(d->mTag);
-                }
-            }
-        }
-
-        bool isActive(false);
-
-        //Not needed to add the logic when the d is a sync transfer, as the sync state is permanent
-        if(accept && (!d->isCompleted() && !d->isCompleting()))
-        {
-            //As the active state can change in time, add both logics to add or remove
-            if(d->isActiveOrPending())
-            {
-                mActiveTransfers.insert(d->mTag);
-                isActive = true;
-            }
-
-            //As the No sync does not change in time, the remove logic is not added
-            if(!d->isSyncTransfer())
-            {
-                mNoSyncTransfers.insert(d->mTag);
-            }
-        }
-
-        if(!isActive)
-        {
-            removeActiveTransferFromCounter(d->mTag);
-        }
-
-        if(accept && (d->isActiveOrPending() && d->isCompleting()))
-        {
-            mCompletingTransfers.insert(d->mTag);
-        }
-        else
-        {
-            removeCompletingTransferFromCounter(d->mTag);
-        }
-
-        if(accept && d->isPaused())
-        {
-            mPausedTransfers.insert(d->mTag);
-        }
-        else
-        {
-            removePausedTransferFromCounter(d->mTag);
-        }
-
-        if(accept && ((d->isCompleted() && !d->isFailed())))
-        {
-            mCompletedTransfers.insert(d->mTag);
-        }
-        else
-        {
-            removeCompletedTransferFromCounter(d->mTag);
-        }
-
-        if(accept && d->isFailed())
+        if(useEngine)
         {
-            mFailedTransfers.insert(d->mTag);
-            if(!d->canBeRetried())
-            {
-                mPermanentFailedTransfers.insert(d->mTag);
-            }
+            accept = mSortFilterEngine.isAccepted(sourceRow);
         }
         else
         {
-            removeFailedTransferFromCounter(d->mTag);
+            auto containsText(mFilterText.isEmpty() || d->mFilename.contains(mFilterText,Qt::CaseInsensitive));
+            accept = (d->getState() & mTransferStates)
+                     && (d->mType & mTransferTypes)
+                     && (toInt(d->mFileType) & mFileTypes)
+                     && containsText;
         }
     }
 
@@ -381,6 +329,12 @@ bool TransfersManagerSortFilterProxyModel::filterAcceptsRow(int sourceRow, const
 
 bool TransfersManagerSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
+    if(mSortFilterEngine.isActive()
+        && left.row() < mSortFilterEngine.size() && right.row() < mSortFilterEngine.size())
+    {
+        return mSortFilterEngine.lessThan(left.row(), right.row());
+    }
+
     const auto leftItem (qvariant_cast<TransferItem>(left.data()).getTransferData());
     const auto rightItem (qvariant_cast<TransferItem>(right.data()).getTransferData());
 
@@ -423,99 +377,15 @@ bool TransfersManagerSortFilterProxyModel::lessThan(const QModelIndex &left, con
     return QSortFilterProxyModel::lessThan(left, right);
 }
 
-//It is called from a QtConcurrent thread
-void TransfersManagerSortFilterProxyModel::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+//It is called from a QtConcurrent thread, the removed transfers are already out of the counters
+void TransfersManagerSortFilterProxyModel::onRowsRemoved(const QModelIndex&, int, int)
 {
-   bool searchRowsRemoved(false);
-
-   for(int row = first; row <= last; ++row)
-   {
-       QModelIndex index = sourceModel()->index(row, 0, parent);
-
-       const auto d (qvariant_cast<TransferItem>(index.data()).getTransferData());
-
-       if(d && d->mTag >= 0)
-       {
-           searchRowsRemoved |= updateTransfersCounterFromTag(d);
-       }
-   }
-
-   if(searchRowsRemoved)
+   if(!mFilterText.isEmpty())
    {
        emit searchNumbersChanged();
    }
 }
 
-bool TransfersManagerSortFilterProxyModel::updateTransfersCounterFromTag(QExplicitlySharedDataPointer<TransferData> transfer) const
-{
-    bool searchRowsRemoved(false);
-
-    if(!mFilterText.isEmpty())
-    {
-        if (transfer->mType & TransferData::TRANSFER_UPLOAD)
-        {
-            mUlNumber.remove(transfer->mTag);
-        }
-        else
-        {
-            mDlNumber.remove(transfer->mTag);
-        }
-
-        searchRowsRemoved = true;
-    }
-
-    if(!transfer->isSyncTransfer())
-    {
-       removeNonSyncedTransferFromCounter(transfer->mTag);
-    }
-
-    if(transfer->isCompleted())
-    {
-        removeCompletedTransferFromCounter(transfer->mTag);
-    }
-    else if(transfer->isFailed())
-    {
-        removeFailedTransferFromCounter(transfer->mTag);
-    }
-
-    removeActiveTransferFromCounter(transfer->mTag);
-    removePausedTransferFromCounter(transfer->mTag);
-    removeCompletingTransferFromCounter(transfer->mTag);
-
-    return searchRowsRemoved;
-}
-
-void TransfersManagerSortFilterProxyModel::removeActiveTransferFromCounter(TransferTag tag) const
-{
-    mActiveTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removePausedTransferFromCounter(TransferTag tag) const
-{
-    mPausedTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeNonSyncedTransferFromCounter(TransferTag tag) const
-{
-    mNoSyncTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeCompletedTransferFromCounter(TransferTag tag) const
-{
-    mCompletedTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeFailedTransferFromCounter(TransferTag tag) const
-{
-    mFailedTransfers.remove(tag);
-    mPermanentFailedTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeCompletingTransferFromCounter(TransferTag tag) const
-{
-    mCompletingTransfers.remove(tag);
-}
-
 QMimeData *TransfersManagerSortFilterProxyModel::mimeData(const QModelIndexList &indexes) const
 {
     //sorted in inverse order to guarantee that the original order is preserved
@@ -588,12 +458,13 @@ bool TransfersManagerSortFilterProxyModel::dropMimeData(const QMimeData *data, Q
 
 int TransfersManagerSortFilterProxyModel::getPausedTransfers() const
 {
-    return mPausedTransfers.size();
+    return getCounters().paused;
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllPaused() const
 {
-    return mPausedTransfers.size() == mActiveTransfers.size();
+    auto counters(getCounters());
+    return counters.paused == counters.active;
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyCancellable() const
@@ -603,57 +474,62 @@ bool TransfersManagerSortFilterProxyModel::isAnyCancellable() const
 
 bool TransfersManagerSortFilterProxyModel::areAllCancellable() const
 {
-    return (mActiveTransfers.size() > 0 ||  mFailedTransfers.size() > 0) && (mPausedTransfers.isEmpty() && mCompletedTransfers.isEmpty());
+    auto counters(getCounters());
+    return (counters.active > 0 || counters.failed > 0) && (counters.paused == 0 && counters.completed == 0);
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllSync() const
 {
-    return !isEmpty() && mNoSyncTransfers.isEmpty();
+    return !isEmpty() && getCounters().noSync == 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnySync() const
 {
-    return mNoSyncTransfers.size() != transfersCount();
+    return getCounters().noSync != transfersCount();
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllCompleted() const
 {
-    return mCompletedTransfers.size() > 0 && (mPausedTransfers.isEmpty() && mActiveTransfers.isEmpty() && mFailedTransfers.isEmpty());
+    auto counters(getCounters());
+    return counters.completed > 0 && (counters.paused == 0 && counters.active == 0 && counters.failed == 0);
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyCompleted() const
 {
-    return !mCompletedTransfers.isEmpty();
+    return getCounters().completed > 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyActive() const
 {
-    return !mActiveTransfers.isEmpty();
+    return getCounters().active > 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyFailed() const
 {
-    return !mFailedTransfers.isEmpty();
+    return getCounters().failed > 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllFailsPermanent() const
 {
-    return mFailedTransfers.size() == mPermanentFailedTransfers.size();
+    auto counters(getCounters());
+    return counters.failed == counters.permanentFailed;
 }
 
 bool TransfersManagerSortFilterProxyModel::isEmpty() const
 {
-    return mCompletedTransfers.isEmpty() && mPausedTransfers.isEmpty() && mActiveTransfers.isEmpty() && mFailedTransfers.isEmpty() && mCompletingTransfers.isEmpty();
+    auto counters(getCounters());
+    return counters.completed == 0 && counters.paused == 0 && counters.active == 0 && counters.failed == 0 && counters.completing == 0;
 }
 
 int TransfersManagerSortFilterProxyModel::transfersCount() const
 {
-    return mCompletedTransfers.size() + mActiveTransfers.size() + mFailedTransfers.size() + mCompletingTransfers.size();
+    auto counters(getCounters());
+    return counters.completed + counters.active + counters.failed + counters.completing;
 }
 
 int TransfersManagerSortFilterProxyModel::activeTransfers() const
 {
-    return mActiveTransfers.size();
+    return getCounters().active;
 }
 
 bool TransfersManagerSortFilterProxyModel::isModelProcessing() const
@@ -2,7 +2,9 @@
 #define TRANSFERSSORTFILTERPROXYMODEL_H
 
 #include "TransferItem.h"
+#include "TransfersSortFilterEngine.h"
 #include "TransfersSortFilterProxyBaseModel.h"
+#include "TransfersStateCounters.h"
 
 #include <QFutureWatcher>
 #include <QMutex>
@@ -96,18 +98,8 @@ protected:
         SortCriterion mSortCriterion;
         Qt::SortOrder mSortOrder;
 
-        mutable QSet<int> mDlNumber;
-        mutable QSet<int> mUlNumber;
-        mutable QSet<int> mNoSyncTransfers;
-        mutable QSet<int> mActiveTransfers;
-        mutable QSet<int> mPausedTransfers;
-        mutable QSet<int> mCompletedTransfers;
-        mutable QSet<int> mCompletingTransfers;
-        mutable QSet<int> mFailedTransfers;
-        mutable QSet<int> mPermanentFailedTransfers;
-
 private slots:
-        void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+        void onRowsRemoved(const QModelIndex& parent, int first, int last);
         void onModelSortedFiltered();
 
 private:
@@ -116,23 +108,16 @@ private:
         QString mFilterText;
         mutable QPointer<QMimeData> mInternalMoveMimeData;
         QPointer<TransferWidgetColumnsManager> mColumnManager;
+        TransfersSortFilterEngine mSortFilterEngine;
 
-        void removeActiveTransferFromCounter(TransferTag tag) const;
-        void removePausedTransferFromCounter(TransferTag tag) const;
-        void removeNonSyncedTransferFromCounter(TransferTag tag) const;
-        void removeCompletedTransferFromCounter(TransferTag tag) const;
-        void removeFailedTransferFromCounter(TransferTag tag) const;
-        void removeCompletingTransferFromCounter(TransferTag tag) const;
-        bool updateTransfersCounterFromTag(QExplicitlySharedDataPointer<TransferData> transfer) const;
+        TransfersStateCounters::Counters getCounters() const;
 
+        void runSortFilterEngine();
         void startProcessingInOtherThread();
         void finishProcessingInOtherThread();
         void blockMutexesAndSignals(bool value);
 
         void invalidateModel();
-
-        void resetAllCounters();
-        void resetTransfersStateCounters();
 };
 
 #endif // TRANSFERSSORTFILTERPROXYMODEL_H
@@ -13,6 +13,7 @@
 #include "ThreadPool.h"
 #include "TransferItem.h"
 #include "TransferMetaData.h"
+#include "TransferStringPool.h"
 #include "Utilities.h"
 #include <MessageDialogOpener.h>
 
@@ -26,6 +27,7 @@ using namespace mega;
 static const QModelIndex DEFAULT_IDX = QModelIndex();
 
 const int MAX_TRANSFERS = 2000;
+const size_t EVENTS_RING_SIZE = 1 << 15;
 const int CANCEL_THRESHOLD_THREAD = 100;
 const int QUICK_CANCEL_THRESHOLD = 10000;
 const int QUICK_CANCEL_MIN_THRESHOLD = 300;
@@ -35,8 +37,53 @@ const int FAILED_THRESHOLD_THREAD = 100;
 const int PAUSE_RESUME_THRESHOLD_THREAD = 300;
 const int CLEAR_THRESHOLD_THREAD = 300;
 
+namespace
+{
+//TransferData members before the string pool and the retry info, only used by the memory report
+struct LegacyTransferData : public QSharedData
+{
+    TransferData::TransferTypes         mType;
+    int                                 mErrorCode;
+    int                                 mTag;
+    int                                 mFolderTransferTag;
+    long long                           mErrorValue;
+    bool                                mTemporaryError;
+    int64_t                             mRemainingTime;
+    long long                           mTotalSize;
+    unsigned long long                  mPriority;
+    long long                           mSpeed;
+    unsigned long long                  mMeanSpeed;
+    long long                           mTransferredBytes;
+    long long                           mNotificationNumber;
+    Utilities::FileType                 mFileType;
+    mega::MegaHandle                    mParentHandle;
+    mega::MegaHandle                    mNodeHandle;
+    std::shared_ptr<mega::MegaTransfer> mFailedTransfer;
+    QString                             mFilename;
+    int                                 mNodeAccess;
+    bool                                mIsTempTransfer;
+    QString                             mPath;
+    QDateTime                           mFinishedTime;
+    TransferData::TransferState         mState;
+    TransferData::TransferState         mPreviousState;
+    bool                                mIgnorePauseQueueState;
+};
+
+qint64 utf8Bytes(const QString& value)
+{
+    return value.isNull() ? 0 : value.toUtf8().size() + 1;
+}
+}
+
 //LISTENER THREAD
-TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS)
+TransferThread::TransferThread():
+    mEvents(EVENTS_RING_SIZE),
+    mOverflowing(false),
+    mReceivedEvents(0),
+    mCoalescedEvents(0),
+    mDroppedEvents(0),
+    mLastDroppedEventsLogged(0),
+    mMaxTransfersToProcess(MAX_TRANSFERS)
 {
     mDelegateListener = std::make_unique<QTMegaTransferListener>(MegaSyncApp->getMegaApi(), this);
     MegaSyncApp->getMegaApi()->addTransferListener(mDelegateListener.get());
@@ -44,29 +91,36 @@ TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS)
 
 TransferThread::TransfersToProcess TransferThread::processTransfers()
 {
+   drainEvents();
+
    TransfersToProcess transfers;
-   if(mCacheMutex.tryLock())
-   {
-       int spaceForTransfers(mMaxTransfersToProcess);
+   int spaceForTransfers(mMaxTransfersToProcess);
 
-       transfers.canceledTransfersByTag = extractFromCache(mTransfersToProcess.canceledTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.canceledTransfersByTag.size();
+   transfers.canceledTransfersByTag = extractFromCache(mTransfersToProcess.canceledTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.canceledTransfersByTag.size();
 
-       transfers.failedFolderTransfersByTag = extractFromCache(mTransfersToProcess.failedFolderTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.failedFolderTransfersByTag.size();
+   transfers.failedFolderTransfersByTag = extractFromCache(mTransfersToProcess.failedFolderTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.failedFolderTransfersByTag.size();
 
-       transfers.failedTransfersByTag = extractFromCache(mTransfersToProcess.failedTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.failedTransfersByTag.size();
+   transfers.failedTransfersByTag = extractFromCache(mTransfersToProcess.failedTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.failedTransfersByTag.size();
 
-       transfers.startTransfersByTag = extractFromCache(mTransfersToProcess.startTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.startTransfersByTag.size();
+   transfers.startTransfersByTag = extractFromCache(mTransfersToProcess.startTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.startTransfersByTag.size();
 
-       transfers.startSyncTransfersByTag = extractFromCache(mTransfersToProcess.startSyncTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.startSyncTransfersByTag.size();
+   transfers.startSyncTransfersByTag = extractFromCache(mTransfersToProcess.startSyncTransfersByTag, spaceForTransfers);
+   spaceForTransfers -= transfers.startSyncTransfersByTag.size();
 
-       transfers.updateTransfersByTag = extractFromCache(mTransfersToProcess.updateTransfersByTag, spaceForTransfers);
+   transfers.updateTransfersByTag = extractFromCache(mTransfersToProcess.updateTransfersByTag, spaceForTransfers);
 
-       mCacheMutex.unlock();
+   auto droppedEvents(mDroppedEvents.load());
+   if(droppedEvents != mLastDroppedEventsLogged)
+   {
+       mLastDroppedEventsLogged = droppedEvents;
+       auto stats(getEventsStats());
+       QString message = QString::fromUtf8("Transfer events ring full. Received: %1, coalesced: %2, dropped: %3")
+                             .arg(stats.received).arg(stats.coalesced).arg(stats.dropped);
+       mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_DEBUG, message.toUtf8().constData());
    }
 
    return transfers;
@@ -74,13 +128,138 @@ TransferThread::TransfersToProcess TransferThread::processTransfers()
 
 void TransferThread::clear()
 {
-    QMutexLocker lock(&mCacheMutex);
-
+    //Discard the events received so far
+    drainEvents();
     mTransfersToProcess.clear();
+
+    QMutexLocker lock(&mCountersMutex);
     mTransfersCount.clear();
     mLastTransfersCount.clear();
 }
 
+TransferThread::EventsStats TransferThread::getEventsStats() const
+{
+    EventsStats stats;
+    stats.received = mReceivedEvents;
+    stats.coalesced = mCoalescedEvents;
+    stats.dropped = mDroppedEvents;
+    return stats;
+}
+
+void TransferThread::pushEvent(EventBucket bucket, MegaTransfer* transfer,
+                               QExplicitlySharedDataPointer<TransferData> data, bool droppable)
+{
+    TransferEvent event;
+    event.bucket = bucket;
+    event.sdkState = transfer->getState();
+    event.droppable = droppable;
+    event.data = data;
+
+    mReceivedEvents++;
+
+    if(!mOverflowing.load(std::memory_order_acquire) && mEvents.tryPush(std::move(event)))
+    {
+        return;
+    }
+
+    if(droppable)
+    {
+        mDroppedEvents++;
+        return;
+    }
+
+    QMutexLocker lock(&mOverflowMutex);
+    mOverflowEvents.append(event);
+    mOverflowing.store(true, std::memory_order_release);
+}
+
+void TransferThread::drainEvents()
+{
+    TransferEvent event;
+    while(mEvents.tryPop(event))
+    {
+        coalesceEvent(event);
+    }
+
+    if(mOverflowing.load(std::memory_order_acquire))
+    {
+        QList<TransferEvent> overflowEvents;
+        {
+            QMutexLocker lock(&mOverflowMutex);
+            overflowEvents.swap(mOverflowEvents);
+            mOverflowing.store(false, std::memory_order_release);
+        }
+
+        for(const auto& overflowEvent : qAsConst(overflowEvents))
+        {
+            coalesceEvent(overflowEvent);
+        }
+    }
+}
+
+void TransferThread::coalesceEvent(const TransferEvent& event)
+{
+    auto result = checkIfRepeatedAndSubstituteInStartTransfers(mTransfersToProcess.startTransfersByTag, event);
+
+    if(!result)
+    {
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.startSyncTransfersByTag, event);
+    }
+
+    if(!result)
+    {
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.canceledTransfersByTag, event);
+    }
+
+    if(!result)
+    {
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedFolderTransfersByTag, event);
+    }
+
+    if(!result)
+    {
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedTransfersByTag, event);
+    }
+
+    if(!result)
+    {
+        result = checkIfRepeatedAndRemove(mTransfersToProcess.updateTransfersByTag, event);
+    }
+
+    if(result)
+    {
+        if(!result->mRetryInfo)
+        {
+            result->mRetryInfo = event.data->mRetryInfo;
+        }
+        result->mIsTempTransfer = event.data->mIsTempTransfer;
+    }
+    else
+    {
+        cacheByBucket(event.bucket).insert(event.data->mTag, event.data);
+    }
+}
+
+QMap<TransferTag, QExplicitlySharedDataPointer<TransferData>>& TransferThread::cacheByBucket(EventBucket bucket)
+{
+    switch(bucket)
+    {
+        case EventBucket::START:
+            return mTransfersToProcess.startTransfersByTag;
+        case EventBucket::START_SYNC:
+            return mTransfersToProcess.startSyncTransfersByTag;
+        case EventBucket::CANCELED:
+            return mTransfersToProcess.canceledTransfersByTag;
+        case EventBucket::FAILED_FOLDER:
+            return mTransfersToProcess.failedFolderTransfersByTag;
+        case EventBucket::FAILED:
+            return mTransfersToProcess.failedTransfersByTag;
+        case EventBucket::UPDATE:
+        default:
+            return mTransfersToProcess.updateTransfersByTag;
+    }
+}
+
 QList<QExplicitlySharedDataPointer<TransferData>> TransferThread::extractFromCache(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, int spaceForTransfers)
 {
     if(!dataMap.isEmpty() && spaceForTransfers > 0)
@@ -88,15 +267,18 @@ QList<QExplicitlySharedDataPointer<TransferData>> TransferThread::extractFromCac
         if(dataMap.size() > spaceForTransfers)
         {
             QList<QExplicitlySharedDataPointer<TransferData>> auxList;
+            auxList.reserve(spaceForTransfers);
+
+            //Erasing from the beginning avoids looking up every key again
+            auto it = dataMap.begin();
             for(auto index = 0; index < spaceForTransfers
-                && !dataMap.isEmpty(); ++index)
+                && it != dataMap.end(); ++index)
             {
-                auto& firstItem = dataMap.first();
-                if(firstItem)
+                if(it.value())
                 {
-                    auxList.append(firstItem);
-                    dataMap.take(firstItem->mTag);
+                    auxList.append(it.value());
                 }
+                it = dataMap.erase(it);
             }
 
             return auxList;
@@ -113,114 +295,87 @@ QList<QExplicitlySharedDataPointer<TransferData>> TransferThread::extractFromCac
     return QList<QExplicitlySharedDataPointer<TransferData>>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::createData(MegaTransfer *transfer, MegaError* e)
+QExplicitlySharedDataPointer<TransferData> TransferThread::createData(MegaTransfer *transfer, MegaError* e, bool poolStrings)
 {
-    QExplicitlySharedDataPointer<TransferData> d (new TransferData(transfer));
+    QExplicitlySharedDataPointer<TransferData> d (new TransferData(transfer, poolStrings));
     updateFailedTransfer(d, transfer, e);
 
     return d;
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const TransferEvent& event)
 {
-    if(dataMap.contains(transfer->getTag()))
+    auto tag(event.data->mTag);
+    auto it = dataMap.find(tag);
+    if(it != dataMap.end())
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(transfer->getState() == mega::MegaTransfer::STATE_CANCELLED)
+        mCoalescedEvents++;
+
+        if(event.sdkState == mega::MegaTransfer::STATE_CANCELLED)
         {
-            dataMap.remove(transfer->getTag());
+            dataMap.erase(it);
             return QExplicitlySharedDataPointer<TransferData>();
         }
 
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        if(it.value()->mNotificationNumber < event.data->mNotificationNumber)
         {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
+            //The start data has the pooled strings
+            event.data->sharePooledStrings(it.value().constData());
+            it.value() = event.data;
         }
 
-        return item;
+        return it.value();
     }
 
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const TransferEvent& event)
 {
-    if(dataMap.contains(transfer->getTag()))
+    auto it = dataMap.find(event.data->mTag);
+    if(it != dataMap.end())
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        mCoalescedEvents++;
+
+        if(it.value()->mNotificationNumber < event.data->mNotificationNumber)
         {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
+            it.value() = event.data;
         }
 
-        return item;
+        return it.value();
     }
 
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const TransferEvent& event)
 {
-    if(dataMap.contains(transfer->getTag()))
+    auto it = dataMap.find(event.data->mTag);
+    if(it != dataMap.end())
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        mCoalescedEvents++;
+
+        if(it.value()->mNotificationNumber < event.data->mNotificationNumber)
         {
-            dataMap.remove(transfer->getTag());
+            dataMap.erase(it);
             return QExplicitlySharedDataPointer<TransferData>();
         }
 
-        return item;
+        return it.value();
     }
 
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::onTransferEvent(MegaTransfer *transfer, mega::MegaError* e)
-{
-    auto result = checkIfRepeatedAndSubstituteInStartTransfers(mTransfersToProcess.startTransfersByTag, transfer);
-
-    if(!result)
-    {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.startSyncTransfersByTag, transfer);
-    }
-
-    if(!result)
-    {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.canceledTransfersByTag, transfer);
-    }
-
-    if(!result)
-    {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedFolderTransfersByTag, transfer);
-    }
-
-    if(!result)
-    {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedTransfersByTag, transfer);
-    }
-
-    if(!result)
-    {
-        result = checkIfRepeatedAndRemove(mTransfersToProcess.updateTransfersByTag, transfer);
-    }
-
-    updateFailedTransfer(result, transfer, e);
-
-    return result;
-}
-
 void TransferThread::updateFailedTransfer(QExplicitlySharedDataPointer<TransferData> data,
                                           mega::MegaTransfer *transfer,
                                           mega::MegaError *e)
 {
     if(transfer->getState() == MegaTransfer::STATE_FAILED || (e && e->getErrorCode() != mega::MegaError::API_OK))
     {
-        if(data && !data->mFailedTransfer)
+        if(data && !data->mRetryInfo)
         {
-            data->mFailedTransfer = std::shared_ptr<mega::MegaTransfer>(transfer->copy());
+            data->mRetryInfo = std::make_shared<TransferRetryInfo>(transfer);
         }
     }
 }
@@ -279,26 +434,14 @@ void TransferThread::onTransferStart(MegaApi *, MegaTransfer *transfer)
             }
 
             {
-                QMutexLocker cacheLock(&mCacheMutex);
-                auto data = onTransferEvent(transfer,  nullptr);
-
-                if(!data)
-                {
-                    data = createData(transfer, nullptr);
+                //Only the start interns the strings, the later events share them in the model
+                auto data = createData(transfer, nullptr, true);
+                data->mIsTempTransfer = isTemp;
 
-                    trackTransfer(data);
+                trackTransfer(data);
 
-                    if(transfer->isSyncTransfer())
-                    {
-                        mTransfersToProcess.startSyncTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else
-                    {
-                        mTransfersToProcess.startTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                }
-
-                data->mIsTempTransfer = isTemp;
+                pushEvent(transfer->isSyncTransfer() ? EventBucket::START_SYNC : EventBucket::START,
+                          transfer, data, false);
             }
         }
 
@@ -330,17 +473,7 @@ void TransferThread::onTransferUpdate(MegaApi *, MegaTransfer *transfer)
             }
         }
 
-        {
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, nullptr);
-
-            if(!data)
-            {
-                data =  createData(transfer, nullptr);
-
-                mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-            }
-        }
+        pushEvent(EventBucket::UPDATE, transfer, createData(transfer, nullptr), true);
     }
 }
 
@@ -480,44 +613,37 @@ void TransferThread::onTransferFinish(MegaApi* megaApi, MegaTransfer *transfer,
                 return;
             }
 
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, e);
+            auto data = createData(transfer, e);
+            data->mIsTempTransfer = isTemp;
 
-            if(!data)
-            {
-                data =  createData(transfer, e);
+            trackTransfer(data);
 
-                if(transfer->isFolderTransfer())
+            if(transfer->isFolderTransfer())
+            {
+                if(transfer->getState() == MegaTransfer::STATE_FAILED
+                        || e->getErrorCode() != mega::MegaError::API_OK)
                 {
-                    if(transfer->getState() == MegaTransfer::STATE_FAILED
-                            || e->getErrorCode() != mega::MegaError::API_OK)
-                    {
-                        //In some scenarios, the error code can be different to API_OK but the state is not failed
-                        data->setState(TransferData::TRANSFER_FAILED);
-                        mTransfersToProcess.failedFolderTransfersByTag.insert(transfer->getTag(), data);
-                    }
+                    //In some scenarios, the error code can be different to API_OK but the state is not failed
+                    data->setState(TransferData::TRANSFER_FAILED);
+                    pushEvent(EventBucket::FAILED_FOLDER, transfer, data, false);
+                }
+            }
+            else
+            {
+                if(transfer->getState() == MegaTransfer::STATE_CANCELLED)
+                {
+                    pushEvent(EventBucket::CANCELED, transfer, data, false);
+                }
+                else if(transfer->getState() == MegaTransfer::STATE_FAILED
+                        || e->getErrorCode() != mega::MegaError::API_OK)
+                {
+                    pushEvent(EventBucket::FAILED, transfer, data, false);
                 }
                 else
                 {
-                    if(transfer->getState() == MegaTransfer::STATE_CANCELLED)
-                    {
-                        mTransfersToProcess.canceledTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else if(transfer->getState() == MegaTransfer::STATE_FAILED
-                            || e->getErrorCode() != mega::MegaError::API_OK)
-                    {
-                        mTransfersToProcess.failedTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else
-                    {
-                        mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-                    }
+                    pushEvent(EventBucket::UPDATE, transfer, data, false);
                 }
             }
-
-            trackTransfer(data);
-
-            data->mIsTempTransfer = isTemp;
         }
     }
 }
@@ -549,17 +675,10 @@ void TransferThread::onTransferTemporaryError(MegaApi*, MegaTransfer *transfer,
             }
         }
 
-        {
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, nullptr);
-            if(!data)
-            {
-                data =  createData(transfer, e);
+        auto data = createData(transfer, e);
+        data->mTemporaryError = true;
 
-                mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-                data->mTemporaryError = true;
-            }
-        }
+        pushEvent(EventBucket::UPDATE, transfer, data, true);
     }
 }
 
@@ -1306,15 +1425,26 @@ void TransfersModel::startTransfer(QExplicitlySharedDataPointer<TransferData> tr
         //Otherwise when filtering there will be wrong result
         transfer->setPreviousState(TransferData::TRANSFER_NONE);
     }
+
+    mStateCounters.addTransfer(transfer);
 }
 
 void TransfersModel::updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row)
 {
     checkActiveTransfer(transfer->mTag, transfer->isActive());
 
+    //Only this thread replaces the rows, so the previous data can be read without the lock
+    transfer->sharePooledStrings(mTransfers.at(row).constData());
+
     mDataMutex.lockForWrite();
     mTransfers[row] = transfer;
     mDataMutex.unlock();
+
+    //Progress updates do not move the transfer to another counter
+    if(transfer->stateHasChanged())
+    {
+        mStateCounters.updateTransfer(transfer);
+    }
 }
 
 void TransfersModel::processUpdateTransfers()
@@ -1340,6 +1470,8 @@ void TransfersModel::processUpdateTransfers()
 
 void TransfersModel::processFailedTransfers()
 {
+    auto failedTransfers(mTransfersToProcess.failedTransfersByTag.size());
+
     for (auto it = mTransfersToProcess.failedTransfersByTag.begin(); it != mTransfersToProcess.failedTransfersByTag.end();)
     {
         TransferTag tag ((*it)->mTag);
@@ -1367,6 +1499,12 @@ void TransfersModel::processFailedTransfers()
 
         mTransfersToProcess.failedTransfersByTag.erase(it++);
     }
+
+    //Big batches of failed transfers are the ones that make the model grow
+    if(failedTransfers > FAILED_THRESHOLD_THREAD)
+    {
+        logMemoryReport();
+    }
 }
 
 void TransfersModel::cacheCancelTransfersTags()
@@ -1401,7 +1539,7 @@ void TransfersModel::processCancelTransfers()
         double cancelledPercentage(indexesToCancel.size()*1.0);
         cancelledPercentage = cancelledPercentage/rowCount();
 
-        //For large amount of transfers, this is quite faster: remove all transfers and recreate the tags by row map
+        //For large amount of transfers, this is quite faster: remove all transfers and refresh the tags index once
         if(indexesToCancel.size() >= QUICK_CANCEL_THRESHOLD
                 || (indexesToCancel.size() >  QUICK_CANCEL_MIN_THRESHOLD && cancelledPercentage > QUICK_CANCEL_PERCENTAGE_THRESHOLD))
         {
@@ -1409,12 +1547,20 @@ void TransfersModel::processCancelTransfers()
                 return check1.row() > check2.row();
             });
 
+            mDataMutex.lockForWrite();
+            mTagIndex.beginBatch();
+            mDataMutex.unlock();
+
             foreach(auto& index, indexesToCancel)
             {
                 removeTransfer(index.row());
             }
 
-            restoreTagsByRow();
+            mDataMutex.lockForWrite();
+            mTagIndex.endBatch();
+            mDataMutex.unlock();
+
+            TransferStringPool::instance().purge();
         }
         else
         {
@@ -1625,21 +1771,25 @@ void TransfersModel::retryTransfers(const QMultiMap<unsigned long long, QExplici
                     {
                         continue;
                     }
-                    auto failedTransfer = failedTransferdata->mFailedTransfer;
+                    auto retryInfo = failedTransferdata->mRetryInfo;
+                    if (!retryInfo)
+                    {
+                        continue;
+                    }
 
                     std::shared_ptr<TransferMetaData> data(nullptr);
 
-                    auto transferAppData(failedTransfer->getAppData());
+                    auto transferAppData(retryInfo->getAppData());
                     if (transferAppData != appDataRaw)
                     {
                         auto oldAppDataId =
-                            TransferMetaDataContainer::appDataToId(failedTransfer->getAppData());
+                            TransferMetaDataContainer::appDataToId(retryInfo->getAppData());
                         if (oldAppDataId.first)
                         {
                             data = TransferMetaDataContainer::getAppDataById(oldAppDataId.second);
                             if (data)
                             {
-                                TransferMetaDataContainer::retryTransfer(failedTransfer.get(),
+                                TransferMetaDataContainer::retryTransfer(failedTransferdata,
                                                                          oldAppDataId.second);
                             }
                         }
@@ -1649,34 +1799,37 @@ void TransfersModel::retryTransfers(const QMultiMap<unsigned long long, QExplici
                     // When retrying, the appDataId is a new one
                     if (!data)
                     {
-                        if (failedTransfer->getType() == mega::MegaTransfer::TYPE_UPLOAD)
+                        if (failedTransferdata->isUpload())
                         {
                             data = TransferMetaDataContainer::createTransferMetaDataWithappDataId<
-                                UploadTransferMetaData>(appData, failedTransfer->getParentHandle());
+                                UploadTransferMetaData>(appData, failedTransferdata->mParentHandle);
                         }
                         else
                         {
                             data = TransferMetaDataContainer::createTransferMetaDataWithappDataId<
                                 DownloadTransferMetaData>(
                                 appData,
-                                QString::fromUtf8(failedTransfer->getParentPath()));
+                                retryInfo->mParentPath);
                         }
 
                         data->setInitialTransfers(transferDatas.size());
                     }
                     else
                     {
-                        TransferMetaDataContainer::retryTransfer(failedTransfer.get(), appData);
+                        TransferMetaDataContainer::retryTransfer(failedTransferdata, appData);
                     }
 
-                    if (failedTransfer->getType() == MegaTransfer::TYPE_DOWNLOAD)
+                    auto localPath(failedTransferdata->getRawPath().toUtf8());
+                    auto fileName(failedTransferdata->mFilename.toUtf8());
+
+                    if (failedTransferdata->mType & TransferData::TRANSFER_DOWNLOAD)
                     {
                         std::unique_ptr<mega::MegaNode> node = failedTransferdata->getNode();
                         // If node is null, then it was intended to be undeleted
                         bool undelete = (!node);
                         mMegaApi->startDownload(node.get(),
-                                                failedTransfer->getPath(),
-                                                failedTransfer->getFileName(),
+                                                localPath.constData(),
+                                                fileName.constData(),
                                                 appDataRaw,
                                                 false,
                                                 nullptr,
@@ -1689,13 +1842,13 @@ void TransfersModel::retryTransfers(const QMultiMap<unsigned long long, QExplici
                     {
                         std::unique_ptr<mega::MegaNode> parentNode(
                             MegaSyncApp->getMegaApi()->getNodeByHandle(
-                                failedTransfer->getParentHandle()));
+                                failedTransferdata->mParentHandle));
                         MegaUploadOptions options;
-                        options.fileName = failedTransfer->getFileName();
+                        options.fileName = fileName.constData();
                         options.appData = appDataRaw;
                         options.pitagTrigger = mega::MegaApi::PITAG_TRIGGER_PICKER;
 
-                        mMegaApi->startUpload(failedTransfer->getPath(),
+                        mMegaApi->startUpload(localPath.constData(),
                                               parentNode.get(),
                                               nullptr,
                                               &options,
@@ -1722,14 +1875,13 @@ void TransfersModel::retryTransferByIndex(const QModelIndex& index)
     const auto transferItem(qvariant_cast<TransferItem>(index.data(Qt::DisplayRole)));
     auto d(transferItem.getTransferData());
 
-    if (d && d->mFailedTransfer && d->canBeRetried())
+    if (d && d->canBeRetried())
     {
         QMultiMap<unsigned long long, QExplicitlySharedDataPointer<TransferData>> transfersToRetry;
-        auto copiedTransfer = std::shared_ptr<mega::MegaTransfer>(d->mFailedTransfer->copy());
 
         unsigned long long appData(0);
 
-        auto data = TransferMetaDataContainer::getAppData(copiedTransfer.get());
+        auto data = TransferMetaDataContainer::getAppData(d);
         if (data)
         {
             appData = data->getAppId();
@@ -1792,14 +1944,12 @@ void TransfersModel::retryTransfers(QModelIndexList indexes, unsigned long long
         {
             canBeRetriedIndexes.append(index);
 
-            auto copiedTransfer = std::shared_ptr<mega::MegaTransfer>(d->mFailedTransfer->copy());
-
             if(d->isUpload())
             {
                 unsigned long long appDataId(newAppDataIdUpload);
                 if(appDataId == 0)
                 {
-                    auto appData = TransferMetaDataContainer::getAppData(copiedTransfer.get());
+                    auto appData = TransferMetaDataContainer::getAppData(d);
                     if(appData)
                     {
                         appDataId = appData->getAppId();
@@ -1823,7 +1973,7 @@ void TransfersModel::retryTransfers(QModelIndexList indexes, unsigned long long
 
                 if(appDataId == 0)
                 {
-                    auto appData = TransferMetaDataContainer::getAppData(copiedTransfer.get());
+                    auto appData = TransferMetaDataContainer::getAppData(d);
                     if(appData)
                     {
                         appDataId = appData->getAppId();
@@ -1879,7 +2029,7 @@ void TransfersModel::retryTransfersByAppDataId(const std::shared_ptr<TransferMet
         }
         else
         {
-           failedFilesToRetryOutOfTheModel.insert(data->getAppId(), getTransferByTag(item->failedTransfer->getTag()));
+           failedFilesToRetryOutOfTheModel.insert(data->getAppId(), getTransferByTag(item->id.tag));
         }
     }
 
@@ -2388,6 +2538,11 @@ void TransfersModel::pauseResumeTransferByTag(TransferTag tag, bool pauseState)
             d->setPauseResume(false);
         }
 
+        if(d->stateHasChanged())
+        {
+            mStateCounters.updateTransfer(d);
+        }
+
         sendDataChanged(row);
         d->resetStateHasChanged();
         mMegaApi->pauseTransferByTag(d->mTag, pauseState);
@@ -2467,6 +2622,11 @@ void TransfersModel::removeRows(QModelIndexList& indexesToRemove)
         return check1.row() > check2.row();
     });
 
+    // Shifted rows are refreshed in the tags index only once, when all the blocks are removed
+    mDataMutex.lockForWrite();
+    mTagIndex.beginBatch();
+    mDataMutex.unlock();
+
     // First clear finished transfers (remove rows), then cancel the others.
     // This way, there is no risk of messing up the rows order with cancel requests.
     int count (0);
@@ -2500,6 +2660,13 @@ void TransfersModel::removeRows(QModelIndexList& indexesToRemove)
     {
         removeRows(row, count, DEFAULT_IDX);
     }
+
+    mDataMutex.lockForWrite();
+    mTagIndex.endBatch();
+    mDataMutex.unlock();
+
+    //Release the names and folders only used by the removed transfers
+    TransferStringPool::instance().purge();
 }
 
 QExplicitlySharedDataPointer<TransferData> TransfersModel::getTransfer(int row) const
@@ -2528,7 +2695,10 @@ QExplicitlySharedDataPointer<TransferData> TransfersModel::getTransferByTag(int
 
 int TransfersModel::getRowByTransferTag(int tag) const
 {
-    auto result = mTagByOrder.contains(tag) ? mTagByOrder.value(tag).row() : -1;
+    mDataMutex.lockForRead();
+    auto result = mTagIndex.row(tag);
+    mDataMutex.unlock();
+
     return result;
 }
 
@@ -2536,18 +2706,27 @@ void TransfersModel::addTransfer(QExplicitlySharedDataPointer<TransferData> tran
 {
     mDataMutex.lockForWrite();
     mTransfers.append(transfer);
+    mTagIndex.append(transfer->mTag);
     mDataMutex.unlock();
-
-    mTagByOrder.insert(transfer->mTag, QPersistentModelIndex(index(rowCount(DEFAULT_IDX) - 1,0)));
 }
 
 void TransfersModel::removeTransfer(int row)
+{
+    removeTransfers(row, 1);
+}
+
+void TransfersModel::removeTransfers(int row, int count)
 {
     mDataMutex.lockForWrite();
-    if(row >= 0  && row < mTransfers.size())
+    if(row >= 0 && count > 0 && row < mTransfers.size())
     {
-        auto transfer = mTransfers.takeAt(row);
-        mTagByOrder.remove(transfer->mTag);
+        count = std::min(count, mTransfers.size() - row);
+        for(auto it = mTransfers.cbegin() + row; it != mTransfers.cbegin() + row + count; ++it)
+        {
+            mStateCounters.removeTransfer((*it)->mTag);
+        }
+        mTransfers.erase(mTransfers.begin() + row, mTransfers.begin() + row + count);
+        mTagIndex.removeRows(row, count);
     }
     mDataMutex.unlock();
 }
@@ -2569,25 +2748,74 @@ void TransfersModel::sendDataChanged(int row)
     }
 }
 
-void TransfersModel::restoreTagsByRow()
+QList<QExplicitlySharedDataPointer<TransferData> > TransfersModel::getTransfersToIterate() const
 {
-    mTagByOrder.clear();
-    for(int row = 0; row < rowCount(); ++row)
+    mDataMutex.lockForRead();
+    auto transfers = mTransfers;
+    mDataMutex.unlock();
+    return transfers;
+}
+
+TransfersStateCounters& TransfersModel::getStateCounters()
+{
+    return mStateCounters;
+}
+
+TransfersModel::MemoryReport TransfersModel::getMemoryReport() const
+{
+    MemoryReport report;
+
+    auto& stringPool(TransferStringPool::instance());
+    report.pooledStrings = stringPool.size();
+    report.pooledBytes = stringPool.bytes();
+    report.bytes = report.pooledBytes;
+
+    mDataMutex.lockForRead();
+    report.transfers = mTransfers.size();
+    for(const auto& transfer : qAsConst(mTransfers))
     {
-        auto transfer = getTransfer(row);
-        if(transfer)
+        report.bytes += transfer->bytes();
+
+        //Every transfer owned its name and path
+        auto legacyPath(transfer->getRawPath());
+        report.legacyBytes += sizeof(LegacyTransferData)
+                              + TransferStringPool::stringBytes(transfer->mFilename)
+                              + TransferStringPool::stringBytes(legacyPath);
+
+        if(transfer->mRetryInfo)
         {
-            mTagByOrder.insert(transfer->mTag, QPersistentModelIndex(index(row,0)));
+            report.failedTransfers++;
+            //Strings duplicated by MegaTransfer::copy, plus the shared_ptr control block
+            report.legacyBytes += utf8Bytes(transfer->mFilename)
+                                  + utf8Bytes(legacyPath)
+                                  + utf8Bytes(transfer->mRetryInfo->mParentPath)
+                                  + (transfer->mRetryInfo->getAppData() ? transfer->mRetryInfo->mAppData.size() + 1 : 0)
+                                  + 2 * sizeof(void*) + 2 * sizeof(int);
         }
     }
+    mDataMutex.unlock();
+
+    return report;
 }
 
-QList<QExplicitlySharedDataPointer<TransferData> > TransfersModel::getTransfersToIterate() const
+void TransfersModel::logMemoryReport() const
 {
-    mDataMutex.lockForRead();
-    auto transfers = mTransfers;
-    mDataMutex.unlock();
-    return transfers;
+    auto report(getMemoryReport());
+    if(report.transfers == 0)
+    {
+        return;
+    }
+
+    QString message = QString::fromUtf8("Transfers memory: %1 transfers (%2 failed), %3 bytes per transfer "
+                                        "(%4 bytes per transfer without string pool and retry info). "
+                                        "Pooled strings: %5 (%6 bytes)")
+                          .arg(report.transfers)
+                          .arg(report.failedTransfers)
+                          .arg(report.bytes / report.transfers)
+                          .arg(report.legacyBytes / report.transfers)
+                          .arg(report.pooledStrings)
+                          .arg(report.pooledBytes);
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_DEBUG, message.toUtf8().constData());
 }
 
 bool TransfersModel::isUiBlockedModeActive() const
@@ -2763,14 +2991,15 @@ bool TransfersModel::removeRows(int row, int count, const QModelIndex& parent)
     if (parent == DEFAULT_IDX && count > 0 && row >= 0)
     {
         beginRemoveRows(DEFAULT_IDX, row, row + count - 1);
+        removeTransfers(row, count);
+        endRemoveRows();
 
-        for (auto i (0); i < count; ++i)
+        //Batches purge the pool once, when all their rows are removed
+        if(!mTagIndex.isInBatch())
         {
-            removeTransfer(row);
+            TransferStringPool::instance().purge();
         }
 
-        endRemoveRows();
-
         return true;
     }
     else
@@ -2959,9 +3188,12 @@ void TransfersModel::resetModel()
 
     mDataMutex.lockForWrite();
     mTransfers.clear();
-    mTagByOrder.clear();
+    mTagIndex.clear();
     mDataMutex.unlock();
 
+    mStateCounters.clear();
+    TransferStringPool::instance().purge();
+
     endResetModel();
 }
 
@@ -2,11 +2,14 @@
 #define TRANSFERSMODEL_H
 
 #include "megaapi.h"
+#include "MpscRingBuffer.h"
 #include "Preferences.h"
 #include "QTMegaTransferListener.h"
 #include "TransferItem.h"
 #include "TransferMetaData.h"
 #include "TransferRemainingTime.h"
+#include "TransferTagIndex.h"
+#include "TransfersStateCounters.h"
 #include "TransferTrack.h"
 
 #include <QAbstractItemModel>
@@ -163,6 +166,15 @@ public:
         }
     };
 
+    struct EventsStats
+    {
+        quint64 received = 0;
+        // Events merged into a transfer already waiting to be processed
+        quint64 coalesced = 0;
+        // Progress updates discarded because the events ring was full
+        quint64 dropped = 0;
+    };
+
     TransferThread();
     ~TransferThread(){}
 
@@ -183,6 +195,8 @@ public:
     TransfersToProcess processTransfers();
     void clear();
 
+    EventsStats getEventsStats() const;
+
 public slots:
     void onTransferStart(mega::MegaApi*, mega::MegaTransfer* transfer);
     void onTransferFinish(mega::MegaApi* megaApi, mega::MegaTransfer* transfer, mega::MegaError* e);
@@ -201,12 +215,36 @@ private:
     void trackTransfer(QExplicitlySharedDataPointer<TransferData> data);
     void removeFinishedTracks(const QString& id);
 
-    QExplicitlySharedDataPointer<TransferData> createData(mega::MegaTransfer* transfer, mega::MegaError *e);
-    QExplicitlySharedDataPointer<TransferData> onTransferEvent(mega::MegaTransfer* transfer, mega::MegaError *e);
+    enum class EventBucket
+    {
+        START,
+        START_SYNC,
+        UPDATE,
+        CANCELED,
+        FAILED_FOLDER,
+        FAILED
+    };
+
+    // Compact event sent from the SDK listener callbacks to the model
+    struct TransferEvent
+    {
+        EventBucket bucket = EventBucket::UPDATE;
+        int sdkState = mega::MegaTransfer::STATE_NONE;
+        // Progress updates can be dropped if the ring is full, as a later event supersedes them
+        bool droppable = false;
+        QExplicitlySharedDataPointer<TransferData> data;
+    };
+
+    QExplicitlySharedDataPointer<TransferData> createData(mega::MegaTransfer* transfer, mega::MegaError *e, bool poolStrings = false);
+    void pushEvent(EventBucket bucket, mega::MegaTransfer* transfer,
+                   QExplicitlySharedDataPointer<TransferData> data, bool droppable);
+    void drainEvents();
+    void coalesceEvent(const TransferEvent& event);
+    QMap<TransferTag, QExplicitlySharedDataPointer<TransferData>>& cacheByBucket(EventBucket bucket);
     QList<QExplicitlySharedDataPointer<TransferData>> extractFromCache(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, int spaceForTransfers);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData> > &dataMap, mega::MegaTransfer *transfer);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const TransferEvent& event);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, const TransferEvent& event);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData> > &dataMap, const TransferEvent& event);
 
     struct cacheTransfers
     {
@@ -228,8 +266,21 @@ private:
         }
     };
 
+    // Only touched by the consumer (the thread calling processTransfers)
     cacheTransfers mTransfersToProcess;
-    QMutex mCacheMutex;
+
+    MpscRingBuffer<TransferEvent> mEvents;
+    // Start/finish events cannot be dropped: if the ring is full they wait here, and the following
+    // events too, to keep the order
+    QMutex mOverflowMutex;
+    QList<TransferEvent> mOverflowEvents;
+    std::atomic<bool> mOverflowing;
+
+    std::atomic<quint64> mReceivedEvents;
+    std::atomic<quint64> mCoalescedEvents;
+    std::atomic<quint64> mDroppedEvents;
+    quint64 mLastDroppedEventsLogged;
+
     QMutex mCountersMutex;
     QMutex mTrackTransferMutex;
     TransfersCount mTransfersCount;
@@ -263,6 +314,19 @@ class TransfersModel : public QAbstractItemModel
     Q_OBJECT
 
 public:
+    struct MemoryReport
+    {
+        int transfers = 0;
+        int failedTransfers = 0;
+        // TransferData structs, retry info and the pooled strings
+        qint64 bytes = 0;
+        // The same transfers with owned strings and a MegaTransfer copy per failed transfer (the
+        // SDK private transfer object is not counted, so it is a lower bound)
+        qint64 legacyBytes = 0;
+        int pooledStrings = 0;
+        qint64 pooledBytes = 0;
+    };
+
     explicit TransfersModel();
     ~TransfersModel();
 
@@ -376,6 +440,13 @@ public:
     void showSyncCancelledWarning();
 
     QList<int> getDragAndDropRows(const QMimeData* data);
+    QList<QExplicitlySharedDataPointer<TransferData>> getTransfersToIterate() const;
+
+    TransfersStateCounters& getStateCounters();
+
+    MemoryReport getMemoryReport() const;
+    void logMemoryReport() const;
+
 signals:
     void pauseStateChanged(bool pauseState);
     void transferPauseStateChanged();
@@ -418,9 +489,8 @@ private:
     QExplicitlySharedDataPointer<TransferData> getTransfer(int row) const;
     void addTransfer(QExplicitlySharedDataPointer<TransferData>);
     void removeTransfer(int row);
+    void removeTransfers(int row, int count);
     void sendDataChanged(int row);
-    void restoreTagsByRow();
-    QList<QExplicitlySharedDataPointer<TransferData>> getTransfersToIterate() const;
 
     void moveTransferPriority(const QModelIndexList& sourceIndexes,
                               bool up,
@@ -478,7 +548,8 @@ private:
     int mUiBlockedByCounter;
     uint8_t  mUiBlockedByCounterSafety;
 
-    QHash<TransferTag, QPersistentModelIndex> mTagByOrder;
+    TransferTagIndex mTagIndex;
+    TransfersStateCounters mStateCounters;
     QList<TransferTag> mRowsToCancel;
     QPointer<QWidget> mCancelledFrom;
     bool mSyncsInRowsToCancel;
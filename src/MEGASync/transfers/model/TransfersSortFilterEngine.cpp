@@ -0,0 +1,391 @@
+#include "TransfersSortFilterEngine.h"
+
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace
+{
+// Under this number of rows, the cost of dispatching the chunks is higher than sorting them
+constexpr int MIN_ROWS_BY_SORT_CHUNK = 8192;
+
+struct SortRange
+{
+    std::vector<int>::iterator begin;
+    std::vector<int>::iterator middle;
+    std::vector<int>::iterator end;
+};
+
+template<class Compare>
+void parallelStableSort(std::vector<int>& rows, Compare compare)
+{
+    auto total(static_cast<int>(rows.size()));
+    auto chunks(std::min(QThread::idealThreadCount(), total / MIN_ROWS_BY_SORT_CHUNK));
+    if (chunks <= 1)
+    {
+        std::stable_sort(rows.begin(), rows.end(), compare);
+        return;
+    }
+
+    // Sort every chunk in a different thread...
+    std::vector<int> bounds;
+    for (int chunk = 0; chunk <= chunks; ++chunk)
+    {
+        bounds.push_back(static_cast<int>(static_cast<long long>(total) * chunk / chunks));
+    }
+
+    QVector<SortRange> ranges;
+    for (int chunk = 0; chunk < chunks; ++chunk)
+    {
+        ranges.append({rows.begin() + bounds[chunk], rows.begin(), rows.begin() + bounds[chunk + 1]});
+    }
+    QtConcurrent::blockingMap(ranges,
+                              [&compare](const SortRange& range)
+                              {
+                                  std::stable_sort(range.begin, range.end, compare);
+                              });
+
+    // ...and merge them by pairs, also in parallel
+    for (int width = 1; width < chunks; width *= 2)
+    {
+        QVector<SortRange> merges;
+        for (int first = 0; first + width < chunks; first += 2 * width)
+        {
+            auto last(std::min(first + 2 * width, chunks));
+            merges.append({rows.begin() + bounds[first],
+                           rows.begin() + bounds[first + width],
+                           rows.begin() + bounds[last]});
+        }
+        QtConcurrent::blockingMap(merges,
+                                  [&compare](const SortRange& range)
+                                  {
+                                      std::inplace_merge(range.begin, range.middle, range.end, compare);
+                                  });
+    }
+}
+}
+
+void TransfersSortFilterEngine::Snapshot::reserve(int size)
+{
+    auto columnSize(static_cast<size_t>(size));
+
+    transfers.reserve(size);
+    tags.reserve(columnSize);
+    states.reserve(columnSize);
+    types.reserve(columnSize);
+    fileTypes.reserve(columnSize);
+    flags.reserve(columnSize);
+    sizes.reserve(columnSize);
+    speeds.reserve(columnSize);
+    priorities.reserve(columnSize);
+    remainingTimes.reserve(columnSize);
+    finishedTimes.reserve(columnSize);
+    foldedNames.reserve(columnSize);
+}
+
+TransfersSortFilterEngine::TransfersSortFilterEngine():
+    mFilters{TransferData::STATE_MASK, TransferData::TYPE_MASK, ~Utilities::FileTypes()},
+    mSortCriterion(SortCriterion::PRIORITY),
+    mPredicateDirty(true),
+    mNamesDirty(true),
+    mSortDirty(true),
+    mActive(false)
+{
+}
+
+void TransfersSortFilterEngine::process(const QList<QExplicitlySharedDataPointer<TransferData>>& transfers,
+                                        const Filters& filters,
+                                        const QString& filterText,
+                                        SortCriterion sortCriterion)
+{
+    refreshSnapshot(transfers);
+
+    if (!(filters == mFilters))
+    {
+        mFilters = filters;
+        mPredicateDirty = true;
+    }
+
+    auto foldedFilterText(filterText.toCaseFolded());
+    if (foldedFilterText != mFoldedFilterText)
+    {
+        mFoldedFilterText = foldedFilterText;
+        mNamesDirty = true;
+    }
+
+    if (sortCriterion != mSortCriterion)
+    {
+        mSortCriterion = sortCriterion;
+        mSortDirty = true;
+    }
+
+    if (mPredicateDirty)
+    {
+        runPredicateFilter();
+    }
+
+    if (mNamesDirty)
+    {
+        runNameFilter();
+    }
+
+    if (mSortDirty)
+    {
+        runSort();
+    }
+}
+
+void TransfersSortFilterEngine::clear()
+{
+    mSnapshot = Snapshot();
+    mPredicateAccepted.clear();
+    mNameAccepted.clear();
+    mRanks.clear();
+    mPredicateDirty = true;
+    mNamesDirty = true;
+    mSortDirty = true;
+}
+
+void TransfersSortFilterEngine::setActive(bool state)
+{
+    mActive = state;
+}
+
+bool TransfersSortFilterEngine::isActive() const
+{
+    return mActive;
+}
+
+int TransfersSortFilterEngine::size() const
+{
+    return static_cast<int>(mSnapshot.tags.size());
+}
+
+bool TransfersSortFilterEngine::isAccepted(int row) const
+{
+    return row >= 0 && row < size() && mPredicateAccepted[row] && mNameAccepted[row];
+}
+
+bool TransfersSortFilterEngine::lessThan(int leftRow, int rightRow) const
+{
+    if (leftRow < 0 || rightRow < 0 || leftRow >= size() || rightRow >= size())
+    {
+        return false;
+    }
+
+    return mRanks[leftRow] < mRanks[rightRow];
+}
+
+QExplicitlySharedDataPointer<TransferData> TransfersSortFilterEngine::transferAt(int row) const
+{
+    return (row >= 0 && row < size()) ? mSnapshot.transfers.at(row) :
+                                        QExplicitlySharedDataPointer<TransferData>();
+}
+
+void TransfersSortFilterEngine::refreshSnapshot(const QList<QExplicitlySharedDataPointer<TransferData>>& transfers)
+{
+    Snapshot next;
+    next.reserve(transfers.size());
+
+    // File names never change for a tag, so they are only folded for new transfers
+    std::unordered_map<TransferTag, size_t> previousRowByTag;
+    auto findPreviousName = [this, &previousRowByTag](size_t row, TransferTag tag) -> const QString*
+    {
+        if (row < mSnapshot.tags.size() && mSnapshot.tags[row] == tag)
+        {
+            return &mSnapshot.foldedNames[row];
+        }
+
+        if (previousRowByTag.empty())
+        {
+            previousRowByTag.reserve(mSnapshot.tags.size());
+            for (size_t previousRow = 0; previousRow < mSnapshot.tags.size(); ++previousRow)
+            {
+                previousRowByTag.emplace(mSnapshot.tags[previousRow], previousRow);
+            }
+        }
+
+        auto it(previousRowByTag.find(tag));
+        return it != previousRowByTag.end() ? &mSnapshot.foldedNames[it->second] : nullptr;
+    };
+
+    for (const auto& transfer: transfers)
+    {
+        next.transfers.append(transfer);
+
+        if (!transfer)
+        {
+            next.tags.push_back(-1);
+            next.states.push_back(0);
+            next.types.push_back(0);
+            next.fileTypes.push_back(0);
+            next.flags.push_back(INVALID);
+            next.sizes.push_back(0);
+            next.speeds.push_back(0);
+            next.priorities.push_back(0);
+            next.remainingTimes.push_back(0);
+            next.finishedTimes.push_back(0);
+            next.foldedNames.emplace_back();
+            continue;
+        }
+
+        uint8_t flags(0);
+        if (transfer->mTag < 0)
+        {
+            flags |= INVALID;
+        }
+        if (transfer->isTempTransfer())
+        {
+            flags |= TEMP;
+        }
+        if (transfer->isProcessing())
+        {
+            flags |= PROCESSING;
+        }
+        auto finished(transfer->isFinished());
+        if (finished)
+        {
+            flags |= FINISHED;
+        }
+
+        next.tags.push_back(transfer->mTag);
+        next.states.push_back(static_cast<uint32_t>(transfer->getState()));
+        next.types.push_back(static_cast<uint32_t>(transfer->mType));
+        next.fileTypes.push_back(static_cast<uint32_t>(toInt(transfer->mFileType)));
+        next.flags.push_back(flags);
+        next.sizes.push_back(transfer->mTotalSize);
+        next.speeds.push_back(transfer->mSpeed);
+        next.priorities.push_back(transfer->mPriority);
+        next.remainingTimes.push_back(transfer->mRemainingTime);
+        next.finishedTimes.push_back(finished ? transfer->getFinishedDateTime().toMSecsSinceEpoch() : 0);
+
+        auto previousName(findPreviousName(next.tags.size() - 1, transfer->mTag));
+        next.foldedNames.push_back(previousName ? *previousName :
+                                                  transfer->mFilename.toCaseFolded());
+    }
+
+    // Columns are compared as a whole (memcmp-like) to know which passes need to run again
+    auto rowsChanged(next.tags != mSnapshot.tags);
+    mNamesDirty |= rowsChanged;
+    mPredicateDirty |= rowsChanged || next.states != mSnapshot.states ||
+                       next.types != mSnapshot.types || next.fileTypes != mSnapshot.fileTypes ||
+                       next.flags != mSnapshot.flags;
+    mSortDirty |= rowsChanged || next.flags != mSnapshot.flags || next.sizes != mSnapshot.sizes ||
+                  next.speeds != mSnapshot.speeds || next.priorities != mSnapshot.priorities ||
+                  next.remainingTimes != mSnapshot.remainingTimes ||
+                  next.finishedTimes != mSnapshot.finishedTimes;
+
+    mSnapshot = std::move(next);
+}
+
+void TransfersSortFilterEngine::runPredicateFilter()
+{
+    const auto rows(mSnapshot.tags.size());
+    const auto stateMask(static_cast<uint32_t>(mFilters.states));
+    const auto typeMask(static_cast<uint32_t>(mFilters.types));
+    const auto fileTypeMask(static_cast<uint32_t>(mFilters.fileTypes));
+
+    const auto* states(mSnapshot.states.data());
+    const auto* types(mSnapshot.types.data());
+    const auto* fileTypes(mSnapshot.fileTypes.data());
+    const auto* flags(mSnapshot.flags.data());
+
+    mPredicateAccepted.resize(rows);
+    auto* accepted(mPredicateAccepted.data());
+
+    // Branchless on purpose, so the compiler can vectorise it
+    for (size_t row = 0; row < rows; ++row)
+    {
+        accepted[row] = static_cast<uint8_t>(((states[row] & stateMask) != 0) &
+                                             ((types[row] & typeMask) != 0) &
+                                             ((fileTypes[row] & fileTypeMask) != 0) &
+                                             ((flags[row] & (INVALID | TEMP)) == 0));
+    }
+
+    mPredicateDirty = false;
+}
+
+void TransfersSortFilterEngine::runNameFilter()
+{
+    const auto rows(mSnapshot.foldedNames.size());
+
+    if (mFoldedFilterText.isEmpty())
+    {
+        mNameAccepted.assign(rows, 1);
+    }
+    else
+    {
+        mNameAccepted.resize(rows);
+        for (size_t row = 0; row < rows; ++row)
+        {
+            mNameAccepted[row] = mSnapshot.foldedNames[row].contains(mFoldedFilterText);
+        }
+    }
+
+    mNamesDirty = false;
+}
+
+void TransfersSortFilterEngine::runSort()
+{
+    std::vector<int> order(mSnapshot.tags.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    parallelStableSort(order,
+                       [this](int leftRow, int rightRow)
+                       {
+                           return compareRows(leftRow, rightRow);
+                       });
+
+    mRanks.resize(order.size());
+    for (size_t position = 0; position < order.size(); ++position)
+    {
+        mRanks[order[position]] = static_cast<int>(position);
+    }
+
+    mSortDirty = false;
+}
+
+// Same criteria the proxy model used to apply on the TransferData of every row
+bool TransfersSortFilterEngine::compareRows(int leftRow, int rightRow) const
+{
+    switch (mSortCriterion)
+    {
+        case SortCriterion::PRIORITY:
+        {
+            return mSnapshot.priorities[leftRow] > mSnapshot.priorities[rightRow];
+        }
+        case SortCriterion::TOTAL_SIZE:
+        {
+            return mSnapshot.sizes[leftRow] < mSnapshot.sizes[rightRow];
+        }
+        case SortCriterion::NAME:
+        {
+            return mSnapshot.foldedNames[leftRow] < mSnapshot.foldedNames[rightRow];
+        }
+        case SortCriterion::SPEED:
+        {
+            return mSnapshot.speeds[leftRow] < mSnapshot.speeds[rightRow];
+        }
+        case SortCriterion::TIME:
+        {
+            auto leftFlags(mSnapshot.flags[leftRow]);
+            auto rightFlags(mSnapshot.flags[rightRow]);
+            if ((leftFlags & PROCESSING) || (rightFlags & PROCESSING))
+            {
+                return mSnapshot.remainingTimes[leftRow] < mSnapshot.remainingTimes[rightRow];
+            }
+            else if ((leftFlags & FINISHED) && (rightFlags & FINISHED))
+            {
+                return mSnapshot.finishedTimes[leftRow] < mSnapshot.finishedTimes[rightRow];
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return false;
+}
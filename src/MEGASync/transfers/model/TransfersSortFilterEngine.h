@@ -0,0 +1,101 @@
+#ifndef TRANSFERSSORTFILTERENGINE_H
+#define TRANSFERSSORTFILTERENGINE_H
+
+#include "TransferItem.h"
+
+#include <QList>
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/// Responsability: sorts and filters the transfers of the Transfer Manager without going through
+/// QVariant/TransferItem for every comparison.
+/// process() takes an immutable struct-of-arrays snapshot of the model transfers (one column per
+/// sort/filter key, plus the case folded file name), evaluates the filter as a tight loop over the
+/// columns and sorts the rows in parallel. The result is exposed as an accepted flag and a sort
+/// rank per source row, so the proxy model applies the whole permutation with O(1) lookups.
+/// Only the dirty passes are run again: when only the filter text changes, only the name column is
+/// scanned.
+class TransfersSortFilterEngine
+{
+public:
+    struct Filters
+    {
+        TransferData::TransferStates states;
+        TransferData::TransferTypes types;
+        Utilities::FileTypes fileTypes;
+
+        bool operator==(const Filters& other) const
+        {
+            return states == other.states && types == other.types && fileTypes == other.fileTypes;
+        }
+    };
+
+    TransfersSortFilterEngine();
+
+    void process(const QList<QExplicitlySharedDataPointer<TransferData>>& transfers,
+                 const Filters& filters,
+                 const QString& filterText,
+                 SortCriterion sortCriterion);
+    void clear();
+
+    // The results are only used by the proxy model while it is active
+    void setActive(bool state);
+    bool isActive() const;
+
+    int size() const;
+    bool isAccepted(int row) const;
+    bool lessThan(int leftRow, int rightRow) const;
+    QExplicitlySharedDataPointer<TransferData> transferAt(int row) const;
+
+private:
+    enum RowFlag : uint8_t
+    {
+        INVALID = 1 << 0,
+        TEMP = 1 << 1,
+        PROCESSING = 1 << 2,
+        FINISHED = 1 << 3,
+    };
+
+    struct Snapshot
+    {
+        QList<QExplicitlySharedDataPointer<TransferData>> transfers;
+        std::vector<TransferTag> tags;
+        std::vector<uint32_t> states;
+        std::vector<uint32_t> types;
+        std::vector<uint32_t> fileTypes;
+        std::vector<uint8_t> flags;
+        std::vector<long long> sizes;
+        std::vector<long long> speeds;
+        std::vector<unsigned long long> priorities;
+        std::vector<int64_t> remainingTimes;
+        std::vector<qint64> finishedTimes;
+        std::vector<QString> foldedNames;
+
+        void reserve(int size);
+    };
+
+    void refreshSnapshot(const QList<QExplicitlySharedDataPointer<TransferData>>& transfers);
+    void runPredicateFilter();
+    void runNameFilter();
+    void runSort();
+    bool compareRows(int leftRow, int rightRow) const;
+
+    Snapshot mSnapshot;
+    std::vector<uint8_t> mPredicateAccepted;
+    std::vector<uint8_t> mNameAccepted;
+    std::vector<int> mRanks;
+
+    Filters mFilters;
+    QString mFoldedFilterText;
+    SortCriterion mSortCriterion;
+
+    bool mPredicateDirty;
+    bool mNamesDirty;
+    bool mSortDirty;
+    std::atomic<bool> mActive;
+};
+
+#endif // TRANSFERSSORTFILTERENGINE_H
@@ -0,0 +1,248 @@
+#include "TransfersStateCounters.h"
+
+#include <QMutexLocker>
+#include <QtAlgorithms>
+
+namespace
+{
+constexpr uint32_t STATE_MASK = 0xF;
+constexpr int TYPE_SHIFT = 4;
+constexpr uint32_t TYPE_MASK = 0xF;
+constexpr int FILE_TYPE_SHIFT = 8;
+constexpr uint32_t FILE_TYPE_MASK = 0x3F;
+}
+
+TransfersStateCounters::TransfersStateCounters():
+    mCacheValid(false)
+{
+}
+
+void TransfersStateCounters::addTransfer(const QExplicitlySharedDataPointer<TransferData>& transfer)
+{
+    QMutexLocker lock(&mMutex);
+    moveToKey(transfer->mTag, createKey(transfer));
+}
+
+void TransfersStateCounters::updateTransfer(const QExplicitlySharedDataPointer<TransferData>& transfer)
+{
+    QMutexLocker lock(&mMutex);
+
+    auto key(createKey(transfer));
+    auto currentKey(mKeyByTag.constFind(transfer->mTag));
+    //The transfer may change its state without moving to another counter (e.g. ACTIVE -> RETRYING)
+    if(currentKey == mKeyByTag.constEnd() || currentKey.value() != key)
+    {
+        moveToKey(transfer->mTag, key);
+    }
+}
+
+void TransfersStateCounters::removeTransfer(TransferTag tag)
+{
+    QMutexLocker lock(&mMutex);
+
+    auto currentKey(mKeyByTag.find(tag));
+    if(currentKey != mKeyByTag.end())
+    {
+        decreaseKey(currentKey.value());
+        mKeyByTag.erase(currentKey);
+        mCacheValid = false;
+    }
+}
+
+void TransfersStateCounters::clear()
+{
+    QMutexLocker lock(&mMutex);
+
+    mKeyByTag.clear();
+    mCountByKey.clear();
+    mCacheValid = false;
+}
+
+void TransfersStateCounters::setFilterText(const QString& filterText,
+                                           const QList<QExplicitlySharedDataPointer<TransferData>>& transfers)
+{
+    QMutexLocker lock(&mMutex);
+
+    if(filterText == mFilterText)
+    {
+        return;
+    }
+
+    mFilterText = filterText;
+
+    for(const auto& transfer : transfers)
+    {
+        auto currentKey(mKeyByTag.constFind(transfer->mTag));
+        if(currentKey != mKeyByTag.constEnd())
+        {
+            auto key(currentKey.value() & ~NAME_MATCHES);
+            if(nameMatches(transfer))
+            {
+                key |= NAME_MATCHES;
+            }
+
+            if(key != currentKey.value())
+            {
+                moveToKey(transfer->mTag, key);
+            }
+        }
+    }
+}
+
+TransfersStateCounters::Counters TransfersStateCounters::counters(const TransfersSortFilterEngine::Filters& filters) const
+{
+    QMutexLocker lock(&mMutex);
+
+    if(mCacheValid && mCachedFilters == filters)
+    {
+        return mCachedCounters;
+    }
+
+    Counters result;
+
+    for(auto it = mCountByKey.constBegin(); it != mCountByKey.constEnd(); ++it)
+    {
+        auto key(it.key());
+        auto count(it.value());
+
+        if(key & TEMP)
+        {
+            continue;
+        }
+
+        TransferData::TransferStates state(1 << (key & STATE_MASK));
+        TransferData::TransferTypes type((key >> TYPE_SHIFT) & TYPE_MASK);
+        auto fileType((key >> FILE_TYPE_SHIFT) & FILE_TYPE_MASK);
+        auto containsText(key & NAME_MATCHES);
+
+        if(!mFilterText.isEmpty() && containsText)
+        {
+            if(type & TransferData::TRANSFER_UPLOAD)
+            {
+                result.uploadsFound += count;
+            }
+            else if(type & TransferData::TRANSFER_DOWNLOAD)
+            {
+                result.downloadsFound += count;
+            }
+        }
+
+        auto accept((state & filters.states)
+                    && (type & filters.types)
+                    && (fileType & filters.fileTypes)
+                    && containsText);
+        if(!accept)
+        {
+            continue;
+        }
+
+        auto isCompleted(state & TransferData::TRANSFER_COMPLETED);
+        auto isCompleting(state & TransferData::TRANSFER_COMPLETING);
+        auto isActiveOrPending(state & TransferData::PENDING_STATES_MASK);
+        auto isFailed(key & FAILED);
+
+        if(!isCompleted && !isCompleting)
+        {
+            if(isActiveOrPending)
+            {
+                result.active += count;
+            }
+
+            if(!(type & TransferData::TRANSFER_SYNC))
+            {
+                result.noSync += count;
+            }
+        }
+
+        if(isActiveOrPending && isCompleting)
+        {
+            result.completing += count;
+        }
+
+        if(state & TransferData::TRANSFER_PAUSED)
+        {
+            result.paused += count;
+        }
+
+        if(isCompleted && !isFailed)
+        {
+            result.completed += count;
+        }
+
+        if(isFailed)
+        {
+            result.failed += count;
+            if(key & PERMANENT_FAILED)
+            {
+                result.permanentFailed += count;
+            }
+        }
+    }
+
+    mCachedFilters = filters;
+    mCachedCounters = result;
+    mCacheValid = true;
+
+    return result;
+}
+
+uint32_t TransfersStateCounters::createKey(const QExplicitlySharedDataPointer<TransferData>& transfer) const
+{
+    uint32_t key(qCountTrailingZeroBits(static_cast<uint32_t>(transfer->getState())) & STATE_MASK);
+    key |= (static_cast<uint32_t>(transfer->mType) & TYPE_MASK) << TYPE_SHIFT;
+    key |= (static_cast<uint32_t>(toInt(transfer->mFileType)) & FILE_TYPE_MASK) << FILE_TYPE_SHIFT;
+
+    if(transfer->isFailed())
+    {
+        key |= FAILED;
+        //canBeRetried asks the SDK, so it is only evaluated on state changes
+        if(!transfer->canBeRetried())
+        {
+            key |= PERMANENT_FAILED;
+        }
+    }
+
+    if(nameMatches(transfer))
+    {
+        key |= NAME_MATCHES;
+    }
+
+    if(transfer->isTempTransfer())
+    {
+        key |= TEMP;
+    }
+
+    return key;
+}
+
+bool TransfersStateCounters::nameMatches(const QExplicitlySharedDataPointer<TransferData>& transfer) const
+{
+    return mFilterText.isEmpty() || transfer->mFilename.contains(mFilterText, Qt::CaseInsensitive);
+}
+
+void TransfersStateCounters::moveToKey(TransferTag tag, uint32_t key)
+{
+    auto currentKey(mKeyByTag.find(tag));
+    if(currentKey != mKeyByTag.end())
+    {
+        decreaseKey(currentKey.value());
+        currentKey.value() = key;
+    }
+    else
+    {
+        mKeyByTag.insert(tag, key);
+    }
+
+    ++mCountByKey[key];
+    mCacheValid = false;
+}
+
+void TransfersStateCounters::decreaseKey(uint32_t key)
+{
+    auto count(mCountByKey.find(key));
+    if(count != mCountByKey.end() && --count.value() <= 0)
+    {
+        //Keep only the keys in use, so the counters loop stays short
+        mCountByKey.erase(count);
+    }
+}
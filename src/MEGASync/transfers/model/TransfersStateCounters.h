@@ -0,0 +1,76 @@
+#ifndef TRANSFERSSTATECOUNTERS_H
+#define TRANSFERSSTATECOUNTERS_H
+
+#include "TransferItem.h"
+#include "TransfersSortFilterEngine.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <cstdint>
+
+/// Responsability: keeps the Transfer Manager counters (active, paused, completed, failed...)
+/// up to date as the transfers change, instead of recomputing them row by row when the proxy
+/// model filters.
+/// Every transfer is classified by a small key (state, type, file type, failed flags and whether
+/// its name matches the search text), and only the number of transfers per key is stored. A
+/// transfer event moves one unit from its old key to the new one, in O(1). The counters for a
+/// given filter are computed by walking the distinct keys (a few dozens at most, whatever the
+/// number of transfers) and cached until the next change.
+class TransfersStateCounters
+{
+public:
+    struct Counters
+    {
+        int active = 0;
+        int completing = 0;
+        int paused = 0;
+        int completed = 0;
+        int failed = 0;
+        int permanentFailed = 0;
+        int noSync = 0;
+        // Transfers matching the search text, whatever the state filter
+        int uploadsFound = 0;
+        int downloadsFound = 0;
+    };
+
+    TransfersStateCounters();
+
+    void addTransfer(const QExplicitlySharedDataPointer<TransferData>& transfer);
+    // Call it when the transfer has changed (stateHasChanged()), before resetting its state
+    void updateTransfer(const QExplicitlySharedDataPointer<TransferData>& transfer);
+    void removeTransfer(TransferTag tag);
+    void clear();
+
+    // Only the name bit of every transfer is recomputed
+    void setFilterText(const QString& filterText,
+                       const QList<QExplicitlySharedDataPointer<TransferData>>& transfers);
+
+    Counters counters(const TransfersSortFilterEngine::Filters& filters) const;
+
+private:
+    enum KeyFlag : uint32_t
+    {
+        FAILED = 1 << 14,
+        PERMANENT_FAILED = 1 << 15,
+        NAME_MATCHES = 1 << 16,
+        TEMP = 1 << 17,
+    };
+
+    uint32_t createKey(const QExplicitlySharedDataPointer<TransferData>& transfer) const;
+    bool nameMatches(const QExplicitlySharedDataPointer<TransferData>& transfer) const;
+    void moveToKey(TransferTag tag, uint32_t key);
+    void decreaseKey(uint32_t key);
+
+    mutable QMutex mMutex;
+    QHash<TransferTag, uint32_t> mKeyByTag;
+    QHash<uint32_t, int> mCountByKey;
+    QString mFilterText;
+
+    mutable bool mCacheValid;
+    mutable TransfersSortFilterEngine::Filters mCachedFilters;
+    mutable Counters mCachedCounters;
+};
+
+#endif // TRANSFERSSTATECOUNTERS_H
@@ -9,9 +9,13 @@ set(DESKTOP_APP_TRANSFERS_HEADERS
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferWidgetColumnsManager.h
     ${CMAKE_CURRENT_LIST_DIR}/model/TransfersManagerSortFilterProxyModel.h
     ${CMAKE_CURRENT_LIST_DIR}/model/TransfersSortFilterProxyBaseModel.h
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransfersSortFilterEngine.h
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransfersStateCounters.h
     ${CMAKE_CURRENT_LIST_DIR}/model/TransfersModel.h
     ${CMAKE_CURRENT_LIST_DIR}/model/TransferMetaData.h
     ${CMAKE_CURRENT_LIST_DIR}/model/TransferTrack.h
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransferTagIndex.h
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransferStringPool.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/InfoDialogTransferDelegateWidget.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/InfoDialogTransfersWidget.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/MegaTransferDelegate.h
@@ -21,6 +25,8 @@ set(DESKTOP_APP_TRANSFERS_HEADERS
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferItem.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManager.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerDelegateWidget.h
+    ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerRowPainter.h
+    ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerRowState.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerLoadingItem.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferScanCancelUi.h
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferWidgetHeaderItem.h
@@ -39,8 +45,12 @@ set(DESKTOP_APP_TRANSFERS_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferWidgetColumnsManager.cpp
     ${CMAKE_CURRENT_LIST_DIR}/model/InfoDialogTransfersProxyModel.cpp
     ${CMAKE_CURRENT_LIST_DIR}/model/TransfersManagerSortFilterProxyModel.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransfersSortFilterEngine.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransfersStateCounters.cpp
     ${CMAKE_CURRENT_LIST_DIR}/model/TransferMetaData.cpp
     ${CMAKE_CURRENT_LIST_DIR}/model/TransferTrack.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransferTagIndex.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/model/TransferStringPool.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/InfoDialogTransferDelegateWidget.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/InfoDialogTransfersWidget.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/MegaTransferDelegate.cpp
@@ -50,6 +60,8 @@ set(DESKTOP_APP_TRANSFERS_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferItem.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManager.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerDelegateWidget.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerRowPainter.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerRowState.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferManagerLoadingItem.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferScanCancelUi.cpp
     ${CMAKE_CURRENT_LIST_DIR}/gui/TransferWidgetHeaderItem.cpp